@@ -1,31 +0,0 @@
-#pragma once
-
-#include <stdio.h>
-#include <stdlib.h>
-
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-
-class Window
-{
-    public:
-        Window();
-        Window(GLint windowWidth, GLint windowHeight);
-
-        int Initialise();
-
-        GLfloat getBufferWidth() { return bufferWidth; }
-        GLfloat getBufferHeight() { return bufferHeight; }
-
-        bool getShouldClose() { return glfwWindowShouldClose(mainWindow); }
-
-        void swapBuffers() { glfwSwapBuffers(mainWindow); }
-
-        ~Window();
-
-    private:
-        GLFWwindow *mainWindow;
-
-        GLint width, height;
-        GLint bufferWidth, bufferHeight;
-};
\ No newline at end of file
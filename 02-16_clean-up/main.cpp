@@ -17,7 +17,7 @@
 
 const float toRadians = 3.14159265f / 180.0f;
 
-Window mainWindow;
+Window mainWindow(800, 600);
 std::vector<Mesh*> meshList;
 std::vector<Shader> shaderList;
 
@@ -57,7 +57,6 @@ void CreateShaders()
 
 int main()
 {
-    mainWindow = Window(800, 600);
     mainWindow.Initialise();
 
     CreateObjects();
@@ -71,7 +70,7 @@ int main()
     while (!mainWindow.getShouldClose())
     {
         // get and handle user input events
-        glfwPollEvents();
+        mainWindow.pollEvents();
 
         // clear window
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
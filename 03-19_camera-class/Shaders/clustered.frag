@@ -0,0 +1,77 @@
+#version 330
+
+in vec4 vCol;
+in vec2 vTex;
+in vec3 vWorldPos;
+
+out vec4 color;
+
+uniform sampler2D diffuse; // white until a texture is loaded
+
+// written by ClusteredLighting::bind
+uniform samplerBuffer lightData; // two texels per light: position & radius, colour * intensity
+uniform usamplerBuffer clusterGrid; // offset into lightIndices & light count per cluster
+uniform usamplerBuffer lightIndices;
+
+uniform uvec3 clusterCount;
+uniform mat4 clusterView; // the view the clusters were built for
+uniform vec2 clusterScale; // projection[0][0] & projection[1][1]
+uniform vec2 clusterSlices; // slice = log(depth) * x + y
+
+const vec3 ambient = vec3(0.1f);
+const vec2 material = vec2(0.5f, 0.25f); // specular intensity & shininess in 0-1, as gbuffer.frag stores them
+
+void main()
+{
+    vec4 albedo = vCol * texture(diffuse, vTex);
+
+    // the pyramid has no normals, the face normal comes from the screen space derivatives
+    vec3 normal = normalize(cross(dFdx(vWorldPos), dFdy(vWorldPos)));
+
+    // the lookup goes through world space so split screen views still find a cluster
+    vec3 viewPos = (clusterView * vec4(vWorldPos, 1.0f)).xyz;
+    float depth = -viewPos.z;
+    vec2 ndc = viewPos.xy * clusterScale / depth;
+    ivec3 cluster = ivec3(floor((ndc * 0.5f + 0.5f) * vec2(clusterCount.xy)), floor(log(depth) * clusterSlices.x + clusterSlices.y));
+
+    // highlights follow the player camera in every view, as in deferred.frag
+    vec3 eye = -(transpose(mat3(clusterView)) * clusterView[3].xyz);
+    vec3 toEye = normalize(eye - vWorldPos);
+
+    // quantised like the G-buffer, so both paths shade alike
+    float specularIntensity = floor(material.x * 15.0f + 0.5f) / 15.0f;
+    float shininess = 1.0f + 255.0f * floor(material.y * 15.0f + 0.5f) / 15.0f;
+
+    vec3 lighting = ambient;
+    vec3 specularLight = vec3(0.0f);
+
+    // fragments outside the clustered frustum only get the ambient term
+    if (depth > 0.0f && all(greaterThanEqual(cluster, ivec3(0))) && all(lessThan(cluster, ivec3(clusterCount))))
+    {
+        int index = (cluster.z * int(clusterCount.y) + cluster.y) * int(clusterCount.x) + cluster.x;
+        uvec2 range = texelFetch(clusterGrid, index).xy;
+
+        for (uint i = 0u; i < range.y; i++)
+        {
+            int light = int(texelFetch(lightIndices, int(range.x + i)).x);
+            vec4 positionRadius = texelFetch(lightData, light * 2);
+            vec3 radiance = texelFetch(lightData, light * 2 + 1).rgb;
+
+            vec3 toLight = positionRadius.xyz - vWorldPos;
+            float distance = length(toLight);
+            vec3 direction = toLight / max(distance, 0.0001f);
+
+            // smooth falloff that reaches zero at the radius
+            float falloff = clamp(1.0f - (distance * distance) / (positionRadius.w * positionRadius.w), 0.0f, 1.0f);
+            falloff *= falloff;
+
+            float lambert = max(dot(normal, direction), 0.0f);
+            vec3 halfway = normalize(direction + toEye);
+
+            lighting += radiance * falloff * lambert;
+            specularLight += radiance * falloff * specularIntensity * pow(max(dot(normal, halfway), 0.0f), shininess) * float(lambert > 0.0f);
+        }
+    }
+
+    color = vec4(albedo.rgb * lighting + specularLight, albedo.a);
+}
\ No newline at end of file
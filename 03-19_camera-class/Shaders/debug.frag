@@ -0,0 +1,10 @@
+#version 330
+
+in vec4 vCol;
+
+out vec4 color;
+
+void main()
+{
+    color = vCol;
+}
\ No newline at end of file
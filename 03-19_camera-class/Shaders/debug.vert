@@ -0,0 +1,15 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+layout (location = 1) in vec4 col; // RGBA8, normalised by the attribute
+
+out vec4 vCol;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+void main()
+{
+    gl_Position = projection * view * vec4(pos, 1.0f);
+    vCol = col;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#version 330
+
+in vec2 vScreen;
+
+out vec4 color;
+
+// written by DeferredRenderer
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection; // of the view being lit
+
+// written by ClusteredLighting::bind
+uniform samplerBuffer lightData; // two texels per light: position & radius, colour * intensity
+uniform usamplerBuffer clusterGrid; // offset into lightIndices & light count per cluster
+uniform usamplerBuffer lightIndices;
+
+uniform uvec3 clusterCount;
+uniform mat4 clusterView; // the view the clusters were built for
+uniform vec2 clusterScale; // projection[0][0] & projection[1][1]
+uniform vec2 clusterSlices; // slice = log(depth) * x + y
+
+const vec3 ambient = vec3(0.1f);
+
+vec3 decodeNormal(vec2 encoded)
+{
+    encoded = encoded * 2.0f - 1.0f;
+
+    vec3 n = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-n.z, 0.0f);
+    n.xy += vec2(n.x >= 0.0f ? -fold : fold, n.y >= 0.0f ? -fold : fold);
+
+    return normalize(n);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gDepth, pixel, 0).r;
+
+    // nothing was drawn here
+    if (depth == 1.0f)
+    {
+        color = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        return;
+    }
+
+    vec4 albedoMaterial = texelFetch(gAlbedo, pixel, 0);
+    vec3 normal = decodeNormal(texelFetch(gNormal, pixel, 0).xy);
+
+    float packedMaterial = floor(albedoMaterial.a * 255.0f + 0.5f);
+    float specularIntensity = floor(packedMaterial / 16.0f) / 15.0f;
+    float shininess = 1.0f + 255.0f * mod(packedMaterial, 16.0f) / 15.0f;
+
+    vec4 world = inverseViewProjection * vec4(vec3(vScreen, depth) * 2.0f - 1.0f, 1.0f);
+    vec3 worldPos = world.xyz / world.w;
+
+    // highlights follow the player camera in every view, as in clustered.frag
+    vec3 eye = -(transpose(mat3(clusterView)) * clusterView[3].xyz);
+    vec3 toEye = normalize(eye - worldPos);
+
+    // the same cluster lookup as clustered.frag, from the rebuilt world position
+    vec3 viewPos = (clusterView * vec4(worldPos, 1.0f)).xyz;
+    float viewDepth = -viewPos.z;
+    vec2 ndc = viewPos.xy * clusterScale / viewDepth;
+    ivec3 cluster = ivec3(floor((ndc * 0.5f + 0.5f) * vec2(clusterCount.xy)), floor(log(viewDepth) * clusterSlices.x + clusterSlices.y));
+
+    vec3 diffuseLight = ambient;
+    vec3 specularLight = vec3(0.0f);
+
+    if (viewDepth > 0.0f && all(greaterThanEqual(cluster, ivec3(0))) && all(lessThan(cluster, ivec3(clusterCount))))
+    {
+        int index = (cluster.z * int(clusterCount.y) + cluster.y) * int(clusterCount.x) + cluster.x;
+        uvec2 range = texelFetch(clusterGrid, index).xy;
+
+        for (uint i = 0u; i < range.y; i++)
+        {
+            int light = int(texelFetch(lightIndices, int(range.x + i)).x);
+            vec4 positionRadius = texelFetch(lightData, light * 2);
+            vec3 radiance = texelFetch(lightData, light * 2 + 1).rgb;
+
+            vec3 toLight = positionRadius.xyz - worldPos;
+            float distance = length(toLight);
+            vec3 direction = toLight / max(distance, 0.0001f);
+
+            float falloff = clamp(1.0f - (distance * distance) / (positionRadius.w * positionRadius.w), 0.0f, 1.0f);
+            falloff *= falloff;
+
+            float lambert = max(dot(normal, direction), 0.0f);
+            vec3 halfway = normalize(direction + toEye);
+
+            diffuseLight += radiance * falloff * lambert;
+            specularLight += radiance * falloff * specularIntensity * pow(max(dot(normal, halfway), 0.0f), shininess) * float(lambert > 0.0f);
+        }
+    }
+
+    color = vec4(albedoMaterial.rgb * diffuseLight + specularLight, 1.0f);
+}
\ No newline at end of file
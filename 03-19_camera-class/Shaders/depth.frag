@@ -0,0 +1,7 @@
+#version 330
+
+// depth pre-pass: colour writes are masked off, the fixed function depth write is all that's left
+
+void main()
+{
+}
\ No newline at end of file
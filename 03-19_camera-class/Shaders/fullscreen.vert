@@ -0,0 +1,10 @@
+#version 330
+
+out vec2 vScreen; // 0 to 1 across the viewport
+
+void main()
+{
+    // one triangle covering the viewport, no vertex buffer needed
+    vScreen = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(vScreen * 2.0f - 1.0f, 0.0f, 1.0f);
+}
\ No newline at end of file
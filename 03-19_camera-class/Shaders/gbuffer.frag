@@ -0,0 +1,34 @@
+#version 330
+
+in vec4 vCol;
+in vec2 vTex;
+in vec3 vWorldPos;
+
+layout (location = 0) out vec4 gAlbedo; // albedo, specular intensity & shininess packed 4:4 in alpha
+layout (location = 1) out vec2 gNormal; // octahedral
+
+uniform sampler2D diffuse; // white until a texture is loaded
+
+const vec2 material = vec2(0.5f, 0.25f); // specular intensity & shininess in 0-1, until meshes carry materials
+
+// the unit sphere folded onto a square, two channels are enough for a normal
+vec2 encodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+
+    vec2 signs = vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    vec2 folded = n.z >= 0.0f ? n.xy : (1.0f - abs(n.yx)) * signs;
+
+    return folded * 0.5f + 0.5f;
+}
+
+void main()
+{
+    // the pyramid has no normals, the face normal comes from the screen space derivatives
+    vec3 normal = normalize(cross(dFdx(vWorldPos), dFdy(vWorldPos)));
+
+    vec2 quantised = floor(material * 15.0f + 0.5f);
+
+    gAlbedo = vec4((vCol * texture(diffuse, vTex)).rgb, (quantised.x * 16.0f + quantised.y) / 255.0f);
+    gNormal = encodeNormal(normal);
+}
\ No newline at end of file
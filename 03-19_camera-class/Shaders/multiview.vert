@@ -0,0 +1,38 @@
+#version 330
+
+#extension GL_ARB_shader_viewport_layer_array : require
+
+layout (location = 0) in vec3 pos;
+
+out vec4 vCol;
+out vec2 vTex;
+out vec3 vWorldPos; // for clustered.frag
+
+uniform mat4 model;
+uniform mat4 viewProjections[8];
+uniform uint viewMask;
+
+void main()
+{
+    // the n-th instance draws into the view of the n-th bit set in viewMask
+    uint mask = viewMask;
+
+    for (int i = 0; i < gl_InstanceID; i++)
+        mask &= mask - 1u;
+
+    int view = 0;
+
+    while ((mask & 1u) == 0u)
+    {
+        mask >>= 1;
+        view++;
+    }
+
+    gl_ViewportIndex = view;
+    vec4 worldPos = model * vec4(pos, 1.0f);
+
+    gl_Position = viewProjections[view] * worldPos;
+    vWorldPos = worldPos.xyz;
+    vCol = vec4(clamp(pos, 0.0f, 1.0f), 1.0f);
+    vTex = pos.xy * 0.5f + 0.5f; // planar mapping, the pyramid has no texture coordinates
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 330
+
+in float vLife;
+
+out vec4 color;
+
+void main()
+{
+    // round & soft edged
+    vec2 offset = gl_PointCoord * 2.0f - 1.0f;
+    float falloff = max(1.0f - dot(offset, offset), 0.0f);
+
+    // white hot when emitted, through orange to a dim red, fading out over the last quarter of the lifetime
+    vec3 hot = vec3(1.0f, 0.9f, 0.6f);
+    vec3 warm = vec3(1.0f, 0.45f, 0.1f);
+    vec3 cool = vec3(0.5f, 0.08f, 0.05f);
+
+    vec3 tint = vLife > 0.5f ? mix(warm, hot, vLife * 2.0f - 1.0f) : mix(cool, warm, vLife * 2.0f);
+
+    color = vec4(tint, falloff * min(vLife * 4.0f, 1.0f));
+}
\ No newline at end of file
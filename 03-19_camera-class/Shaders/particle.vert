@@ -0,0 +1,24 @@
+#version 330
+
+layout (location = 0) in vec4 particle; // position & remaining life, 1 at the longest lifetime
+
+out float vLife;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+// written by ParticleSystem::render
+uniform float pointScale; // half the viewport height in pixels times projection[1][1]
+uniform float particleSize; // world units across
+
+void main()
+{
+    vec4 viewPos = view * vec4(particle.xyz, 1.0f);
+
+    gl_Position = projection * viewPos;
+
+    // the sprite covers what a particleSize wide ball would, at least a pixel so far particles never vanish
+    gl_PointSize = max(particleSize * pointScale / max(-viewPos.z, 0.001f), 1.0f);
+
+    vLife = particle.w;
+}
\ No newline at end of file
@@ -1,10 +1,13 @@
 #version 330
 
 in vec4 vCol;
+in vec2 vTex;
 
 out vec4 color;
 
+uniform sampler2D diffuse; // white until a texture is loaded
+
 void main()
 {
-    color = vCol;
+    color = vCol * texture(diffuse, vTex);
 }
\ No newline at end of file
@@ -3,13 +3,22 @@
 layout (location = 0) in vec3 pos;
 
 out vec4 vCol;
+out vec2 vTex;
+out vec3 vWorldPos; // for clustered.frag
 
 uniform mat4 model;
 uniform mat4 projection;
 uniform mat4 view;
 
+// the depth pre-pass & the G-buffer pass compile this twice, their depths have to match exactly
+invariant gl_Position;
+
 void main()
 {
-    gl_Position = projection * view * model * vec4(pos, 1.0f);
+    vec4 worldPos = model * vec4(pos, 1.0f);
+
+    gl_Position = projection * view * worldPos;
+    vWorldPos = worldPos.xyz;
     vCol = vec4(clamp(pos, 0.0f, 1.0f), 1.0f);
+    vTex = pos.xy * 0.5f + 0.5f; // planar mapping, the pyramid has no texture coordinates
 }
\ No newline at end of file
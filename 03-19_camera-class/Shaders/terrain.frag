@@ -0,0 +1,27 @@
+#version 330
+
+in vec3 vWorldPos;
+in vec3 vNormal;
+in float vHeight;
+
+out vec4 color;
+
+const vec3 sunDirection = vec3(0.48f, 0.8f, 0.36f);
+const vec3 ambient = vec3(0.25f, 0.28f, 0.32f);
+
+void main()
+{
+    vec3 normal = normalize(vNormal);
+
+    // grass on the flats, rock on the slopes, snow up high
+    vec3 grass = vec3(0.28f, 0.42f, 0.18f);
+    vec3 rock = vec3(0.42f, 0.39f, 0.36f);
+    vec3 snow = vec3(0.92f, 0.93f, 0.95f);
+
+    vec3 albedo = mix(rock, grass, smoothstep(0.7f, 0.85f, normal.y));
+    albedo = mix(albedo, snow, smoothstep(0.65f, 0.75f, vHeight) * smoothstep(0.5f, 0.7f, normal.y));
+
+    vec3 lighting = ambient + vec3(max(dot(normal, sunDirection), 0.0f));
+
+    color = vec4(albedo * lighting, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#version 330
+
+layout (location = 0) in vec3 pos; // a unit grid of patchQuads x patchQuads quads on XZ
+
+out vec3 vWorldPos;
+out vec3 vNormal;
+out float vHeight; // 0 at the lowest a sample can be, 1 at the highest
+
+uniform mat4 projection;
+uniform mat4 view;
+
+// written by Terrain::render, one node per instance: corner x & z, size & LOD level
+uniform vec4 nodes[128];
+uniform float patchQuads;
+uniform vec3 cameraPosition;
+
+// written by Terrain::Initialise
+uniform sampler2D heightmap;
+uniform vec4 terrainMap; // x & z of the first sample, 1 / extent, half a texel
+uniform vec2 heightRange; // scale & base
+uniform vec2 morphRanges[12]; // start & end of each level's blend into the grid above
+
+float sampleHeight(vec2 world)
+{
+    vec2 uv = (world - terrainMap.xy) * terrainMap.z + terrainMap.w;
+
+    return textureLod(heightmap, uv, 0.0f).r * heightRange.x + heightRange.y;
+}
+
+void main()
+{
+    vec4 node = nodes[gl_InstanceID];
+    float gridSpacing = node.z / patchQuads;
+
+    // how far this vertex has blended into the grid of the level above, by its distance from the camera
+    vec2 world = node.xy + pos.xz * node.z;
+    float cameraDistance = length(cameraPosition - vec3(world.x, sampleHeight(world), world.y));
+
+    vec2 range = morphRanges[int(node.w)];
+    float morph = clamp((cameraDistance - range.x) / (range.y - range.x), 0.0f, 1.0f);
+
+    // odd vertices slide onto their even neighbour, fully blended the patch is the next level's grid
+    vec2 grid = pos.xz * patchQuads;
+    grid -= fract(grid * 0.5f) * 2.0f * morph;
+
+    world = node.xy + grid * gridSpacing;
+    float height = sampleHeight(world);
+
+    // central differences a grid step apart, smoother as the grid gets coarser
+    float left = sampleHeight(world - vec2(gridSpacing, 0.0f));
+    float right = sampleHeight(world + vec2(gridSpacing, 0.0f));
+    float back = sampleHeight(world - vec2(0.0f, gridSpacing));
+    float front = sampleHeight(world + vec2(0.0f, gridSpacing));
+
+    vWorldPos = vec3(world.x, height, world.y);
+    vNormal = normalize(vec3(left - right, 2.0f * gridSpacing, back - front));
+    vHeight = (height - heightRange.y) / heightRange.x;
+
+    gl_Position = projection * view * vec4(vWorldPos, 1.0f);
+}
\ No newline at end of file
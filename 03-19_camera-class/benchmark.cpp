@@ -0,0 +1,2115 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "headers/Window.h"
+#include "headers/Mesh.h"
+#include "headers/Shader.h"
+#include "headers/Camera.h"
+#include "headers/InputQueue.h"
+#include "headers/MultiViewRenderer.h"
+#include "headers/TransformHierarchy.h"
+#include "headers/TransformKernels.h"
+#include "headers/JobSystem.h"
+#include "headers/EntityStore.h"
+#include "headers/CommandBuffer.h"
+#include "headers/FrameArena.h"
+#include "headers/ClusteredLighting.h"
+#include "headers/DeferredRenderer.h"
+#include "headers/ModelLoader.h"
+#include "headers/Terrain.h"
+#include "headers/ParticleSystem.h"
+#include "headers/DebugDraw.h"
+
+// microbenchmarks of the hot paths: every case is warmed up, timed as a series of samples
+// long enough to swamp the clock, cleaned of outliers & reported with a 95% confidence interval
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkResult
+{
+    const char *name;
+    long iterations; // operations per sample
+    size_t samples, outliers;
+
+    // nanoseconds per operation
+    double mean, median, deviation;
+    double low, high; // 95% confidence interval of the mean
+    double minimum, maximum;
+};
+
+struct BenchmarkOptions
+{
+    const char *filter;
+    size_t sampleCount;
+    double minimumSampleTime; // seconds
+    double warmupTime; // seconds
+};
+
+static const char* vShader = "Shaders/shader.vert";
+static const char* fShader = "Shaders/shader.frag";
+static const char* fClusteredShader = "Shaders/clustered.frag";
+static const char* fDepthShader = "Shaders/depth.frag";
+static const char* fGeometryShader = "Shaders/gbuffer.frag";
+static const char* vFullscreenShader = "Shaders/fullscreen.vert";
+static const char* fDeferredShader = "Shaders/deferred.frag";
+static const char* vTerrainShader = "Shaders/terrain.vert";
+static const char* fTerrainShader = "Shaders/terrain.frag";
+static const char* vParticleShader = "Shaders/particle.vert";
+static const char* fParticleShader = "Shaders/particle.frag";
+static const char* vDebugShader = "Shaders/debug.vert";
+static const char* fDebugShader = "Shaders/debug.frag";
+
+static BenchmarkOptions options = { NULL, 30, 0.002, 0.1 };
+static std::vector<BenchmarkResult> results;
+
+static double elapsed(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double timeBody(const std::function<void(long)> &body, long iterations)
+{
+    Clock::time_point start = Clock::now();
+    body(iterations);
+
+    return elapsed(start);
+}
+
+// two-sided 95% critical values of Student's t for 1 to 30 degrees of freedom
+static double studentT(size_t degrees)
+{
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    if (degrees == 0)
+        return INFINITY;
+
+    return degrees <= 30 ? table[degrees - 1] : 1.960;
+}
+
+static double quantile(const std::vector<double> &sorted, double q)
+{
+    double position = q * (sorted.size() - 1);
+    size_t below = (size_t)position;
+    size_t above = below + 1 < sorted.size() ? below + 1 : below;
+
+    return sorted[below] + (sorted[above] - sorted[below]) * (position - below);
+}
+
+// the one filter test every case & group goes through
+static bool caseSelected(const char *name)
+{
+    return !options.filter || strstr(name, options.filter);
+}
+
+// cases sharing one setup, GL objects included: the setup only runs when the filter picks one of them
+template <size_t N>
+static void runGroup(const char* const (&names)[N], const std::function<void()> &group)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        if (caseSelected(names[i]))
+        {
+            group();
+            return;
+        }
+    }
+}
+
+// true when name was the last case to run, so its extra figures can be printed
+static bool lastRan(const char *name)
+{
+    return !results.empty() && strcmp(results.back().name, name) == 0;
+}
+
+// body runs the operation the given number of times, GL cases finish the GPU work inside it
+static void runBenchmark(const char *name, const std::function<void(long)> &body)
+{
+    if (!caseSelected(name))
+        return;
+
+    // double the batch until one sample is comfortably above the clock's resolution
+    long iterations = 1;
+
+    while (timeBody(body, iterations) < options.minimumSampleTime && iterations < (1L << 30))
+        iterations *= 2;
+
+    // let caches, branch predictors, clocks & the driver settle
+    Clock::time_point warmupStart = Clock::now();
+
+    while (elapsed(warmupStart) < options.warmupTime)
+        body(iterations);
+
+    std::vector<double> samples;
+
+    for (size_t s = 0; s < options.sampleCount; s++)
+        samples.push_back(timeBody(body, iterations) * 1e9 / iterations);
+
+    std::sort(samples.begin(), samples.end());
+
+    // Tukey's fences drop samples hit by preemption, page faults & the like
+    double q1 = quantile(samples, 0.25);
+    double q3 = quantile(samples, 0.75);
+    double fence = 1.5 * (q3 - q1);
+
+    std::vector<double> kept;
+
+    for (size_t s = 0; s < samples.size(); s++)
+    {
+        if (samples[s] >= q1 - fence && samples[s] <= q3 + fence)
+            kept.push_back(samples[s]);
+    }
+
+    double total = 0.0;
+
+    for (size_t s = 0; s < kept.size(); s++)
+        total += kept[s];
+
+    double mean = total / kept.size();
+    double squares = 0.0;
+
+    for (size_t s = 0; s < kept.size(); s++)
+        squares += (kept[s] - mean) * (kept[s] - mean);
+
+    double deviation = kept.size() > 1 ? sqrt(squares / (kept.size() - 1)) : 0.0;
+    double margin = studentT(kept.size() - 1) * deviation / sqrt((double)kept.size());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.samples = kept.size();
+    result.outliers = samples.size() - kept.size();
+    result.mean = mean;
+    result.median = quantile(kept, 0.5);
+    result.deviation = deviation;
+    result.low = mean - margin;
+    result.high = mean + margin;
+    result.minimum = kept.front();
+    result.maximum = kept.back();
+
+    results.push_back(result);
+
+    printf("%-34s %12.1f ns/op  +/- %-9.1f median %12.1f  min %12.1f  (%zu samples x %ld, %zu outliers) \n",
+        name, mean, margin, result.median, result.minimum, result.samples, iterations, result.outliers);
+}
+
+static bool writeJson(const char *fileLocation, const char *backendName)
+{
+    FILE *file = fopen(fileLocation, "w");
+
+    if (!file)
+    {
+        printf("Failed to open %s for the results! \n", fileLocation);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"timestamp\": %lld,\n  \"backend\": \"%s\",\n  \"transformKernel\": \"%s\",\n  \"benchmarks\": [\n",
+        (long long)time(NULL), backendName, GetTransformKernelName());
+
+    for (size_t r = 0; r < results.size(); r++)
+    {
+        const BenchmarkResult &result = results[r];
+
+        fprintf(file, "    {\"name\": \"%s\", \"unit\": \"ns/op\", \"mean\": %.3f, \"median\": %.3f, \"stddev\": %.3f, "
+            "\"ci95Low\": %.3f, \"ci95High\": %.3f, \"min\": %.3f, \"max\": %.3f, \"samples\": %zu, \"outliers\": %zu, \"iterations\": %ld}%s\n",
+            result.name, result.mean, result.median, result.deviation, result.low, result.high,
+            result.minimum, result.maximum, result.samples, result.outliers, result.iterations,
+            r + 1 < results.size() ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+
+    return true;
+}
+
+// the pyramid from main.cpp
+static GLfloat pyramidVertices[] = {
+    -1.0f * .67f, -1.0f * .33f,  0.0f,
+     0.0f       ,  0.0f       , +1.0f,
+    +1.0f * .67f, -1.0f * .33f,  0.0f,
+     0.0f       , +1.0f * .67f,  0.0f
+};
+
+static unsigned int pyramidIndices[] = {
+    0, 3, 1,
+    1, 3, 2,
+    2, 3, 0,
+    0, 1, 2
+};
+
+static void buildScene(std::vector<RenderObject> &objects, size_t count, Mesh *mesh, Shader *shader)
+{
+    objects.resize(count);
+
+    // a loose grid in front of the default camera, part of it outside the frustum
+    for (size_t i = 0; i < count; i++)
+    {
+        glm::vec3 position((GLfloat)(i % 64) - 32.0f, (GLfloat)(i / 64 % 64) - 32.0f, -2.0f - (GLfloat)(i / 4096) * 4.0f);
+
+        objects[i].mesh = mesh;
+        objects[i].shader = shader;
+        objects[i].model = glm::translate(glm::mat4(1.0f), position);
+        objects[i].center = position;
+        objects[i].radius = 1.0f;
+    }
+}
+
+// the lighting cases look down at a ground plane with the lights scattered just above it
+static const glm::vec3 lightingEye(0.0f, 3.0f, 0.0f);
+static const glm::vec3 lightingTarget(0.0f, 0.0f, -10.0f);
+static const GLsizei lightingWidth = 1280, lightingHeight = 720;
+
+static const glm::vec3 groundLightsMinimum(-12.0f, -1.0f, -26.0f), groundLightsSize(24.0f, 1.5f, 25.0f);
+
+static void buildLights(std::vector<PointLight> &lights, size_t count, glm::vec3 minimum, glm::vec3 size)
+{
+    lights.resize(count);
+    srand(1);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        glm::vec3 unit((GLfloat)rand() / RAND_MAX, (GLfloat)rand() / RAND_MAX, (GLfloat)rand() / RAND_MAX);
+
+        lights[i].position = minimum + unit * size;
+        lights[i].radius = 0.25f + 0.5f * rand() / RAND_MAX;
+        lights[i].colour = glm::vec3(unit.z, 1.0f - unit.x, unit.x);
+        lights[i].intensity = 1.0f;
+    }
+}
+
+static glm::mat4 lightingView()
+{
+    return glm::lookAt(lightingEye, lightingTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static glm::mat4 lightingProjection()
+{
+    return glm::perspective(glm::radians(45.0f), (GLfloat)lightingWidth / lightingHeight, 0.1f, 100.0f);
+}
+
+// the baseline for the work-stealing scheduler: one mutex-protected queue of fixed grain ranges
+// that every thread, the caller included, takes from
+class SingleQueuePool
+{
+    public:
+        SingleQueuePool(unsigned int threadCount)
+        {
+            body = NULL;
+            next = count = grain = 0;
+            unfinished = 0;
+            running = true;
+
+            for (unsigned int i = 1; i < threadCount; i++)
+                threads.push_back(std::thread(&SingleQueuePool::workerLoop, this));
+        }
+
+        void parallelFor(size_t rangeCount, size_t rangeGrain, const std::function<void(size_t, size_t)> &rangeBody)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                body = &rangeBody;
+                next = 0;
+                count = rangeCount;
+                grain = rangeGrain;
+                unfinished = (rangeCount + rangeGrain - 1) / rangeGrain;
+            }
+
+            work.notify_all();
+
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (runOne(lock)) {}
+
+            finished.wait(lock, [&]() { return unfinished == 0; });
+        }
+
+        ~SingleQueuePool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                running = false;
+            }
+
+            work.notify_all();
+
+            for (size_t i = 0; i < threads.size(); i++)
+                threads[i].join();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable work, finished;
+        std::vector<std::thread> threads;
+        bool running;
+
+        const std::function<void(size_t, size_t)> *body;
+        size_t next, count, grain, unfinished;
+
+        // takes one range off the queue & runs it outside the lock, false once the queue is empty
+        bool runOne(std::unique_lock<std::mutex> &lock)
+        {
+            if (next >= count)
+                return false;
+
+            size_t begin = next;
+            size_t end = std::min(begin + grain, count);
+            next = end;
+
+            lock.unlock();
+            (*body)(begin, end);
+            lock.lock();
+
+            if (--unfinished == 0)
+                finished.notify_all();
+
+            return true;
+        }
+
+        void workerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (running)
+            {
+                if (!runOne(lock))
+                    work.wait(lock);
+            }
+        }
+};
+
+// 16k draws split into the renderer's 256-draw chunks, each recorded into its own command buffer as
+// MultiViewRenderer::recordChunk does: the program once per chunk, then model matrix, mesh & draw
+struct DrawWorkload
+{
+    static const size_t DRAW_COUNT = 16384;
+
+    GLuint program;
+    GLint uniformModel;
+    GLuint vao, ibo;
+    GLsizei indexCount;
+
+    std::vector<glm::mat4> models;
+    std::vector<CommandBuffer> buffers;
+
+    size_t chunkCount() { return (DRAW_COUNT + MultiViewRenderer::RECORD_CHUNK_SIZE - 1) / MultiViewRenderer::RECORD_CHUNK_SIZE; }
+};
+
+static void buildDrawWorkload(DrawWorkload &workload, GLuint program, GLint uniformModel, GLuint vao, GLuint ibo, GLsizei indexCount)
+{
+    workload.program = program;
+    workload.uniformModel = uniformModel;
+    workload.vao = vao;
+    workload.ibo = ibo;
+    workload.indexCount = indexCount;
+
+    workload.models.resize(DrawWorkload::DRAW_COUNT);
+
+    for (size_t i = 0; i < DrawWorkload::DRAW_COUNT; i++)
+        workload.models[i] = glm::translate(glm::mat4(1.0f), glm::vec3((i % 128) * 0.1f - 6.4f, (i / 128) * 0.1f - 6.4f, -20.0f));
+
+    workload.buffers.resize(workload.chunkCount());
+}
+
+static void recordDrawChunk(DrawWorkload &workload, size_t chunk)
+{
+    CommandBuffer &commands = workload.buffers[chunk];
+    size_t begin = chunk * MultiViewRenderer::RECORD_CHUNK_SIZE;
+    size_t end = begin + MultiViewRenderer::RECORD_CHUNK_SIZE;
+
+    if (end > DrawWorkload::DRAW_COUNT)
+        end = DrawWorkload::DRAW_COUNT;
+
+    commands.reset();
+    commands.useProgram(workload.program);
+
+    for (size_t i = begin; i < end; i++)
+    {
+        commands.uniformMatrix(workload.uniformModel, glm::value_ptr(workload.models[i]));
+        commands.bindMesh(workload.vao, workload.ibo);
+        commands.draw(workload.indexCount);
+    }
+}
+
+// jobs NULL records every chunk on the calling thread
+static void recordDrawWorkload(DrawWorkload &workload, JobSystem *jobs)
+{
+    if (!jobs)
+    {
+        for (size_t c = 0; c < workload.chunkCount(); c++)
+            recordDrawChunk(workload, c);
+
+        return;
+    }
+
+    jobs->parallelFor(workload.chunkCount(), 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++)
+            recordDrawChunk(workload, c);
+    });
+}
+
+static void printDrawRate(const char *name)
+{
+    if (!lastRan(name))
+        return;
+
+    printf("%-34s %.0f draws/ms \n", "", DrawWorkload::DRAW_COUNT / (results.back().mean * 1e-6));
+}
+
+static const char* commandRecordNames[2] = { "commands/record 16k draws serial", "commands/record 16k draws parallel" };
+
+static void runCommandBenchmarks(JobSystem &jobs)
+{
+    // recording makes no GL calls, made up names stand in for the GL objects
+    DrawWorkload workload;
+    buildDrawWorkload(workload, 1, 0, 1, 1, 12);
+
+    for (int parallel = 0; parallel < 2; parallel++)
+    {
+        runBenchmark(commandRecordNames[parallel], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                recordDrawWorkload(workload, parallel ? &jobs : NULL);
+        });
+
+        printDrawRate(commandRecordNames[parallel]);
+    }
+}
+
+// the bounds update UpdateTransforms runs on every renderable
+static inline void updateBounds(const glm::mat4 &world, Bounds &bounds)
+{
+    GLfloat scale = fmax(glm::length(glm::vec3(world[0])), fmax(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+
+    bounds.center = glm::vec3(world[3]);
+    bounds.radius = bounds.localRadius * scale;
+}
+
+// the object list the entity store replaced: one heap allocation per object, reached through a pointer
+struct HeapObject
+{
+    glm::mat4 world;
+    Mesh *mesh;
+    Shader *material;
+    Bounds bounds;
+    uint32_t transformNode;
+};
+
+static const char* entityNames[2] = { "entities/iterate 1M", "entities/iterate 1M pointer vector" };
+
+static void runEntityBenchmarks()
+{
+    const size_t entityCount = 1000000;
+    const uint32_t renderable = COMPONENT_TRANSFORM | COMPONENT_MESH | COMPONENT_MATERIAL | COMPONENT_BOUNDS;
+
+    glm::mat4 world = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f)), glm::vec3(0.5f));
+
+    {
+        // a quarter of the entities without a material, so the query spans two archetypes
+        EntityStore entities;
+
+        for (size_t i = 0; i < entityCount; i++)
+        {
+            Entity entity = entities.create(i % 4 == 0 ? renderable & ~COMPONENT_MATERIAL : renderable);
+            entities.worldMatrix(entity) = world;
+            entities.bounds(entity).localRadius = 1.0f;
+        }
+
+        runBenchmark(entityNames[0], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+            {
+                entities.forEach(COMPONENT_TRANSFORM | COMPONENT_BOUNDS, [](Archetype &archetype) {
+                    for (size_t row = 0; row < archetype.size(); row++)
+                        updateBounds(archetype.worldMatrices[row], archetype.bounds[row]);
+                });
+            }
+        });
+    }
+
+    {
+        // shuffled, as creating & destroying objects over a session leaves them scattered across the heap
+        std::vector<HeapObject*> objects(entityCount);
+
+        for (size_t i = 0; i < entityCount; i++)
+        {
+            objects[i] = new HeapObject();
+            objects[i]->world = world;
+            objects[i]->bounds.localRadius = 1.0f;
+        }
+
+        srand(1);
+
+        for (size_t i = entityCount - 1; i > 0; i--)
+            std::swap(objects[i], objects[(size_t)rand() % (i + 1)]);
+
+        runBenchmark(entityNames[1], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+            {
+                for (size_t o = 0; o < objects.size(); o++)
+                    updateBounds(objects[o]->world, objects[o]->bounds);
+            }
+        });
+
+        for (size_t i = 0; i < entityCount; i++)
+            delete objects[i];
+    }
+}
+
+static const char* viewSweepNames[6] = {
+    "renderer/cull 10k x 1 view", "renderer/cull 10k x 2 views", "renderer/cull 10k x 4 views",
+    "renderer/cull 10k x 8 views", "renderer/cull 10k x 16 views", "renderer/cull 10k x 32 views"
+};
+
+// what each extra view costs the CPU: culling & emitting the draw lists for 1 up to MAX_VIEWS views
+// on the calling thread, the views fanned out across the scene so each sees a different part of it
+static void runViewSweepBenchmarks()
+{
+    MultiViewRenderer renderer;
+
+    std::vector<RenderObject> objects;
+    buildScene(objects, 10000, NULL, NULL);
+
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    double single = 0.0;
+
+    for (size_t c = 0, viewCount = 1; c < 6 && viewCount <= MultiViewRenderer::MAX_VIEWS; c++, viewCount *= 2)
+    {
+        renderer.clearViews();
+
+        for (size_t v = 0; v < viewCount; v++)
+        {
+            GLfloat yaw = viewCount > 1 ? glm::radians(-40.0f + 80.0f * v / (viewCount - 1)) : 0.0f;
+            int view = renderer.addView(0, 0, 64, 64);
+            renderer.setViewMatrices(view, glm::lookAt(glm::vec3(0.0f), glm::vec3(sin(yaw), 0.0f, -cos(yaw)), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+        }
+
+        runBenchmark(viewSweepNames[c], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                renderer.cull(objects);
+        });
+
+        if (!lastRan(viewSweepNames[c]))
+            continue;
+
+        if (viewCount == 1)
+            single = results.back().mean;
+        else if (single > 0.0)
+            printf("%-34s %.0f ns per added view over the %.0f ns of one view \n", "", (results.back().mean - single) / (viewCount - 1), single);
+    }
+}
+
+static const char* transformUpdateNames[2] = { "transforms/update 1M 1% dirty", "transforms/update 1M 100% dirty" };
+
+// world matrix throughput on the calling thread, evenly spaced nodes dirtied before each update.
+// the nodes form 16k objects of 64, each a 4-ary tree, so a dirty node drags in a small subtree
+// rather than most of the scene; the nodes actually updated are printed as well
+static void runTransformUpdateBenchmarks()
+{
+    const size_t nodeCount = 1 << 20, objectSize = 64;
+    const size_t spacings[2] = { 100, 1 };
+
+    TransformHierarchy transforms;
+    transforms.reserve(nodeCount);
+
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        size_t root = i - i % objectSize;
+        uint32_t parent = i == root ? TransformHierarchy::NO_PARENT : (uint32_t)(root + (i - root - 1) / 4);
+        transforms.addNode(parent, glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+    }
+
+    for (int c = 0; c < 2; c++)
+    {
+        size_t updated = 0;
+
+        runBenchmark(transformUpdateNames[c], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+            {
+                for (size_t node = 0; node < nodeCount; node += spacings[c])
+                    transforms.setTranslation(node, glm::vec3(1.0f + (i & 1) * 0.001f, 0.0f, 0.0f));
+
+                updated = transforms.update();
+            }
+        });
+
+        if (lastRan(transformUpdateNames[c]))
+            printf("%-34s %zu nodes updated | %.0f nodes per ms \n", "", updated, updated / (results.back().mean * 1e-6));
+    }
+}
+
+static const unsigned int scalingThreadCounts[7] = { 1, 2, 4, 8, 16, 32, 64 };
+static const char* scalingCullNames[7] = {
+    "scaling/cull 64k x 2 views 1 thread", "scaling/cull 64k x 2 views 2 threads", "scaling/cull 64k x 2 views 4 threads",
+    "scaling/cull 64k x 2 views 8 threads", "scaling/cull 64k x 2 views 16 threads", "scaling/cull 64k x 2 views 32 threads",
+    "scaling/cull 64k x 2 views 64 threads"
+};
+static const char* scalingTransformNames[7] = {
+    "scaling/transforms 1M 1 thread", "scaling/transforms 1M 2 threads", "scaling/transforms 1M 4 threads",
+    "scaling/transforms 1M 8 threads", "scaling/transforms 1M 16 threads", "scaling/transforms 1M 32 threads",
+    "scaling/transforms 1M 64 threads"
+};
+
+// the same case on a fresh pool of every power of two threads up to the hardware's count, each
+// pool started from its own thread so that thread is its worker 0 & the shared pool keeps main
+static void runScaling(const char* const (&names)[7], const std::function<void(JobSystem&, const char*)> &body)
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    double single = 0.0;
+
+    for (int t = 0; t < 7 && (t == 0 || scalingThreadCounts[t] <= hardwareThreads); t++)
+    {
+        std::thread runner([&]() {
+            JobSystem pool;
+            pool.Initialise(scalingThreadCounts[t], false);
+
+            body(pool, names[t]);
+
+            pool.Shutdown();
+        });
+
+        runner.join();
+
+        if (!lastRan(names[t]))
+            continue;
+
+        if (t == 0)
+            single = results.back().mean;
+        else if (single > 0.0)
+            printf("%-34s %.2fx the 1 thread speed \n", "", single / results.back().mean);
+    }
+}
+
+static void runCullScalingBenchmarks()
+{
+    MultiViewRenderer renderer;
+
+    int left = renderer.addView(0, 0, 400, 600);
+    int right = renderer.addView(400, 0, 400, 600);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 400.0f / 600.0f, 0.1f, 100.0f);
+    renderer.setViewMatrices(left, glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+    renderer.setViewMatrices(right, glm::lookAt(glm::vec3(0.0f), glm::vec3(0.3f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+
+    std::vector<RenderObject> objects;
+    buildScene(objects, 65536, NULL, NULL);
+
+    runScaling(scalingCullNames, [&](JobSystem &pool, const char *name) {
+        renderer.setJobSystem(&pool);
+
+        runBenchmark(name, [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                renderer.cull(objects);
+        });
+    });
+}
+
+// every node dirty, so the compose runs batched & each depth level of the 4-ary tree is updated in parallel
+static void runTransformScalingBenchmarks()
+{
+    const size_t nodeCount = 1 << 20;
+    TransformHierarchy transforms;
+    transforms.reserve(nodeCount);
+
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        uint32_t parent = i == 0 ? TransformHierarchy::NO_PARENT : (uint32_t)((i - 1) / 4);
+        transforms.addNode(parent, glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+    }
+
+    runScaling(scalingTransformNames, [&](JobSystem &pool, const char *name) {
+        transforms.setJobSystem(&pool);
+
+        runBenchmark(name, [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+            {
+                transforms.setRotation(0, glm::angleAxis(i * 0.001f, glm::vec3(0.0f, 1.0f, 0.0f)));
+                transforms.update();
+            }
+        });
+    });
+}
+
+static void runCpuBenchmarks(JobSystem &jobs)
+{
+    Camera camera;
+    bool keys[1024] = { false };
+    keys[GLFW_KEY_W] = true;
+
+    runBenchmark("camera/keyControl", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            camera.keyControl(keys, 1.0f / 60.0f);
+    });
+
+    runBenchmark("camera/mouseControl+view", [&](long iterations) {
+        GLfloat sink = 0.0f;
+
+        for (long i = 0; i < iterations; i++)
+        {
+            camera.mouseControl(1.0f, (i & 1) ? 0.5f : -0.5f);
+            sink += camera.calculateViewMatrix()[3][0];
+        }
+
+        if (sink == 12345.0f)
+            printf(" ");
+    });
+
+    // one orientation update per frame, the old per-event Euler formula against the quaternion camera
+    runBenchmark("camera/orientation euler", [&](long iterations) {
+        glm::vec3 worldUp(0.0f, 1.0f, 0.0f);
+        GLfloat yaw = -90.0f, pitch = 0.0f;
+        GLfloat sink = 0.0f;
+
+        for (long i = 0; i < iterations; i++)
+        {
+            yaw += 1.0f;
+            pitch = (i & 1) ? 0.5f : -0.5f;
+
+            glm::vec3 front;
+            front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+            front.y = sin(glm::radians(pitch));
+            front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+            front = glm::normalize(front);
+
+            glm::vec3 right = glm::normalize(glm::cross(front, worldUp));
+            glm::vec3 up = glm::normalize(glm::cross(right, front));
+
+            sink += front.x + right.y + up.z;
+        }
+
+        if (sink == 12345.0f)
+            printf(" ");
+    });
+
+    bool noKeys[1024] = { false };
+    Camera orientationCamera;
+
+    runBenchmark("camera/orientation quat", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            orientationCamera.mouseControl(1.0f, (i & 1) ? 0.5f : -0.5f);
+            orientationCamera.keyControl(noKeys, 1.0f / 60.0f);
+        }
+    });
+
+    orientationCamera.setSmoothing(20.0f);
+
+    runBenchmark("camera/orientation smoothed", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            orientationCamera.mouseControl(1.0f, (i & 1) ? 0.5f : -0.5f);
+            orientationCamera.keyControl(noKeys, 1.0f / 60.0f);
+        }
+    });
+
+    InputQueue queue;
+    InputEvent motion = { 0.0, 1.0f, 0.5f, 0, INPUT_MOTION, 0 };
+    InputEvent key = { 0.0, 0.0f, 0.0f, GLFW_KEY_W, INPUT_KEY, GLFW_PRESS };
+
+    runBenchmark("input/queue push+pop", [&](long iterations) {
+        InputEvent event;
+
+        for (long i = 0; i < iterations; i++)
+        {
+            queue.push(motion);
+            queue.pop(event);
+        }
+    });
+
+    runBenchmark("input/eventControl 4 events", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            queue.push(key);
+            queue.push(motion);
+            queue.push(motion);
+            queue.push(motion);
+            camera.eventControl(queue, 1.0f / 60.0f);
+        }
+    });
+
+    const size_t nodeCount = 10000;
+    TransformHierarchy transforms;
+    transforms.reserve(nodeCount);
+
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        uint32_t parent = i == 0 ? TransformHierarchy::NO_PARENT : (uint32_t)((i - 1) / 4);
+        transforms.addNode(parent, glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+    }
+
+    runBenchmark("transforms/update 10k all dirty", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            transforms.setRotation(0, glm::angleAxis(i * 0.001f, glm::vec3(0.0f, 1.0f, 0.0f)));
+            transforms.update();
+        }
+    });
+
+    runBenchmark("transforms/update 10k one leaf", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            transforms.setTranslation(nodeCount - 1, glm::vec3(i * 0.001f, 0.0f, 0.0f));
+            transforms.update();
+        }
+    });
+
+    std::vector<float> streams[10];
+
+    for (int s = 0; s < 10; s++)
+        streams[s].assign(nodeCount, s == 6 ? 1.0f : 0.5f);
+
+    TransformStreams input = {
+        streams[0].data(), streams[1].data(), streams[2].data(),
+        streams[3].data(), streams[4].data(), streams[5].data(), streams[6].data(),
+        streams[7].data(), streams[8].data(), streams[9].data()
+    };
+
+    std::vector<glm::mat4> matrices(nodeCount);
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+
+    runBenchmark("transforms/compose 10k", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            ComposeTransforms(input, nodeCount, glm::value_ptr(matrices[0]), NULL);
+    });
+
+    runBenchmark("transforms/compose 10k with MVP", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            ComposeTransforms(input, nodeCount, glm::value_ptr(matrices[0]), &viewProjection);
+    });
+
+    // every kernel the CPU runs, not just the one dispatch picks
+    const char *kernels[4] = { "scalar", "sse", "avx2", "avx512" };
+    const char *kernelCaseNames[4] = { "transforms/compose 10k scalar", "transforms/compose 10k sse", "transforms/compose 10k avx2", "transforms/compose 10k avx512" };
+
+    for (int k = 0; k < 4; k++)
+    {
+        if (!SetTransformKernel(kernels[k]))
+            continue;
+
+        runBenchmark(kernelCaseNames[k], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                ComposeTransforms(input, nodeCount, glm::value_ptr(matrices[0]), NULL);
+        });
+    }
+
+    SetTransformKernel(NULL);
+
+    // the same transforms stored as an array of structures, composed one object at a time:
+    // with glm::mat4_cast, & with the translate, rotate & scale sequence the kernels replaced
+    struct AosTransform
+    {
+        glm::vec3 translation;
+        glm::quat rotation;
+        glm::vec3 scale;
+
+        GLfloat angle; // the same rotation as the glm sequence took it
+        glm::vec3 axis;
+    };
+
+    std::vector<AosTransform> aos(nodeCount);
+
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+        aos[n].translation = glm::vec3(streams[0][n], streams[1][n], streams[2][n]);
+        aos[n].rotation = glm::normalize(glm::quat(streams[6][n], streams[3][n], streams[4][n], streams[5][n]));
+        aos[n].scale = glm::vec3(streams[7][n], streams[8][n], streams[9][n]);
+
+        aos[n].angle = glm::angle(aos[n].rotation);
+        aos[n].axis = glm::axis(aos[n].rotation);
+    }
+
+    runBenchmark("transforms/compose 10k aos", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            for (size_t n = 0; n < nodeCount; n++)
+            {
+                glm::mat4 matrix = glm::mat4_cast(aos[n].rotation);
+                matrix[0] *= aos[n].scale.x;
+                matrix[1] *= aos[n].scale.y;
+                matrix[2] *= aos[n].scale.z;
+                matrix[3] = glm::vec4(aos[n].translation, 1.0f);
+
+                matrices[n] = matrix;
+            }
+        }
+    });
+
+    runBenchmark("transforms/compose 10k aos glm", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            for (size_t n = 0; n < nodeCount; n++)
+            {
+                glm::mat4 matrix = glm::translate(glm::mat4(1.0f), aos[n].translation);
+                matrix = glm::rotate(matrix, aos[n].angle, aos[n].axis);
+                matrices[n] = glm::scale(matrix, aos[n].scale);
+            }
+        }
+    });
+
+    runGroup(entityNames, [&]() { runEntityBenchmarks(); });
+    runGroup(commandRecordNames, [&]() { runCommandBenchmarks(jobs); });
+
+    // culling makes no GL calls, so it runs without a context
+    MultiViewRenderer renderer;
+    renderer.setJobSystem(&jobs);
+
+    int left = renderer.addView(0, 0, 400, 600);
+    int right = renderer.addView(400, 0, 400, 600);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 400.0f / 600.0f, 0.1f, 100.0f);
+    renderer.setViewMatrices(left, glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+    renderer.setViewMatrices(right, glm::lookAt(glm::vec3(0.0f), glm::vec3(0.3f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+
+    std::vector<RenderObject> objects;
+    buildScene(objects, 16384, NULL, NULL);
+
+    runBenchmark("renderer/cull 16k x 2 views", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            renderer.cull(objects);
+    });
+
+    std::vector<float> values(1 << 16, 1.0f);
+
+    runBenchmark("jobs/parallelFor 64k", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            jobs.parallelFor(values.size(), 0, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++)
+                    values[v] = values[v] * 0.5f + 0.5f;
+            });
+        }
+    });
+
+    // the same loops on one shared queue, split as finely as parallelFor's automatic grain
+    SingleQueuePool singleQueue(jobs.getThreadCount());
+    size_t valuesGrain = std::max(values.size() / (jobs.getThreadCount() * 8), (size_t)1);
+
+    runBenchmark("jobs/parallelFor 64k single queue", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            singleQueue.parallelFor(values.size(), valuesGrain, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++)
+                    values[v] = values[v] * 0.5f + 0.5f;
+            });
+        }
+    });
+
+    // uneven work, element v costs v steps: the tail ranges dominate unless idle threads take over
+    std::vector<float> skewed(1024, 1.0f);
+    size_t skewedGrain = std::max(skewed.size() / (jobs.getThreadCount() * 8), (size_t)1);
+
+    auto skewedBody = [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++)
+        {
+            float value = skewed[v];
+
+            for (size_t step = 0; step < v; step++)
+                value = value * 0.999f + 0.001f;
+
+            skewed[v] = value;
+        }
+    };
+
+    runBenchmark("jobs/skewed 1k", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            jobs.parallelFor(skewed.size(), 0, skewedBody);
+    });
+
+    runBenchmark("jobs/skewed 1k single queue", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            singleQueue.parallelFor(skewed.size(), skewedGrain, skewedBody);
+    });
+
+    // binning makes no GL calls either, upload() is left to the GL cases
+    ClusteredLighting lighting;
+    lighting.setJobSystem(&jobs);
+
+    std::vector<PointLight> lights;
+    const size_t lightCounts[3] = { 1000, 10000, 100000 };
+    const char *binNames[3] = { "lighting/bin 1k lights", "lighting/bin 10k lights", "lighting/bin 100k lights" };
+
+    for (int c = 0; c < 3; c++)
+    {
+        buildLights(lights, lightCounts[c], groundLightsMinimum, groundLightsSize);
+
+        runBenchmark(binNames[c], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                lighting.bin(lights, lightingView(), lightingProjection());
+        });
+
+        if (lighting.getLightCount() == lightCounts[c])
+            printf("%-34s %zu assignments | most per cluster %u | dropped %zu \n", "", lighting.getAssignmentCount(),
+                lighting.getMaxLightsPerCluster(), lighting.getDroppedCount());
+    }
+
+    FrameArena arena;
+    arena.Initialise(1 << 20, 2);
+
+    runBenchmark("arena/allocate 64 B", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            if ((i & 4095) == 0)
+                arena.beginFrame();
+
+            arena.allocate(64);
+        }
+    });
+}
+
+static const char* objBenchmarkFile = "benchmark-model.obj";
+static const char* gltfBenchmarkFile = "benchmark-model.gltf";
+static const char* gltfBenchmarkBuffer = "benchmark-model.bin"; // referenced by name from the .gltf
+static const int modelRings = 256, modelSegments = 512; // a UV sphere of about 260k triangles
+
+// positions, texture coordinates & normals of a UV sphere, seam & poles duplicated as an exporter would
+static void buildSphere(std::vector<GLfloat> &vertices, std::vector<unsigned int> &indices)
+{
+    vertices.clear();
+    indices.clear();
+
+    for (int ring = 0; ring <= modelRings; ring++)
+    {
+        for (int segment = 0; segment <= modelSegments; segment++)
+        {
+            GLfloat u = (GLfloat)segment / modelSegments, v = (GLfloat)ring / modelRings;
+            GLfloat theta = u * 6.2831853f, phi = v * 3.14159265f;
+            GLfloat x = sin(phi) * cos(theta), y = cos(phi), z = sin(phi) * sin(theta);
+            GLfloat vertex[8] = { x, y, z, x, y, z, u, v };
+
+            vertices.insert(vertices.end(), vertex, vertex + 8);
+        }
+    }
+
+    for (int ring = 0; ring < modelRings; ring++)
+    {
+        for (int segment = 0; segment < modelSegments; segment++)
+        {
+            unsigned int a = ring * (modelSegments + 1) + segment, b = a + modelSegments + 1;
+            unsigned int quad[6] = { a, b, a + 1, a + 1, b, b + 1 };
+
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+// returns the size of the OBJ, 0 if it couldn't be written
+static size_t writeBenchmarkModels(const std::vector<GLfloat> &vertices, const std::vector<unsigned int> &indices)
+{
+    FILE *obj = fopen(objBenchmarkFile, "wb");
+    FILE *buffer = fopen(gltfBenchmarkBuffer, "wb");
+    FILE *gltf = fopen(gltfBenchmarkFile, "wb");
+
+    if (!obj || !buffer || !gltf)
+    {
+        printf("Failed to write the benchmark models \n");
+
+        if (obj) fclose(obj);
+        if (buffer) fclose(buffer);
+        if (gltf) fclose(gltf);
+
+        return 0;
+    }
+
+    size_t vertexCount = vertices.size() / 8;
+
+    fprintf(obj, "# benchmark sphere\no sphere\n");
+
+    for (size_t v = 0; v < vertexCount; v++)
+        fprintf(obj, "v %.6f %.6f %.6f\n", vertices[v * 8], vertices[v * 8 + 1], vertices[v * 8 + 2]);
+
+    for (size_t v = 0; v < vertexCount; v++)
+        fprintf(obj, "vt %.6f %.6f\n", vertices[v * 8 + 6], vertices[v * 8 + 7]);
+
+    for (size_t v = 0; v < vertexCount; v++)
+        fprintf(obj, "vn %.6f %.6f %.6f\n", vertices[v * 8 + 3], vertices[v * 8 + 4], vertices[v * 8 + 5]);
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+        fprintf(obj, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", indices[i] + 1, indices[i] + 1, indices[i] + 1,
+            indices[i + 1] + 1, indices[i + 1] + 1, indices[i + 1] + 1, indices[i + 2] + 1, indices[i + 2] + 1, indices[i + 2] + 1);
+
+    size_t objSize = ftell(obj);
+    fclose(obj);
+
+    // one interleaved vertex view & one index view in the same buffer
+    size_t vertexBytes = vertices.size() * sizeof(GLfloat), indexBytes = indices.size() * sizeof(unsigned int);
+
+    fwrite(vertices.data(), 1, vertexBytes, buffer);
+    fwrite(indices.data(), 1, indexBytes, buffer);
+    fclose(buffer);
+
+    fprintf(gltf, "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"uri\":\"%s\",\"byteLength\":%zu}],\n", gltfBenchmarkBuffer, vertexBytes + indexBytes);
+    fprintf(gltf, "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%zu,\"byteStride\":32},{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}],\n",
+        vertexBytes, vertexBytes, indexBytes);
+    fprintf(gltf, "\"accessors\":[{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+        "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+        "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC2\"},"
+        "{\"bufferView\":1,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}],\n", vertexCount, vertexCount, vertexCount, indices.size());
+    fprintf(gltf, "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}]}\n");
+    fclose(gltf);
+
+    return objSize;
+}
+
+// the textbook reader: a line at a time through iostreams, sscanf, & a string keyed map for the corners
+static bool loadObjNaive(const char *fileLocation, ModelData &model)
+{
+    std::ifstream stream(fileLocation);
+
+    if (!stream)
+        return false;
+
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texCoords;
+    std::unordered_map<std::string, unsigned int> corners;
+    std::string line;
+
+    model.vertices.clear();
+    model.indices.clear();
+
+    while (std::getline(stream, line))
+    {
+        float x, y, z;
+
+        if (line.compare(0, 2, "v ") == 0 && sscanf(line.c_str() + 2, "%f %f %f", &x, &y, &z) == 3)
+            positions.push_back(glm::vec3(x, y, z));
+        else if (line.compare(0, 3, "vt ") == 0 && sscanf(line.c_str() + 3, "%f %f", &x, &y) == 2)
+            texCoords.push_back(glm::vec2(x, y));
+        else if (line.compare(0, 3, "vn ") == 0 && sscanf(line.c_str() + 3, "%f %f %f", &x, &y, &z) == 3)
+            normals.push_back(glm::vec3(x, y, z));
+        else if (line.compare(0, 2, "f ") == 0)
+        {
+            char corner[3][64];
+
+            if (sscanf(line.c_str() + 2, "%63s %63s %63s", corner[0], corner[1], corner[2]) != 3)
+                return false;
+
+            for (int c = 0; c < 3; c++)
+            {
+                auto found = corners.find(corner[c]);
+
+                if (found == corners.end())
+                {
+                    unsigned int p, t, n;
+
+                    if (sscanf(corner[c], "%u/%u/%u", &p, &t, &n) != 3 || p > positions.size() || t > texCoords.size() || n > normals.size())
+                        return false;
+
+                    GLfloat vertex[8] = { positions[p - 1].x, positions[p - 1].y, positions[p - 1].z,
+                        normals[n - 1].x, normals[n - 1].y, normals[n - 1].z, texCoords[t - 1].x, texCoords[t - 1].y };
+
+                    model.vertices.insert(model.vertices.end(), vertex, vertex + 8);
+                    found = corners.insert(std::make_pair(std::string(corner[c]), (unsigned int)model.getVertexCount() - 1)).first;
+                }
+
+                model.indices.push_back(found->second);
+            }
+        }
+    }
+
+    return true;
+}
+
+static void printThroughput(const char *name, size_t bytes)
+{
+    if (!lastRan(name))
+        return;
+
+    printf("%-34s %.1f MB/s \n", "", bytes / (1024.0 * 1024.0) / (results.back().mean * 1e-9));
+}
+
+static const char* modelNames[3] = { "model/obj naive", "model/obj loader", "model/gltf loader" };
+
+static void runModelBenchmarks(JobSystem &jobs)
+{
+    std::vector<GLfloat> vertices;
+    std::vector<unsigned int> indices;
+
+    buildSphere(vertices, indices);
+
+    size_t objSize = writeBenchmarkModels(vertices, indices);
+
+    if (objSize == 0)
+        return;
+
+    size_t gltfSize = vertices.size() * sizeof(GLfloat) + indices.size() * sizeof(unsigned int);
+
+    printf("model %.1f MB OBJ | %.1f MB glTF buffer | %zu triangles \n", objSize / (1024.0 * 1024.0), gltfSize / (1024.0 * 1024.0), indices.size() / 3);
+
+    ModelData model;
+    ModelLoader loader;
+    loader.setJobSystem(&jobs);
+
+    runBenchmark(modelNames[0], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            loadObjNaive(objBenchmarkFile, model);
+    });
+
+    printThroughput(modelNames[0], objSize);
+
+    runBenchmark(modelNames[1], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            loader.loadObj(objBenchmarkFile, model);
+    });
+
+    printThroughput(modelNames[1], objSize);
+
+    if (model.getVertexCount() > 0)
+        printf("%-34s %zu vertices from %zu corners \n", "", model.getVertexCount(), model.indices.size());
+
+    runBenchmark(modelNames[2], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+            loader.loadGltf(gltfBenchmarkFile, model);
+    });
+
+    printThroughput(modelNames[2], gltfSize);
+
+    remove(objBenchmarkFile);
+    remove(gltfBenchmarkFile);
+    remove(gltfBenchmarkBuffer);
+}
+
+static const int terrainSize = 4096; // samples across, 2 units apart
+static const GLfloat terrainSpacing = 2.0f, terrainHeight = 400.0f, terrainLodDistance = 256.0f;
+static const GLfloat terrainDistances[3] = { 250.0f, 1000.0f, 4000.0f }; // far planes of the terrain cases
+static const char* terrainSelectNames[3] = { "terrain/select 250 m", "terrain/select 1 km", "terrain/select 4 km" };
+static const char* terrainRenderNames[3] = { "terrain/render 250 m", "terrain/render 1 km", "terrain/render 4 km" };
+
+// rolling hills of a few sine octaves, generated on the job system
+static bool buildTerrain(JobSystem &jobs, Terrain &terrain)
+{
+    std::vector<uint16_t> heights((size_t)terrainSize * terrainSize);
+
+    jobs.parallelFor(terrainSize, 0, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++)
+        {
+            for (int column = 0; column < terrainSize; column++)
+            {
+                GLfloat x = column * 0.01f, z = row * 0.01f, height = 0.0f, amplitude = 0.25f;
+
+                for (int octave = 0; octave < 4; octave++)
+                {
+                    height += amplitude * (sin(x) * cos(z * 1.3f) + 1.0f);
+                    x = x * 2.1f + 1.7f;
+                    z = z * 1.9f + 0.3f;
+                    amplitude *= 0.5f;
+                }
+
+                heights[row * terrainSize + column] = (uint16_t)(std::min(height, 1.0f) * 65535.0f);
+            }
+        }
+    });
+
+    return terrain.createHeightmap(terrainSize, terrainSpacing, terrainHeight, 0.0f, terrainLodDistance, heights.data());
+}
+
+// standing a little above the centre sample, looking along the ground
+static glm::mat4 terrainView()
+{
+    GLfloat eyeHeight = terrainHeight * 0.5f;
+
+    return glm::lookAt(glm::vec3(0.0f, eyeHeight, 0.0f), glm::vec3(0.0f, eyeHeight - 40.0f, -200.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static glm::mat4 terrainProjection(GLfloat viewDistance)
+{
+    return glm::perspective(glm::radians(45.0f), (GLfloat)lightingWidth / lightingHeight, 0.1f, viewDistance);
+}
+
+// CPU cost of the CDLOD quadtree walk & how much geometry it picks, as the far plane moves out
+static void runTerrainBenchmarks(JobSystem &jobs)
+{
+    Terrain terrain;
+
+    if (!buildTerrain(jobs, terrain))
+        return;
+
+    glm::mat4 view = terrainView();
+
+    for (int d = 0; d < 3; d++)
+    {
+        glm::mat4 projection = terrainProjection(terrainDistances[d]);
+
+        runBenchmark(terrainSelectNames[d], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                terrain.select(view, projection);
+        });
+
+        if (lastRan(terrainSelectNames[d]))
+            printf("%-34s %zu nodes | %zu vertices per frame \n", "", terrain.getSelectedCount(), terrain.getVertexCount());
+    }
+}
+
+static const size_t particleCounts[4] = { 10000, 100000, 1000000, 10000000 };
+static const char* particleUpdateNames[4] = { "particles/update 10k", "particles/update 100k", "particles/update 1M", "particles/update 10M" };
+static const char* particleFrameNames[4] = { "particles/frame 10k", "particles/frame 100k", "particles/frame 1M", "particles/frame 10M" };
+
+// a fountain at its steady state, run for a lifetime so about count particles of every age are alive
+static bool buildParticles(JobSystem &jobs, ParticleSystem &particles, size_t count)
+{
+    if (!particles.reserve(count + count / 4))
+        return false;
+
+    ParticleEmitter fountain;
+    fountain.position = glm::vec3(0.0f, 0.0f, -5.0f);
+    fountain.radius = 0.1f;
+    fountain.velocity = glm::vec3(0.0f, 3.5f, 0.0f);
+    fountain.spread = 1.0f;
+    fountain.lifetime = 2.0f;
+    fountain.rate = count / (0.75f * fountain.lifetime);
+
+    particles.setJobSystem(&jobs);
+    particles.setEmitter(fountain);
+    particles.setForces(-4.0f, 0.2f, -1.0f, 0.4f);
+
+    for (int frame = 0; frame < 120; frame++)
+        particles.update(1.0f / 60.0f);
+
+    return true;
+}
+
+// integration, ground bounces, compaction & emission of a 60 Hz frame on the job system
+static void runParticleBenchmarks(JobSystem &jobs)
+{
+    printf("particle kernel %s \n", ParticleSystem::getKernelName());
+
+    for (int c = 0; c < 4; c++)
+    {
+        if (!caseSelected(particleUpdateNames[c]))
+            continue;
+
+        ParticleSystem particles;
+
+        if (!buildParticles(jobs, particles, particleCounts[c]))
+            continue;
+
+        runBenchmark(particleUpdateNames[c], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                particles.update(1.0f / 60.0f);
+        });
+
+        if (lastRan(particleUpdateNames[c]))
+            printf("%-34s %zu live | %.0f particles updated per ms \n", "", particles.getLiveCount(),
+                particles.getLiveCount() / (results.back().mean * 1e-6));
+    }
+}
+
+#ifdef ENABLE_DEBUG_DRAW
+static const size_t debugLineCount = 1000000;
+
+// a million short segments scattered through a 100 unit cube, one line per call
+static void drawDebugLines(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        glm::vec3 from((i % 100) * 1.0f, (i / 100 % 100) * 1.0f, (i / 10000 % 100) * 1.0f);
+        DEBUG_DRAW_LINE(from, from + glm::vec3(0.5f, 0.5f, 0.0f), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f), i & 1 ? DEBUG_OVERLAY : DEBUG_DEPTH_TESTED);
+    }
+}
+
+static const char* debugLineNames[3] = { "debug/lines 1M", "debug/lines 1M jobs", "debug/boxes 100k jobs" };
+static const char* debugFrameNames[1] = { "debug/frame 1M lines" };
+
+// recording cost of the debug draw, from one thread & from every worker into their own arrays
+static void runDebugDrawBenchmarks(JobSystem &jobs)
+{
+    runBenchmark(debugLineNames[0], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            drawDebugLines(0, debugLineCount);
+            debugDraw.clear();
+        }
+    });
+
+    runBenchmark(debugLineNames[1], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            jobs.parallelFor(debugLineCount, 4096, drawDebugLines);
+            debugDraw.clear();
+        }
+    });
+
+    runBenchmark(debugLineNames[2], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            jobs.parallelFor(100000, 1024, [](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; b++)
+                {
+                    glm::vec3 corner((b % 50) * 2.0f, (b / 50 % 50) * 2.0f, (b / 2500) * 2.0f);
+                    DEBUG_DRAW_BOX(corner, corner + glm::vec3(1.0f), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+                }
+            });
+
+            debugDraw.clear();
+        }
+    });
+}
+#endif
+
+// a 720p colour & depth target for the lighting cases, left bound
+static bool createLightingTarget(GLuint &framebuffer, GLuint *renderbuffers)
+{
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(2, renderbuffers);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, lightingWidth, lightingHeight);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, lightingWidth, lightingHeight);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        printf("Failed to create the lighting framebuffer, skipping the lighting cases \n");
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(2, renderbuffers);
+        glDeleteFramebuffers(1, &framebuffer);
+        return false;
+    }
+
+    glViewport(0, 0, lightingWidth, lightingHeight);
+
+    return true;
+}
+
+static void deleteLightingTarget(GLuint &framebuffer, GLuint *renderbuffers)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(2, renderbuffers);
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+// the unlit case, then an upload & a shading case for each light count
+static const char* lightingNames[7] = {
+    "lighting/fragments unlit 720p",
+    "lighting/upload 1k lights", "lighting/fragments 1k lights 720p",
+    "lighting/upload 10k lights", "lighting/fragments 10k lights 720p",
+    "lighting/upload 100k lights", "lighting/fragments 100k lights 720p"
+};
+
+// fragment cost of clustered shading: the ground plane fills a 720p target with one light loop per fragment
+static void runLightingBenchmarks(JobSystem &jobs, std::vector<GLfloat> &gridVertices, std::vector<unsigned int> &gridIndices)
+{
+    GLuint framebuffer, renderbuffers[2];
+
+    if (!createLightingTarget(framebuffer, renderbuffers))
+        return;
+
+    Mesh ground;
+    ground.CreateMesh(gridVertices.data(), gridIndices.data(), gridVertices.size(), gridIndices.size());
+
+    // 256 grid units scaled to 25.5, centred under the lights
+    glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(-12.75f, -1.0f, -26.5f)), glm::vec3(0.1f));
+    glm::mat4 view = lightingView();
+    glm::mat4 projection = lightingProjection();
+
+    Shader unlit, clustered;
+    unlit.CreateFromFiles(vShader, fShader);
+    clustered.CreateFromFiles(vShader, fClusteredShader);
+
+    Shader *shaders[2] = { &unlit, &clustered };
+
+    for (int s = 0; s < 2; s++)
+    {
+        shaders[s]->UseShader();
+        glUniformMatrix4fv(shaders[s]->GetModelLocation(), 1, GL_FALSE, glm::value_ptr(model));
+        glUniformMatrix4fv(shaders[s]->GetViewLocation(), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(shaders[s]->GetProjectionLocation(), 1, GL_FALSE, glm::value_ptr(projection));
+    }
+
+    auto drawGround = [&](Shader *shader, long iterations) {
+        shader->UseShader();
+
+        for (long i = 0; i < iterations; i++)
+        {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            ground.RenderMesh();
+        }
+
+        glFinish();
+    };
+
+    runBenchmark(lightingNames[0], [&](long iterations) { drawGround(&unlit, iterations); });
+
+    ClusteredLighting lighting;
+    lighting.setJobSystem(&jobs);
+
+    if (lighting.Initialise())
+    {
+        std::vector<PointLight> lights;
+        const size_t lightCounts[3] = { 1000, 10000, 100000 };
+
+        for (int c = 0; c < 3; c++)
+        {
+            buildLights(lights, lightCounts[c], groundLightsMinimum, groundLightsSize);
+            lighting.bin(lights, view, projection);
+
+            runBenchmark(lightingNames[1 + 2 * c], [&](long iterations) {
+                for (long i = 0; i < iterations; i++)
+                    lighting.upload();
+
+                glFinish();
+            });
+
+            lighting.bind(&clustered, 1);
+
+            runBenchmark(lightingNames[2 + 2 * c], [&](long iterations) { drawGround(&clustered, iterations); });
+        }
+
+        lighting.Shutdown();
+    }
+
+    glUseProgram(0);
+    deleteLightingTarget(framebuffer, renderbuffers);
+}
+
+static const char* deferredNames[2] = { "deferred/frame forward 8 layers", "deferred/frame deferred 8 layers" };
+
+// forward against deferred on a scene that draws every pixel many times over, back to front:
+// forward shades every layer, deferred lights each pixel once from the G-buffer
+static void runDeferredBenchmarks(JobSystem &jobs, std::vector<GLfloat> &gridVertices, std::vector<unsigned int> &gridIndices)
+{
+    GLuint framebuffer, renderbuffers[2];
+
+    if (!createLightingTarget(framebuffer, renderbuffers))
+        return;
+
+    const size_t layerCount = 8;
+
+    Mesh layer;
+    layer.CreateMesh(gridVertices.data(), gridIndices.data(), gridVertices.size(), gridIndices.size());
+
+    Shader forward, depth, geometry, deferredLighting;
+    forward.CreateFromFiles(vShader, fClusteredShader);
+    depth.CreateFromFiles(vShader, fDepthShader);
+    geometry.CreateFromFiles(vShader, fGeometryShader);
+    deferredLighting.CreateFromFiles(vFullscreenShader, fDeferredShader);
+
+    // the ground grid stood up to face the camera, each layer covering the whole target
+    std::vector<RenderObject> objects(layerCount);
+
+    for (size_t i = 0; i < layerCount; i++)
+    {
+        GLfloat z = -4.0f - 2.0f * (layerCount - 1 - i);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(-12.75f, 12.75f, z));
+        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+
+        objects[i].mesh = &layer;
+        objects[i].shader = &forward;
+        objects[i].model = glm::scale(model, glm::vec3(0.1f));
+        objects[i].center = glm::vec3(0.0f, 0.0f, z);
+        objects[i].radius = 18.1f;
+    }
+
+    std::vector<View> views(1);
+    views[0].x = 0;
+    views[0].y = 0;
+    views[0].width = lightingWidth;
+    views[0].height = lightingHeight;
+    views[0].view = glm::mat4(1.0f);
+    views[0].projection = lightingProjection();
+
+    MultiViewRenderer renderer;
+    renderer.setJobSystem(&jobs);
+    renderer.setShaders(&forward, NULL);
+    renderer.addView(views[0].x, views[0].y, views[0].width, views[0].height);
+    renderer.setViewMatrices(0, views[0].view, views[0].projection);
+
+    ClusteredLighting lighting;
+    lighting.setJobSystem(&jobs);
+
+    DeferredRenderer deferred;
+    deferred.setShaders(&depth, &geometry, &deferredLighting);
+    deferred.setOutputFramebuffer(framebuffer);
+
+    if (lighting.Initialise() && deferred.Initialise(lightingWidth, lightingHeight))
+    {
+        // the lights fill the box the layers stand in
+        std::vector<PointLight> lights;
+        buildLights(lights, 1000, glm::vec3(-12.0f, -7.0f, -4.0f - 2.0f * layerCount), glm::vec3(24.0f, 14.0f, 2.0f * layerCount));
+
+        lighting.bin(lights, views[0].view, views[0].projection);
+        lighting.upload();
+
+        // a forward frame with its fragments counted, colour & depth written for each
+        GLuint query;
+        GLuint forwardSamples = 0;
+        glGenQueries(1, &query);
+
+        auto drawForward = [&]() {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            lighting.bind(&forward, DeferredRenderer::CLUSTER_UNIT);
+            renderer.cull(objects);
+            renderer.render(objects);
+        };
+
+        auto drawDeferred = [&]() {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            renderer.cull(objects);
+            deferred.render(renderer, objects, views, lighting);
+        };
+
+        runBenchmark(deferredNames[0], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                drawForward();
+
+            glFinish();
+        });
+
+        glBeginQuery(GL_SAMPLES_PASSED, query);
+        drawForward();
+        glEndQuery(GL_SAMPLES_PASSED);
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT, &forwardSamples);
+
+        printf("%-34s %.2f MB per frame written to colour & depth, %.1f shaded fragments per pixel \n", "",
+            forwardSamples * 8.0 / (1024.0 * 1024.0), (double)forwardSamples / (lightingWidth * lightingHeight));
+
+        runBenchmark(deferredNames[1], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+                drawDeferred();
+
+            glFinish();
+        });
+
+        printf("%-34s %.2f MB per frame of G-buffer traffic, %zu bytes per pixel \n", "",
+            deferred.getMeanFrameBytes() / (1024.0 * 1024.0), DeferredRenderer::COLOUR_BYTES + DeferredRenderer::DEPTH_BYTES);
+
+        glDeleteQueries(1, &query);
+    }
+
+    deferred.Shutdown();
+    lighting.Shutdown();
+
+    deleteLightingTarget(framebuffer, renderbuffers);
+}
+
+// vertex throughput of the displaced patches, selection included as main.cpp does it
+static void runTerrainRenderBenchmarks(JobSystem &jobs)
+{
+    GLuint framebuffer, renderbuffers[2];
+
+    if (!createLightingTarget(framebuffer, renderbuffers))
+        return;
+
+    Shader shader;
+    shader.CreateFromFiles(vTerrainShader, fTerrainShader);
+
+    Terrain terrain;
+
+    if (buildTerrain(jobs, terrain) && terrain.Initialise(&shader, 0))
+    {
+        glm::mat4 view = terrainView();
+
+        for (int d = 0; d < 3; d++)
+        {
+            glm::mat4 projection = terrainProjection(terrainDistances[d]);
+
+            runBenchmark(terrainRenderNames[d], [&](long iterations) {
+                for (long i = 0; i < iterations; i++)
+                {
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                    terrain.render(view, projection);
+                }
+
+                glFinish();
+            });
+
+            if (lastRan(terrainRenderNames[d]))
+                printf("%-34s %zu vertices per frame | %.1f M vertices/s \n", "", terrain.getVertexCount(),
+                    terrain.getVertexCount() / (results.back().mean * 1e-9) / 1e6);
+        }
+    }
+
+    terrain.Shutdown();
+    shader.ClearShader();
+
+    deleteLightingTarget(framebuffer, renderbuffers);
+}
+
+// a whole particle frame as main.cpp runs it: update, stream the vertices & draw the point sprites
+static void runParticleRenderBenchmarks(JobSystem &jobs)
+{
+    GLuint framebuffer, renderbuffers[2];
+
+    if (!createLightingTarget(framebuffer, renderbuffers))
+        return;
+
+    Shader shader;
+    shader.CreateFromFiles(vParticleShader, fParticleShader);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.0f, 2.0f), glm::vec3(0.0f, 1.0f, -5.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (GLfloat)lightingWidth / lightingHeight, 0.1f, 100.0f);
+
+    for (int c = 0; c < 4; c++)
+    {
+        if (!caseSelected(particleFrameNames[c]))
+            continue;
+
+        ParticleSystem particles;
+
+        if (buildParticles(jobs, particles, particleCounts[c]) && particles.Initialise(&shader, 0.02f))
+        {
+            runBenchmark(particleFrameNames[c], [&](long iterations) {
+                for (long i = 0; i < iterations; i++)
+                {
+                    particles.update(1.0f / 60.0f);
+                    particles.upload();
+
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                    particles.render(view, projection, lightingHeight);
+                }
+
+                glFinish();
+            });
+
+            if (lastRan(particleFrameNames[c]))
+                printf("%-34s %zu particles per frame | %.1f frames/s \n", "", particles.getLiveCount(),
+                    1e9 / results.back().mean);
+        }
+
+        particles.Shutdown();
+    }
+
+    shader.ClearShader();
+
+    deleteLightingTarget(framebuffer, renderbuffers);
+}
+
+#ifdef ENABLE_DEBUG_DRAW
+// a million lines recorded on the workers, merged into the streamed buffer & drawn in two calls
+static void runDebugDrawRenderBenchmarks(JobSystem &jobs)
+{
+    GLuint framebuffer, renderbuffers[2];
+
+    if (!createLightingTarget(framebuffer, renderbuffers))
+        return;
+
+    Shader shader;
+    shader.CreateFromFiles(vDebugShader, fDebugShader);
+
+    glm::mat4 view = glm::lookAt(glm::vec3(150.0f, 120.0f, 150.0f), glm::vec3(50.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (GLfloat)lightingWidth / lightingHeight, 0.1f, 500.0f);
+
+    if (debugDraw.Initialise(&shader))
+    {
+        debugDraw.setJobSystem(&jobs);
+
+        runBenchmark(debugFrameNames[0], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+            {
+                jobs.parallelFor(debugLineCount, 4096, drawDebugLines);
+                debugDraw.upload();
+
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                debugDraw.render(view, projection);
+            }
+
+            glFinish();
+        });
+
+        if (lastRan(debugFrameNames[0]))
+            printf("%-34s %zu lines per frame from %zu threads | %.1f frames/s \n", "", debugDraw.getLineCount(),
+                debugDraw.getThreadCount(), 1e9 / results.back().mean);
+    }
+
+    debugDraw.Shutdown();
+    shader.ClearShader();
+
+    deleteLightingTarget(framebuffer, renderbuffers);
+}
+#endif
+
+static const char* commandReplayNames[3] = {
+    "commands/direct 16k draws", "commands/record+replay 16k draws serial", "commands/record+replay 16k draws parallel"
+};
+
+// the same draws submitted straight from the GL thread, against recording them into command buffers
+// first, on one thread or on every worker, & replaying those
+static void runCommandRenderBenchmarks(JobSystem &jobs, Shader &shader, Mesh &mesh)
+{
+    DrawWorkload workload;
+    buildDrawWorkload(workload, shader.GetShaderId(), shader.GetModelLocation(), mesh.GetVAO(), mesh.GetIBO(), mesh.GetIndexCount());
+
+    shader.UseShader();
+
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+    glUniformMatrix4fv(shader.GetProjectionLocation(), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniformMatrix4fv(shader.GetViewLocation(), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+
+    runBenchmark(commandReplayNames[0], [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            GLuint program = 0, vao = 0;
+
+            // the calls replay makes, redundant binds skipped the same way
+            for (size_t d = 0; d < DrawWorkload::DRAW_COUNT; d++)
+            {
+                if (d % MultiViewRenderer::RECORD_CHUNK_SIZE == 0 && program != workload.program)
+                {
+                    glUseProgram(workload.program);
+                    program = workload.program;
+                }
+
+                glUniformMatrix4fv(workload.uniformModel, 1, GL_FALSE, glm::value_ptr(workload.models[d]));
+
+                if (vao != workload.vao)
+                {
+                    glBindVertexArray(workload.vao);
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, workload.ibo);
+                    vao = workload.vao;
+                }
+
+                glDrawElements(GL_TRIANGLES, workload.indexCount, GL_UNSIGNED_INT, 0);
+            }
+        }
+
+        glFinish();
+    });
+
+    printDrawRate(commandReplayNames[0]);
+
+    for (int parallel = 0; parallel < 2; parallel++)
+    {
+        runBenchmark(commandReplayNames[1 + parallel], [&](long iterations) {
+            for (long i = 0; i < iterations; i++)
+            {
+                recordDrawWorkload(workload, parallel ? &jobs : NULL);
+
+                CommandBuffer::ReplayState state;
+
+                for (size_t c = 0; c < workload.buffers.size(); c++)
+                    workload.buffers[c].replay(state);
+            }
+
+            glFinish();
+        });
+
+        printDrawRate(commandReplayNames[1 + parallel]);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+static void runGlBenchmarks(JobSystem &jobs)
+{
+    Shader shader;
+    shader.CreateFromFiles(vShader, fShader);
+
+    std::string vertexCode = shader.ReadFile(vShader);
+    std::string fragmentCode = shader.ReadFile(fShader);
+
+    runBenchmark("shader/compile+link", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            Shader compiled;
+            compiled.CreateFromString(vertexCode.c_str(), fragmentCode.c_str());
+            compiled.ClearShader();
+        }
+
+        glFinish();
+    });
+
+    runBenchmark("mesh/create+upload pyramid", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            Mesh mesh;
+            mesh.CreateMesh(pyramidVertices, pyramidIndices, 12, 12);
+        }
+
+        glFinish();
+    });
+
+    // a 256x256 grid, 64k vertices & 390k indices
+    const unsigned int side = 256;
+    std::vector<GLfloat> gridVertices;
+    std::vector<unsigned int> gridIndices;
+
+    for (unsigned int z = 0; z < side; z++)
+    {
+        for (unsigned int x = 0; x < side; x++)
+        {
+            gridVertices.push_back((GLfloat)x);
+            gridVertices.push_back(0.0f);
+            gridVertices.push_back((GLfloat)z);
+
+            if (x + 1 < side && z + 1 < side)
+            {
+                unsigned int corner = z * side + x;
+                unsigned int quad[6] = { corner, corner + side, corner + 1, corner + 1, corner + side, corner + side + 1 };
+                gridIndices.insert(gridIndices.end(), quad, quad + 6);
+            }
+        }
+    }
+
+    runBenchmark("mesh/create+upload 64k vertices", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            Mesh mesh;
+            mesh.CreateMesh(gridVertices.data(), gridIndices.data(), gridVertices.size(), gridIndices.size());
+        }
+
+        glFinish();
+    });
+
+    Mesh pyramid;
+    pyramid.CreateMesh(pyramidVertices, pyramidIndices, 12, 12);
+
+    shader.UseShader();
+    GLuint uniformModel = shader.GetModelLocation();
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -2.5f));
+
+    runBenchmark("uniform/mat4 upload", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            model[3][0] = (GLfloat)(i & 7) * 0.01f;
+            glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
+        }
+
+        glFinish();
+    });
+
+    runBenchmark("draw/RenderMesh", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
+            pyramid.RenderMesh();
+        }
+
+        glFinish();
+    });
+
+    glUseProgram(0);
+
+    runGroup(commandReplayNames, [&]() { runCommandRenderBenchmarks(jobs, shader, pyramid); });
+    runGroup(lightingNames, [&]() { runLightingBenchmarks(jobs, gridVertices, gridIndices); });
+    runGroup(deferredNames, [&]() { runDeferredBenchmarks(jobs, gridVertices, gridIndices); });
+    runGroup(terrainRenderNames, [&]() { runTerrainRenderBenchmarks(jobs); });
+    runGroup(particleFrameNames, [&]() { runParticleRenderBenchmarks(jobs); });
+
+#ifdef ENABLE_DEBUG_DRAW
+    runGroup(debugFrameNames, [&]() { runDebugDrawRenderBenchmarks(jobs); });
+#endif
+
+    // the full submission path main.cpp uses: cull, record command buffers, replay
+    MultiViewRenderer renderer;
+    renderer.setJobSystem(&jobs);
+    renderer.setShaders(&shader, NULL);
+
+    int view = renderer.addView(0, 0, 64, 64);
+    renderer.setViewMatrices(view, glm::mat4(1.0f), glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f));
+
+    std::vector<RenderObject> objects;
+    buildScene(objects, 4096, &pyramid, &shader);
+
+    runBenchmark("draw/renderer 4k objects", [&](long iterations) {
+        for (long i = 0; i < iterations; i++)
+        {
+            renderer.cull(objects);
+            renderer.render(objects);
+        }
+
+        glFinish();
+    });
+}
+
+int main(int argc, char **argv)
+{
+    WindowBackend backend = WINDOW_EGL_PBUFFER;
+    bool cpuOnly = false;
+    const char *jsonLocation = NULL;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--surfaceless") == 0)
+            backend = WINDOW_EGL_SURFACELESS;
+        else if (strcmp(argv[i], "--window") == 0)
+            backend = WINDOW_GLFW;
+        else if (strcmp(argv[i], "--cpu-only") == 0)
+            cpuOnly = true;
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonLocation = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            options.filter = argv[++i];
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            options.sampleCount = std::max(3, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = atoi(argv[++i]);
+    }
+
+    JobSystem jobs;
+    jobs.Initialise(threadCount, false);
+
+    printf("transform kernel %s | %u threads | %zu samples per case \n", GetTransformKernelName(), jobs.getThreadCount(), options.sampleCount);
+
+    runCpuBenchmarks(jobs);
+    runGroup(viewSweepNames, [&]() { runViewSweepBenchmarks(); });
+    runGroup(transformUpdateNames, [&]() { runTransformUpdateBenchmarks(); });
+    runGroup(scalingCullNames, [&]() { runCullScalingBenchmarks(); });
+    runGroup(scalingTransformNames, [&]() { runTransformScalingBenchmarks(); });
+    runGroup(modelNames, [&]() { runModelBenchmarks(jobs); });
+    runGroup(terrainSelectNames, [&]() { runTerrainBenchmarks(jobs); });
+    runGroup(particleUpdateNames, [&]() { runParticleBenchmarks(jobs); });
+
+#ifdef ENABLE_DEBUG_DRAW
+    runGroup(debugLineNames, [&]() { runDebugDrawBenchmarks(jobs); });
+#endif
+
+    const char *backendName = "none";
+
+    // the window has to outlive every GL object the cases create
+    Window window(64, 64);
+
+    if (!cpuOnly)
+    {
+        if (window.Initialise(backend) == 0)
+        {
+            backendName = backend == WINDOW_GLFW ? "glfw" : (backend == WINDOW_EGL_PBUFFER ? "egl-pbuffer" : "egl-surfaceless");
+
+            printf("renderer %s \n", (const char*)glGetString(GL_RENDERER));
+            window.setSwapInterval(0);
+
+            runGlBenchmarks(jobs);
+        }
+        else
+        {
+            printf("No GL context, only the CPU cases were run \n");
+        }
+    }
+
+    if (jsonLocation && !writeJson(jsonLocation, backendName))
+    {
+        jobs.Shutdown();
+        exit(EXIT_FAILURE);
+    }
+
+    jobs.Shutdown();
+
+    exit(EXIT_SUCCESS);
+}
\ No newline at end of file
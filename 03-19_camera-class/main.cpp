@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <stdio.h>
 #include <stdlib.h>
@@ -15,21 +18,193 @@
 #include "headers/Mesh.h"
 #include "headers/Shader.h"
 #include "headers/Camera.h"
+#include "headers/MultiViewRenderer.h"
+#include "headers/InputRecorder.h"
+#include "headers/InputPlayer.h"
+#include "headers/FramePacer.h"
+#include "headers/RenderThread.h"
+#include "headers/TransformHierarchy.h"
+#include "headers/EntityStore.h"
+#include "headers/JobSystem.h"
+#include "headers/FrameArena.h"
+#include "headers/HeapTracker.h"
+#include "headers/Profiler.h"
+#include "headers/RenderStats.h"
+#include "headers/TextureManager.h"
+#include "headers/ClusteredLighting.h"
+#include "headers/DeferredRenderer.h"
+#include "headers/ModelLoader.h"
+#include "headers/WorldStreamer.h"
+#include "headers/Terrain.h"
+#include "headers/ParticleSystem.h"
+#include "headers/DebugDraw.h"
 
 const float toRadians = 3.14159265f / 180.0f;
 
-Window mainWindow;
+Window mainWindow(800, 600);
 std::vector<Mesh*> meshList;
 std::vector<Shader> shaderList;
+Shader *multiViewShader = NULL;
+Shader *depthShader = NULL;
+Shader *geometryShader = NULL;
+Shader *deferredLightingShader = NULL;
+Shader *terrainShader = NULL;
+Shader *particleShader = NULL;
+EntityStore entities;
+TransformHierarchy transforms;
+MultiViewRenderer renderer;
 Camera camera;
 
+InputRecorder recorder;
+InputPlayer player;
+FramePacer pacer;
+RenderThread renderThread;
+JobSystem jobs;
+FrameArena frameArena;
+TextureManager textures;
+TextureHandle sceneTexture = TextureManager::INVALID_TEXTURE;
+ClusteredLighting lighting;
+std::vector<PointLight> lights;
+std::vector<glm::vec3> lightAnchors; // where each light bobs around
+DeferredRenderer deferred;
+bool deferredPath = false;
+WorldStreamer world;
+std::vector<RenderObject> frameObjects; // the snapshot's objects plus the resident world chunks
+Terrain terrain;
+ParticleSystem particles;
+double lastParticleTime = -1.0; // input time of the last frame the particles were stepped to
+
+enum ReplayMode { REPLAY_NONE, REPLAY_INPUT, REPLAY_CAMERA, REPLAY_FLYTHROUGH };
+
+const GLfloat replayTimestep = 1.0f / 60.0f; // simulation step used by every replay mode
+
+const GLfloat flythroughDuration = 10.0f; // seconds of simulated time for one lap of the scripted path
+const size_t flythroughWaypoints = 16;
+
+const size_t frameArenaSize = 4 * 1024 * 1024; // transient memory per frame in flight
+const long heapWarmupFrames = 120; // containers reach their steady state size within this many frames
+const size_t unboundedFrameTimes = 1 << 20; // frame times kept by a run of unknown length, 8 MB
+
+const size_t defaultTextureBudget = 256; // MB of mip levels kept on the GPU
+const size_t textureUploadBudget = 4 * 1024 * 1024; // bytes streamed to the GPU per frame
+
+const GLfloat worldChunkSize = 16.0f; // units along each side of a --world chunk
+const GLfloat worldLoadRadius = 112.0f; // a little past the far plane
+const size_t defaultWorldBudget = 64; // MB of chunks kept on the GPU
+const size_t worldUploadBudget = 2 * 1024 * 1024; // bytes of chunks uploaded per frame
+const GLfloat worldFlythroughRadius = 120.0f; // the --flythrough lap over a --world
+
+const GLfloat terrainSpacing = 1.0f; // units between --terrain samples
+const GLfloat terrainHeight = 160.0f; // from the lowest sample to the highest
+const GLfloat terrainBase = -1.0f; // just under the pyramids, the terrain flattens out around the origin
+const GLfloat terrainLodDistance = 128.0f; // level 0 range, each level above doubles it
+const GLfloat terrainViewDistance = 3000.0f; // far plane with --terrain
+const size_t terrainUploadBudget = 1024 * 1024; // bytes of heightmap tiles sent to the GPU per frame
+
+const glm::vec3 fountainPosition(0.0f, -0.75f, -4.0f); // --particles spray up behind the pyramids
+const GLfloat fountainSpeed = 3.5f;
+const GLfloat particleLifetime = 3.0f; // seconds at most, the mean is three quarters of it
+const GLfloat particleSize = 0.02f;
+const GLfloat particleGround = -1.0f;
+
+const glm::vec3 modelPosition(1.5f, 0.25f, -2.5f); // --model sits next to the pyramids
+const GLfloat modelSize = 0.5f; // radius the --model is scaled to
+
+const glm::vec3 lightFieldCentre(0.0f, 0.25f, -2.5f);
+const glm::vec3 lightFieldExtent(6.0f, 1.5f, 6.0f); // half size of the box the --lights are scattered in
+
+const double statsLogInterval = 1.0; // seconds between --stats log lines
+const double statsOverlayInterval = 0.25; // seconds between --stats-overlay title updates
+
 GLfloat deltaTime = 0.0f;
 GLfloat lastTime = 0.0f;
 
 static const char* vShader = "Shaders/shader.vert"; // vertex shader
 static const char* fShader = "Shaders/shader.frag"; // fragment shader
+static const char* fClusteredShader = "Shaders/clustered.frag"; // fragment shader for --lights
+static const char* vMultiViewShader = "Shaders/multiview.vert"; // vertex shader selecting the viewport per instance
+static const char* fDepthShader = "Shaders/depth.frag"; // --deferred depth pre-pass
+static const char* fGeometryShader = "Shaders/gbuffer.frag"; // --deferred G-buffer fill
+static const char* vFullscreenShader = "Shaders/fullscreen.vert"; // --deferred lighting pass
+static const char* fDeferredShader = "Shaders/deferred.frag";
+static const char* vTerrainShader = "Shaders/terrain.vert"; // --terrain
+static const char* fTerrainShader = "Shaders/terrain.frag";
+static const char* vParticleShader = "Shaders/particle.vert"; // --particles
+static const char* fParticleShader = "Shaders/particle.frag";
+
+#ifdef ENABLE_DEBUG_DRAW
+static const char* vDebugShader = "Shaders/debug.vert"; // --debug-draw
+static const char* fDebugShader = "Shaders/debug.frag";
+
+Shader *debugShader = NULL;
+bool debugDrawing = false;
+#endif
+
+const uint32_t renderable = COMPONENT_TRANSFORM | COMPONENT_MESH | COMPONENT_MATERIAL | COMPONENT_BOUNDS;
+
+Entity AddRenderable(Mesh *mesh, Shader *shader, uint32_t parent, glm::vec3 translation, GLfloat angle, glm::vec3 scale)
+{
+    glm::quat rotation = glm::angleAxis(angle * toRadians, glm::normalize(glm::vec3(1.0f, 1.0f, 1.0f)));
+
+    uint32_t node = transforms.addNode(parent, translation, rotation, scale);
+
+    if (node == TransformHierarchy::INVALID_NODE)
+        exit(EXIT_FAILURE);
+
+    Entity entity = entities.create(renderable);
+
+    entities.transformNode(entity) = node;
+    entities.mesh(entity) = mesh;
+    entities.material(entity) = shader;
+    entities.bounds(entity).localRadius = 1.0f; // the pyramid fits in a unit sphere around its origin
+
+    return entity;
+}
+
+void UpdateTransforms()
+{
+    PROFILE_SCOPE("UpdateTransforms");
+
+    // world matrices are only recomputed for dirty subtrees
+    if (transforms.update() == 0)
+        return;
+
+    entities.forEach(COMPONENT_TRANSFORM | COMPONENT_BOUNDS, [](Archetype &archetype) {
+        for (size_t i = 0; i < archetype.size(); i++)
+        {
+            const glm::mat4 &world = transforms.getWorldMatrix(archetype.transformNodes[i]);
+
+            GLfloat scale = fmax(glm::length(glm::vec3(world[0])), fmax(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+
+            archetype.worldMatrices[i] = world;
+            archetype.bounds[i].center = glm::vec3(world[3]);
+            archetype.bounds[i].radius = archetype.bounds[i].localRadius * scale;
+        }
+    });
+}
+
+void GatherRenderObjects(std::vector<RenderObject> &objects)
+{
+    PROFILE_SCOPE("GatherRenderObjects");
+
+    objects.clear();
+
+    entities.forEach(renderable, [&](Archetype &archetype) {
+        for (size_t i = 0; i < archetype.size(); i++)
+        {
+            RenderObject object;
+            object.mesh = archetype.meshes[i];
+            object.shader = archetype.materials[i];
+            object.model = archetype.worldMatrices[i];
+            object.center = archetype.bounds[i].center;
+            object.radius = archetype.bounds[i].radius;
+
+            objects.push_back(object);
+        }
+    });
+}
 
-void CreateObjects()
+void CreateObjects(const char *modelLocation)
 {
     unsigned int indices[] = {
         0, 3, 1,
@@ -50,81 +225,914 @@ void CreateObjects()
 
     obj0->CreateMesh(vertices, indices, 12, 12);
     meshList.push_back(obj0); // add to the end of list of meshes
+
+    AddRenderable(meshList[0], &shaderList[0], TransformHierarchy::NO_PARENT, glm::vec3(0.0f, 0.0f, -2.5f), 45.0f, glm::vec3(0.4f, 0.4f, 0.4f));
+    AddRenderable(meshList[0], &shaderList[0], TransformHierarchy::NO_PARENT, glm::vec3(0.0f, 0.5f, -2.5f), 90.0f, glm::vec3(0.4f, 0.4f, 0.4f));
+
+    if (!modelLocation)
+        return;
+
+    ModelLoader loader;
+    ModelData model;
+
+    loader.setJobSystem(&jobs);
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!loader.load(modelLocation, model))
+        exit(EXIT_FAILURE);
+
+    printf("Loaded %s: %zu vertices, %zu triangles in %.1f ms (dedup %.2f) \n", modelLocation, model.getVertexCount(),
+        model.indices.size() / 3, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), loader.getLastDedupRatio());
+
+    Mesh *modelMesh = new Mesh();
+
+    modelMesh->CreateMesh(model.vertices.data(), model.indices.data(), model.vertices.size(), model.indices.size(), ModelData::FLOATS_PER_VERTEX);
+    meshList.push_back(modelMesh);
+
+    // scaled to a fixed size whatever units the file was authored in, centred on modelPosition
+    GLfloat scale = model.boundsRadius > 0.0f ? modelSize / model.boundsRadius : 1.0f;
+
+    Entity entity = AddRenderable(modelMesh, &shaderList[0], TransformHierarchy::NO_PARENT, modelPosition - model.boundsCentre * scale, 0.0f, glm::vec3(scale, scale, scale));
+    entities.bounds(entity).localRadius = glm::length(model.boundsCentre) + model.boundsRadius;
 }
 
-void CreateShaders()
+void CreateShaders(bool clustered)
 {
+    const char *fragment = clustered ? fClusteredShader : fShader;
+
     Shader *shader0 = new Shader();
 
-    shader0->CreateFromFiles(vShader, fShader);
+    shader0->CreateFromFiles(vShader, fragment);
     shaderList.push_back(*shader0);
+
+    if (MultiViewRenderer::instancingSupported())
+    {
+        multiViewShader = new Shader();
+        multiViewShader->CreateFromFiles(vMultiViewShader, fragment);
+    }
+
+    if (deferredPath)
+    {
+        depthShader = new Shader();
+        depthShader->CreateFromFiles(vShader, fDepthShader);
+
+        geometryShader = new Shader();
+        geometryShader->CreateFromFiles(vShader, fGeometryShader);
+
+        deferredLightingShader = new Shader();
+        deferredLightingShader->CreateFromFiles(vFullscreenShader, fDeferredShader);
+    }
+}
+
+void CreateLights(size_t count)
+{
+    // fixed seed, so every run and every build lights the scene the same way
+    srand(1);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        glm::vec3 unit((GLfloat)rand() / RAND_MAX, (GLfloat)rand() / RAND_MAX, (GLfloat)rand() / RAND_MAX);
+
+        PointLight light;
+        light.position = lightFieldCentre + (unit * 2.0f - 1.0f) * lightFieldExtent;
+        light.radius = 0.5f + 1.0f * rand() / RAND_MAX;
+        light.colour = glm::vec3((GLfloat)rand() / RAND_MAX, (GLfloat)rand() / RAND_MAX, (GLfloat)rand() / RAND_MAX);
+        light.intensity = 4.0f / sqrt((GLfloat)count); // keeps the total brightness roughly constant
+
+        lights.push_back(light);
+        lightAnchors.push_back(light.position);
+    }
+}
+
+// smoothly interpolated hashes of the lattice corners, 0 to 1
+GLfloat ValueNoise(GLfloat x, GLfloat z)
+{
+    int x0 = (int)floor(x), z0 = (int)floor(z);
+    GLfloat fx = x - x0, fz = z - z0;
+
+    GLfloat corners[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t hash = (uint32_t)(x0 + (i & 1)) * 73856093u ^ (uint32_t)(z0 + (i >> 1)) * 19349663u;
+        hash = (hash ^ (hash >> 13)) * 0x5bd1e995u;
+        corners[i] = (hash ^ (hash >> 15)) / 4294967295.0f;
+    }
+
+    fx = fx * fx * (3.0f - 2.0f * fx);
+    fz = fz * fz * (3.0f - 2.0f * fz);
+
+    return (corners[0] * (1.0f - fx) + corners[1] * fx) * (1.0f - fz) + (corners[2] * (1.0f - fx) + corners[3] * fx) * fz;
+}
+
+// a few octaves of noise, flattened around the origin so the pyramids stay clear
+GLfloat TerrainHeight(GLfloat x, GLfloat z)
+{
+    GLfloat height = 0.0f, amplitude = 0.5f, frequency = 1.0f / 512.0f;
+
+    for (int octave = 0; octave < 7; octave++)
+    {
+        height += ValueNoise(x * frequency, z * frequency) * amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    GLfloat fromOrigin = sqrt(x * x + z * z);
+    GLfloat flatten = glm::clamp((fromOrigin - 16.0f) / 240.0f, 0.0f, 1.0f);
+
+    return height * flatten * flatten;
+}
+
+// a flat heightmap on the GPU, then every tile generated on the job system & streamed in over the first frames
+bool CreateTerrain(int size)
+{
+    terrainShader = new Shader();
+    terrainShader->CreateFromFiles(vTerrainShader, fTerrainShader);
+
+    if (!terrain.createHeightmap(size, terrainSpacing, terrainHeight, terrainBase, terrainLodDistance))
+        return false;
+
+    if (!terrain.Initialise(terrainShader, terrainUploadBudget))
+        return false;
+
+    int tilesAcross = terrain.getTilesAcross();
+    GLfloat halfExtent = size * terrainSpacing * 0.5f;
+
+    jobs.parallelFor(tilesAcross * tilesAcross, 1, [&](size_t begin, size_t end) {
+        std::vector<uint16_t> tile(Terrain::TILE_SIZE * Terrain::TILE_SIZE);
+
+        for (size_t t = begin; t < end; t++)
+        {
+            int tileX = t % tilesAcross, tileZ = t / tilesAcross;
+
+            for (int row = 0; row < Terrain::TILE_SIZE; row++)
+            {
+                for (int column = 0; column < Terrain::TILE_SIZE; column++)
+                {
+                    GLfloat x = (tileX * Terrain::TILE_SIZE + column) * terrainSpacing - halfExtent;
+                    GLfloat z = (tileZ * Terrain::TILE_SIZE + row) * terrainSpacing - halfExtent;
+
+                    tile[row * Terrain::TILE_SIZE + column] = (uint16_t)(TerrainHeight(x, z) * 65535.0f + 0.5f);
+                }
+            }
+
+            terrain.updateTile(tileX, tileZ, tile.data());
+        }
+    });
+
+    return true;
+}
+
+// a fountain emitting as fast as particles die, so about count are alive once it has filled
+bool CreateParticles(size_t count)
+{
+    particleShader = new Shader();
+    particleShader->CreateFromFiles(vParticleShader, fParticleShader);
+
+    // a quarter of headroom, for the rate & lifetimes to wander around the mean
+    if (!particles.reserve(count + count / 4) || !particles.Initialise(particleShader, particleSize))
+        return false;
+
+    ParticleEmitter fountain;
+    fountain.position = fountainPosition;
+    fountain.radius = 0.05f;
+    fountain.velocity = glm::vec3(0.0f, fountainSpeed, 0.0f);
+    fountain.spread = 0.8f;
+    fountain.lifetime = particleLifetime;
+    fountain.rate = count / (0.75f * particleLifetime);
+
+    particles.setJobSystem(&jobs);
+    particles.setEmitter(fountain);
+    particles.setForces(-4.0f, 0.2f, particleGround, 0.4f);
+
+    return true;
+}
+
+void AnimateLights(GLfloat time)
+{
+    PROFILE_SCOPE("AnimateLights");
+
+    for (size_t i = 0; i < lights.size(); i++)
+        lights[i].position.y = lightAnchors[i].y + 0.25f * sin(time * 2.0f + i);
+}
+
+void CreateFlythrough(std::vector<glm::vec3> &positions, std::vector<glm::quat> &orientations, bool overWorld)
+{
+    // one lap around the pyramids, rising & dipping, always facing the middle;
+    // over a streamed world a wide lap instead, looking where it goes, so chunks keep coming & going
+    glm::vec3 target(0.0f, 0.25f, -2.5f);
+
+    for (size_t i = 0; i <= flythroughWaypoints; i++)
+    {
+        GLfloat angle = 360.0f * toRadians * i / flythroughWaypoints;
+
+        glm::vec3 position = target + glm::vec3(3.0f * cos(angle), sin(2.0f * angle), 3.0f * sin(angle));
+        glm::vec3 direction = glm::normalize(target - position);
+
+        if (overWorld)
+        {
+            position = glm::vec3(worldFlythroughRadius * cos(angle), 1.0f + sin(2.0f * angle), worldFlythroughRadius * sin(angle));
+            direction = glm::normalize(glm::vec3(-sin(angle), 0.0f, cos(angle)));
+        }
+
+        // yaw about world up, then pitch about the local right axis, as Camera does
+        GLfloat yaw = atan2(direction.z, direction.x);
+        GLfloat pitch = asin(direction.y);
+
+        positions.push_back(position);
+        orientations.push_back(glm::angleAxis(-yaw, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(pitch, glm::vec3(0.0f, 0.0f, 1.0f)));
+    }
+}
+
+void RequestTextures(const FrameSnapshot &snapshot)
+{
+    if (sceneTexture == TextureManager::INVALID_TEXTURE)
+        return;
+
+    GLfloat bufferHeight = mainWindow.getBufferHeight();
+    GLfloat largest = 0.0f;
+
+    // every renderable shares the scene texture, so its largest footprint on screen picks the mip level
+    for (size_t v = 0; v < snapshot.views.size(); v++)
+    {
+        const glm::mat4 &view = snapshot.views[v].view;
+        GLfloat focalLength = snapshot.views[v].projection[1][1];
+
+        for (size_t i = 0; i < snapshot.objects.size(); i++)
+        {
+            const RenderObject &object = snapshot.objects[i];
+            GLfloat distance = -(view * glm::vec4(object.center, 1.0f)).z;
+
+            if (distance + object.radius <= 0.0f)
+                continue;
+
+            GLfloat pixels = object.radius * focalLength * bufferHeight / fmax(distance, 0.1f);
+            largest = fmax(largest, pixels);
+        }
+    }
+
+    textures.requestScreenSize(sceneTexture, largest);
+}
+
+#ifdef ENABLE_DEBUG_DRAW
+// what culling works with: every object's bounding sphere, drawn on the job system, the lights &
+// in split screen each view's frustum over the top, so the other views show where it reaches
+void DrawDebugPrimitives(const FrameSnapshot &snapshot, const std::vector<RenderObject> &objects)
+{
+    PROFILE_SCOPE("DrawDebugPrimitives");
+
+    jobs.parallelFor(objects.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            DEBUG_DRAW_SPHERE(objects[i].center, objects[i].radius, glm::vec4(0.2f, 1.0f, 0.4f, 0.5f));
+    });
+
+    for (size_t i = 0; i < snapshot.lights.size(); i++)
+        DEBUG_DRAW_SPHERE(snapshot.lights[i].position, 0.05f, glm::vec4(snapshot.lights[i].colour, 1.0f));
+
+    if (snapshot.views.size() < 2)
+        return;
+
+    for (size_t v = 0; v < snapshot.views.size(); v++)
+    {
+        glm::vec4 colour(v & 1 ? 1.0f : 0.3f, v & 2 ? 1.0f : 0.3f, 1.0f, 1.0f);
+        DEBUG_DRAW_FRUSTUM(snapshot.views[v].projection * snapshot.views[v].view, colour, DEBUG_OVERLAY);
+    }
+}
+#endif
+
+// with a render thread each thread counts its own heap allocations: the main thread around its
+// frame, the render thread around every RenderFrame it runs
+std::atomic<size_t> renderHeapAllocations(0);
+
+void RenderFrame(const FrameSnapshot &snapshot);
+
+void RenderThreadFrame(const FrameSnapshot &snapshot)
+{
+    size_t heapAllocations = GetThreadHeapAllocationCount();
+    bool decoding = textures.isDecoding() || world.isStreaming();
+
+    RenderFrame(snapshot);
+
+    heapAllocations = GetThreadHeapAllocationCount() - heapAllocations;
+    decoding = decoding || textures.isDecoding() || world.isStreaming();
+
+    if (snapshot.frameIndex >= heapWarmupFrames && heapAllocations > 0 && !decoding)
+    {
+        printf("Render frame %ld made %zu heap allocations \n", snapshot.frameIndex, heapAllocations);
+        renderHeapAllocations.fetch_add(heapAllocations, std::memory_order_relaxed);
+    }
+}
+
+void RenderFrame(const FrameSnapshot &snapshot)
+{
+    PROFILE_SCOPE("RenderFrame");
+
+    // keep at most framesInFlight frames queued on the GPU
+    pacer.beginFrame();
+
+    // the fence wait above retired the frame that last used this arena region
+    frameArena.beginFrame();
+
+    // streams the mip levels this frame's views ask for, within the upload budget
+    RequestTextures(snapshot);
+    textures.update();
+    textures.bind(sceneTexture, 0);
+
+    // heightmap tiles changed since the last frame, within the upload budget
+    terrain.update();
+
+    // particles step by the input time between frames, so a render thread sees the same motion
+    if (particles.isEnabled())
+    {
+        double step = lastParticleTime >= 0.0 ? std::min(snapshot.inputTime - lastParticleTime, 0.1) : 0.0;
+        lastParticleTime = snapshot.inputTime;
+
+        particles.update(step);
+        particles.upload();
+    }
+
+    // chunks around the player's view, drawn along with the scene
+    const std::vector<RenderObject> *objects = &snapshot.objects;
+
+    if (world.isEnabled())
+    {
+        world.update(snapshot.views[0].view);
+
+        frameObjects = snapshot.objects;
+        world.appendRenderObjects(frameObjects);
+        objects = &frameObjects;
+    }
+
+    // lights are binned against the player's view, split screen views shade with the same clusters
+    if (!snapshot.lights.empty() || deferredPath)
+    {
+        lighting.bin(snapshot.lights, snapshot.views[0].view, snapshot.views[0].projection);
+        lighting.upload();
+    }
+
+    if (!snapshot.lights.empty() && !deferredPath)
+    {
+        lighting.bind(&shaderList[0], 1);
+
+        if (multiViewShader)
+            lighting.bind(multiViewShader, 1);
+    }
+
+    // clear window
+    {
+        PROFILE_GPU_SCOPE("clear");
+
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // bitwise OR - clear both color and depth buffer
+    }
+
+    for (size_t v = 0; v < snapshot.views.size(); v++)
+        renderer.setViewMatrices(v, snapshot.views[v].view, snapshot.views[v].projection);
+
+    // cull once for every view, then draw each view's list
+    renderer.cull(*objects);
+
+    if (deferredPath)
+        deferred.render(renderer, *objects, snapshot.views, lighting);
+    else
+        renderer.render(*objects);
+
+    // each view selects its own terrain nodes, drawn after the scene, then the particles blend over both
+    if (terrain.isEnabled() || particles.isEnabled())
+    {
+        for (size_t v = 0; v < snapshot.views.size(); v++)
+        {
+            const View &view = snapshot.views[v];
+
+            glViewport(view.x, view.y, view.width, view.height);
+            terrain.render(view.view, view.projection);
+            particles.render(view.view, view.projection, view.height);
+        }
+    }
+
+#ifdef ENABLE_DEBUG_DRAW
+    // every thread's primitives go up as one buffer, then two draws per view
+    if (debugDrawing)
+    {
+        DrawDebugPrimitives(snapshot, *objects);
+        debugDraw.upload();
+
+        for (size_t v = 0; v < snapshot.views.size(); v++)
+        {
+            const View &view = snapshot.views[v];
+
+            glViewport(view.x, view.y, view.width, view.height);
+            debugDraw.render(view.view, view.projection);
+        }
+    }
+#endif
+
+    mainWindow.swapBuffers();
+
+    pacer.endFrame();
+
+    renderStats.endFrame();
+
+#ifdef ENABLE_PROFILER
+    profiler.endFrame();
+#endif
+}
+
+void PrintFrameTimes(std::vector<double> &frameTimes)
+{
+    if (frameTimes.empty())
+        return;
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    double total = 0.0;
+
+    for (size_t i = 0; i < frameTimes.size(); i++)
+        total += frameTimes[i];
+
+    size_t last = frameTimes.size() - 1;
+
+    // a spike is a frame over twice the median, the hitches streaming & uploads cause
+    size_t spikes = frameTimes.end() - std::upper_bound(frameTimes.begin(), frameTimes.end(), 2.0 * frameTimes[last / 2]);
+
+    printf("frames %zu | mean %.3f ms | p50 %.3f ms | p95 %.3f ms | p99 %.3f ms | max %.3f ms | spikes %zu \n",
+        frameTimes.size(), 1000.0 * total / frameTimes.size(),
+        1000.0 * frameTimes[last / 2], 1000.0 * frameTimes[last * 95 / 100],
+        1000.0 * frameTimes[last * 99 / 100], 1000.0 * frameTimes[last], spikes);
 }
 
-int main()
+int main(int argc, char **argv)
 {
-    mainWindow = Window(800, 600);
-    mainWindow.Initialise();
+    std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
+
+    bool splitScreen = false;
+    bool useRenderThread = false;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    bool pinThreads = false;
+    WindowBackend backend = WINDOW_GLFW;
+    long frameLimit = 0;
+    bool pacingChosen = false;
+    PacingMode pacingMode = PACING_VSYNC;
+    double frameRateCap = 0.0;
+    int framesInFlight = 2;
+    ReplayMode replayMode = REPLAY_NONE;
+    const char *recordLocation = NULL;
+    const char *replayLocation = NULL;
+    const char *traceLocation = NULL;
+    const char *textureLocation = NULL;
+    size_t textureBudget = defaultTextureBudget;
+    size_t lightCount = 0;
+    const char *modelLocation = NULL;
+    int worldChunks = 0;
+    size_t worldBudget = defaultWorldBudget;
+    int terrainSize = 0;
+    size_t particleCount = 0;
+    bool debugRequested = false;
+    bool statsLog = false;
+    bool statsOverlay = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--split") == 0)
+            splitScreen = true;
+        else if (strcmp(argv[i], "--render-thread") == 0)
+            useRenderThread = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pin-threads") == 0)
+            pinThreads = true;
+        else if (strcmp(argv[i], "--headless") == 0)
+            backend = WINDOW_EGL_PBUFFER;
+        else if (strcmp(argv[i], "--surfaceless") == 0)
+            backend = WINDOW_EGL_SURFACELESS;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frameLimit = atol(argv[++i]);
+        else if (strcmp(argv[i], "--vsync") == 0)
+        {
+            pacingChosen = true;
+            pacingMode = PACING_VSYNC;
+        }
+        else if (strcmp(argv[i], "--uncapped") == 0)
+        {
+            pacingChosen = true;
+            pacingMode = PACING_UNCAPPED;
+        }
+        else if (strcmp(argv[i], "--cap") == 0 && i + 1 < argc)
+        {
+            pacingChosen = true;
+            pacingMode = PACING_CAPPED;
+            frameRateCap = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc)
+            framesInFlight = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordLocation = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replayMode = REPLAY_INPUT;
+            replayLocation = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+            statsLog = true;
+        else if (strcmp(argv[i], "--stats-overlay") == 0)
+            statsOverlay = true;
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            traceLocation = argv[++i];
+        else if (strcmp(argv[i], "--replay-camera") == 0 && i + 1 < argc)
+        {
+            replayMode = REPLAY_CAMERA;
+            replayLocation = argv[++i];
+        }
+        else if (strcmp(argv[i], "--texture") == 0 && i + 1 < argc)
+            textureLocation = argv[++i];
+        else if (strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc)
+            textureBudget = atol(argv[++i]);
+        else if (strcmp(argv[i], "--deferred") == 0)
+            deferredPath = true;
+        else if (strcmp(argv[i], "--lights") == 0 && i + 1 < argc)
+            lightCount = atol(argv[++i]);
+        else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc)
+            modelLocation = argv[++i];
+        else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc)
+            worldChunks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--world-budget") == 0 && i + 1 < argc)
+            worldBudget = atol(argv[++i]);
+        else if (strcmp(argv[i], "--terrain") == 0 && i + 1 < argc)
+            terrainSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc)
+            particleCount = atol(argv[++i]);
+        else if (strcmp(argv[i], "--debug-draw") == 0)
+            debugRequested = true;
+        else if (strcmp(argv[i], "--flythrough") == 0)
+            replayMode = REPLAY_FLYTHROUGH;
+    }
+
+    // this thread becomes worker 0, the rest are started here
+    jobs.Initialise(threadCount, pinThreads);
+
+#ifdef ENABLE_PROFILER
+    profiler.setThreadName("main");
+#else
+    if (traceLocation)
+        printf("Built without -DENABLE_PROFILER, no trace will be written \n");
+#endif
+
+    if (replayLocation && !player.load(replayLocation))
+        exit(EXIT_FAILURE);
+
+    if (recordLocation && !recorder.beginRecording(recordLocation))
+        exit(EXIT_FAILURE);
 
-    CreateObjects();
-    CreateShaders();
+    if (mainWindow.Initialise(backend) != 0)
+        exit(EXIT_FAILURE);
+
+    // nothing closes an offscreen window, so a headless run without a recording renders a fixed number of frames
+    if (mainWindow.isHeadless() && frameLimit == 0 && replayMode == REPLAY_NONE)
+        frameLimit = 600;
+
+    // windows follow the display by default, offscreen runs go as fast as they can
+    if (!pacingChosen && mainWindow.isHeadless())
+        pacingMode = PACING_UNCAPPED;
+
+    CreateShaders(lightCount > 0);
+    CreateObjects(modelLocation);
+    CreateLights(lightCount);
+
+    if (!lighting.Initialise())
+        exit(EXIT_FAILURE);
+
+    lighting.setJobSystem(&jobs);
+
+    if (deferredPath)
+    {
+        // the lighting pass shades into the offscreen backends' framebuffer, 0 when windowed
+        deferred.setShaders(depthShader, geometryShader, deferredLightingShader);
+        deferred.setOutputFramebuffer(mainWindow.getFramebuffer());
+
+        if (!deferred.Initialise(mainWindow.getBufferWidth(), mainWindow.getBufferHeight()))
+            exit(EXIT_FAILURE);
+    }
+
+    if (!textures.Initialise(&jobs, textureBudget * 1024 * 1024, textureUploadBudget))
+        exit(EXIT_FAILURE);
+
+    // decoded on the workers, the pyramids stay white until the first mip level is up
+    if (textureLocation)
+        sceneTexture = textures.load(textureLocation);
+
+    if (worldChunks > 0 && !world.Initialise(&jobs, worldChunks, worldChunkSize, worldLoadRadius, worldBudget * 1024 * 1024, worldUploadBudget))
+        exit(EXIT_FAILURE);
+
+    // the G-buffer has no place for it, the terrain is forward shaded only
+    if (terrainSize > 0 && deferredPath)
+        printf("--terrain is not drawn with --deferred \n");
+    else if (terrainSize > 0 && !CreateTerrain(terrainSize))
+        exit(EXIT_FAILURE);
+
+    // blended over the depth buffer, which the deferred output does not have
+    if (particleCount > 0 && deferredPath)
+        printf("--particles is not drawn with --deferred \n");
+    else if (particleCount > 0 && !CreateParticles(particleCount))
+        exit(EXIT_FAILURE);
+
+#ifdef ENABLE_DEBUG_DRAW
+    if (debugRequested)
+    {
+        debugShader = new Shader();
+        debugShader->CreateFromFiles(vDebugShader, fDebugShader);
+
+        if (!debugDraw.Initialise(debugShader))
+            exit(EXIT_FAILURE);
+
+        debugDraw.setJobSystem(&jobs);
+        debugDrawing = true;
+    }
+#else
+    if (debugRequested)
+        printf("Built without -DENABLE_DEBUG_DRAW, nothing will be drawn \n");
+#endif
 
     camera = Camera();
 
-    GLuint uniformProjection = 0;
-    GLuint uniformModel = 0;
-    GLuint uniformView = 0;
+    std::vector<glm::vec3> flythroughPositions;
+    std::vector<glm::quat> flythroughOrientations;
+
+    if (replayMode == REPLAY_FLYTHROUGH)
+        CreateFlythrough(flythroughPositions, flythroughOrientations, world.isEnabled());
+
+    renderer.setShaders(&shaderList[0], multiViewShader);
+    renderer.setJobSystem(&jobs);
+    renderer.setFrameArena(&frameArena);
+    transforms.setJobSystem(&jobs);
+
+    if (!frameArena.Initialise(frameArenaSize, framesInFlight))
+        exit(EXIT_FAILURE);
+
+    GLsizei bufferWidth = mainWindow.getBufferWidth();
+    GLsizei bufferHeight = mainWindow.getBufferHeight();
+
+    // split screen puts a fixed overview camera next to the player camera
+    GLsizei viewWidth = splitScreen ? bufferWidth / 2 : bufferWidth;
+
+    std::vector<View> viewList;
+    GLfloat farPlane = terrain.isEnabled() ? terrainViewDistance : 100.0f;
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (GLfloat)viewWidth / bufferHeight, 0.1f, farPlane);
+
+    // the snapshot's views carry their viewports too, for the passes drawn outside the renderer
+    int playerView = renderer.addView(0, 0, viewWidth, bufferHeight);
+
+    if (playerView < 0)
+        exit(EXIT_FAILURE);
+
+    viewList.resize(renderer.getViewCount());
+    viewList[playerView].x = 0;
+    viewList[playerView].y = 0;
+    viewList[playerView].width = viewWidth;
+    viewList[playerView].height = bufferHeight;
+    viewList[playerView].projection = projection;
+
+    if (splitScreen)
+    {
+        int overviewView = renderer.addView(viewWidth, 0, bufferWidth - viewWidth, bufferHeight);
+
+        if (overviewView < 0)
+            exit(EXIT_FAILURE);
+
+        viewList.resize(renderer.getViewCount());
+
+        viewList[overviewView].x = viewWidth;
+        viewList[overviewView].y = 0;
+        viewList[overviewView].width = bufferWidth - viewWidth;
+        viewList[overviewView].height = bufferHeight;
+        viewList[overviewView].view = glm::lookAt(glm::vec3(3.0f, 1.5f, 0.0f), glm::vec3(0.0f, 0.0f, -2.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+        viewList[overviewView].projection = projection;
+    }
+
+    // with a render thread the GL context moves there, the main thread keeps input & simulation
+    FrameSnapshot localSnapshot;
+
+    if (useRenderThread)
+    {
+        renderThread.start(&mainWindow, [&]() {
+#ifdef ENABLE_PROFILER
+            profiler.setThreadName("render");
+            profiler.Initialise(true);
+#endif
+            pacer.Initialise(&mainWindow, pacingMode, frameRateCap, framesInFlight);
+        }, RenderThreadFrame);
+    }
+    else
+    {
+#ifdef ENABLE_PROFILER
+        profiler.Initialise(true);
+#endif
+        pacer.Initialise(&mainWindow, pacingMode, frameRateCap, framesInFlight);
+    }
+
+    std::vector<double> frameTimes;
+    bool recordFrameTimes = replayMode != REPLAY_NONE || mainWindow.isHeadless();
+
+    // sized up front & never grown, so recording frame times cannot allocate mid-run;
+    // a run of unknown length keeps the first unboundedFrameTimes
+    size_t frameTimeCount = unboundedFrameTimes;
+
+    if (frameLimit > 0)
+        frameTimeCount = frameLimit;
+    else if (replayMode == REPLAY_INPUT)
+        frameTimeCount = player.getFrameCount();
+    else if (replayMode == REPLAY_CAMERA)
+        frameTimeCount = player.getDuration() / replayTimestep + 1;
+    else if (replayMode == REPLAY_FLYTHROUGH)
+        frameTimeCount = flythroughDuration / replayTimestep + 1;
+
+    if (recordFrameTimes)
+        frameTimes.reserve(frameTimeCount);
+
+    size_t steadyHeapAllocations = 0;
+    GLfloat replayTime = 0.0f;
+    long frameCount = 0;
 
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), 0.1f, 100.0f);
+    double startTime = mainWindow.getTime();
+    lastTime = startTime;
+
+    double lastStatsLog = startTime;
+    double lastStatsOverlay = startTime;
+    char statsLine[256];
+
+    // process launch to the first frame: window, context, shaders, meshes & worker threads
+    double startupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - launchTime).count();
+
+    // without a render thread the whole process is counted, jobs on the workers included; with one
+    // this thread only counts its own & jobs the workers run are not attributed to either thread's frame
+    auto frameHeapAllocations = [&]() { return renderThread.isRunning() ? GetThreadHeapAllocationCount() : GetHeapAllocationCount(); };
 
     while (!mainWindow.getShouldClose())
     {
-        GLfloat now = glfwGetTime();
+        size_t heapAllocations = frameHeapAllocations();
+        bool decoding = textures.isDecoding() || world.isStreaming();
+
+        GLfloat now = mainWindow.getTime();
         deltaTime = now - lastTime;
         lastTime = now;
 
         // get and handle user input events
-        glfwPollEvents();
+        mainWindow.pollEvents();
 
-        camera.keyControl(mainWindow.getKeys(), deltaTime);
-        camera.mouseControl(mainWindow.getXChange(), mainWindow.getYChange());
+        if (replayMode == REPLAY_INPUT)
+        {
+            // recorded input at a fixed timestep, independent of how fast this build renders
+            if (!player.step(replayTimestep))
+                break;
 
-        // clear window
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // bitwise OR - clear both color and depth buffer
+            camera.mouseControl(player.getXChange(), player.getYChange());
+            camera.keyControl(player.getKeys(), replayTimestep);
+        }
+        else if (replayMode == REPLAY_CAMERA)
+        {
+            replayTime += replayTimestep;
+
+            if (!player.applyCameraPose(replayTime, camera))
+                break;
+        }
+        else if (replayMode == REPLAY_FLYTHROUGH)
+        {
+            // the scripted path at a fixed timestep, a repeatable workload without a recording
+            replayTime += replayTimestep;
+
+            if (replayTime > flythroughDuration)
+                break;
+
+            camera.followPath(flythroughPositions.data(), flythroughOrientations.data(), flythroughPositions.size(),
+                replayTime / flythroughDuration * flythroughWaypoints);
+        }
+        else
+        {
+            camera.eventControl(mainWindow.getInputQueue(), deltaTime);
 
-        shaderList[0].UseShader();
-        uniformModel = shaderList[0].GetModelLocation();
-        uniformProjection = shaderList[0].GetProjectionLocation();
-        uniformView = shaderList[0].GetViewLocation();
+            recorder.recordFrame(now, camera.getFrameKeys(), camera.getFrameXChange(), camera.getFrameYChange(), camera);
+        }
 
-        // draw meshList[0]
-        glm::mat4 model = glm::mat4(1.0f); // initialised to identity matrix
-        
-        // order of operations is important
-        model = glm::translate(model, glm::vec3(0.0f, 0.0f, -2.5f));
-        model = glm::rotate(model, 45.0f * toRadians, glm::vec3(1.0f, 1.0f, 1.0f));
-        model = glm::scale(model, glm::vec3(0.4f, 0.4f, 0.4f));
+        if (recordFrameTimes && frameTimes.size() < frameTimes.capacity())
+            frameTimes.push_back(deltaTime);
 
-        glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
+        UpdateTransforms();
+        AnimateLights(replayMode != REPLAY_NONE ? frameCount * replayTimestep : now);
 
-        meshList[0]->RenderMesh();
+        viewList[playerView].view = camera.calculateViewMatrix();
 
-        // draw meshList[1]
-        model = glm::mat4(1.0f);
-        
-        model = glm::translate(model, glm::vec3(0.0f, 0.5f, -2.5f));
-        model = glm::rotate(model, 90.0f * toRadians, glm::vec3(1.0f, 1.0f, 1.0f));
-        model = glm::scale(model, glm::vec3(0.4f, 0.4f, 0.4f));
+        FrameSnapshot &snapshot = renderThread.isRunning() ? renderThread.getWriteSnapshot() : localSnapshot;
+        snapshot.frameIndex = frameCount;
+        snapshot.inputTime = now;
+        snapshot.views = viewList; // copies reuse the slot's storage
+        GatherRenderObjects(snapshot.objects);
+        snapshot.lights = lights;
 
-        glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(camera.calculateViewMatrix()));
-        meshList[0]->RenderMesh();
+        if (renderThread.isRunning())
+            renderThread.publish();
+        else
+            RenderFrame(snapshot);
 
-        glUseProgram(0); // unassigning the shader program
+        // once warmed up a frame should run entirely out of reused storage & the frame arena
+        heapAllocations = frameHeapAllocations() - heapAllocations;
+
+        // texture decodes & chunk loads allocate on the workers, they are not part of the frame
+        decoding = decoding || textures.isDecoding() || world.isStreaming();
+
+        if (frameCount >= heapWarmupFrames && heapAllocations > 0 && !decoding)
+        {
+            printf("Frame %ld made %zu heap allocations \n", frameCount, heapAllocations);
+            steadyHeapAllocations += heapAllocations;
+        }
+
+        // rolling averages of the renderer counters, read without stopping the render thread
+        if (statsLog && now - lastStatsLog >= statsLogInterval)
+        {
+            renderStats.formatSummary(statsLine, sizeof(statsLine));
+            printf("%s \n", statsLine);
+            lastStatsLog = now;
+        }
+
+        if (statsOverlay && now - lastStatsOverlay >= statsOverlayInterval)
+        {
+            renderStats.formatSummary(statsLine, sizeof(statsLine));
+            mainWindow.setTitle(statsLine);
+            lastStatsOverlay = now;
+        }
+
+        if (++frameCount == frameLimit)
+            mainWindow.setShouldClose(true);
+    }
+
+    // hands the context back to this thread
+    renderThread.stop();
+    steadyHeapAllocations += renderHeapAllocations.load();
+
+    if (mainWindow.isHeadless())
+    {
+        // wait for the GPU so the total covers every submitted frame
+        glFinish();
 
-        mainWindow.swapBuffers();
+        double totalTime = mainWindow.getTime() - startTime;
+        printf("rendered %zu frames in %.3f s (%.1f fps) \n", frameTimes.size(), totalTime, frameTimes.size() / totalTime);
+    }
+
+    recorder.endRecording();
+    printf("startup %.1f ms \n", 1000.0 * startupTime);
+    PrintFrameTimes(frameTimes);
+    pacer.printStatistics();
+    renderThread.printStatistics();
+
+    if (statsLog)
+        renderStats.printStatistics();
+
+    if (HeapTrackingEnabled())
+        printf("heap allocations %zu | in steady state frames %zu \n", GetHeapAllocationCount(), steadyHeapAllocations);
+
+    textures.printStatistics();
+    world.printStatistics();
+    terrain.printStatistics();
+    particles.printStatistics();
+
+#ifdef ENABLE_DEBUG_DRAW
+    debugDraw.printStatistics();
+#endif
+
+    if (!lights.empty())
+        printf("lights %zu | cluster assignments %zu | most per cluster %u | dropped %zu \n", lighting.getLightCount(),
+            lighting.getAssignmentCount(), lighting.getMaxLightsPerCluster(), lighting.getDroppedCount());
+
+    deferred.printStatistics();
+
+    printf("frame arena high water %zu KB | heap fallbacks %zu \n", frameArena.getHighWater() / 1024, frameArena.getOverflowCount());
+
+#ifdef ENABLE_PROFILER
+    profiler.printSummary();
+
+    if (traceLocation)
+        profiler.writeChromeTrace(traceLocation);
+
+    profiler.Shutdown();
+#endif
+
+    deferred.Shutdown();
+    lighting.Shutdown();
+    world.Shutdown();
+    terrain.Shutdown();
+    particles.Shutdown();
+
+#ifdef ENABLE_DEBUG_DRAW
+    debugDraw.Shutdown();
+#endif
+
+    textures.Shutdown();
+    jobs.Shutdown();
+
+    // reported rather than asserted so Release runs fail the same way Debug ones do
+    if (steadyHeapAllocations > 0)
+    {
+        printf("Steady state frames made %zu heap allocations \n", steadyHeapAllocations);
+        exit(EXIT_FAILURE);
     }
 
     exit(EXIT_SUCCESS);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <GLFW/glfw3.h>
+
+#include "InputQueue.h"
+
+class Camera
+{
+    public:
+        Camera();
+        Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLfloat startPitch, GLfloat startMoveSpeed, GLfloat startTurnSpeed);
+        
+        void keyControl(bool *keys, GLfloat deltaTime);
+        void mouseControl(GLfloat xChange, GLfloat yChange);
+        void eventControl(InputQueue &queue, GLfloat deltaTime);
+
+        // input applied by the last eventControl, for recording
+        bool* getFrameKeys() { return frameKeys; }
+        GLfloat getFrameXChange() { return frameXChange; }
+        GLfloat getFrameYChange() { return frameYChange; }
+
+        void setSmoothing(GLfloat sharpness) { smoothing = sharpness; }
+        void setPosition(glm::vec3 newPosition) { position = newPosition; }
+        void setOrientation(glm::quat newOrientation);
+        void followPath(const glm::vec3 *positions, const glm::quat *orientations, size_t count, GLfloat t);
+
+        glm::vec3 getPosition() { return position; }
+        glm::vec3 getFront() { return front; }
+        glm::vec3 getRight() { return right; }
+        glm::vec3 getUp() { return up; }
+        glm::quat getOrientation() { return orientation; }
+        GLfloat getYaw() { return yaw; }
+        GLfloat getPitch() { return pitch; }
+
+        glm::mat4 calculateViewMatrix();
+        
+        ~Camera();
+
+    private:
+        // kept first and 16-byte aligned so both quaternions load as single vectors
+        alignas(16) glm::quat orientation;
+        alignas(16) glm::quat targetOrientation;
+
+        glm::vec3 position;
+        glm::vec3 front;
+        glm::vec3 up;
+        glm::vec3 right;
+        glm::vec3 worldUp;
+
+        GLfloat yaw;
+        GLfloat pitch;
+
+        GLfloat moveSpeed;
+        GLfloat turnSpeed;
+
+        GLfloat smoothing; // 0 snaps to the input, higher values settle faster
+        bool orientationDirty; // yaw/pitch changed since the last update
+        bool settling; // orientation has not reached targetOrientation yet
+
+        bool heldKeys[1024]; // key state after the last consumed event
+        bool frameKeys[1024]; // keys down at any point during the last frame
+        GLfloat frameXChange, frameYChange;
+
+        glm::quat eulerToQuat(GLfloat yawDegrees, GLfloat pitchDegrees);
+        void update(GLfloat deltaTime);
+};
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "Shader.h"
+
+struct PointLight
+{
+    glm::vec3 position; // world space
+    GLfloat radius; // no contribution beyond this distance
+    glm::vec3 colour;
+    GLfloat intensity;
+};
+
+// Lights are binned on the CPU into a grid of clusters that covers one view frustum.
+// The grid has CLUSTERS_X x CLUSTERS_Y screen tiles and CLUSTERS_Z exponential depth slices.
+// clustered.frag then loops only over the lights of the cluster its fragment falls in.
+class ClusteredLighting
+{
+    public:
+        static const uint32_t CLUSTERS_X = 16;
+        static const uint32_t CLUSTERS_Y = 9;
+        static const uint32_t CLUSTERS_Z = 24;
+        static const size_t CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+        static const size_t MAX_LIGHT_INDICES = 1 << 22; // assignments beyond this are dropped
+        static const size_t PARALLEL_BIN_THRESHOLD = 1024; // fewer lights are binned on the calling thread
+
+        ClusteredLighting();
+
+        // creates the texture buffers, needs a current GL context
+        bool Initialise();
+        void Shutdown();
+
+        void setJobSystem(JobSystem *jobSystem) { jobs = jobSystem; }
+
+        // pure CPU work: assigns every light to the clusters of the view it touches
+        void bin(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection);
+
+        // GL thread: sends the last binning to the texture buffers
+        void upload();
+
+        // points the program's samplers at units firstUnit to firstUnit + 2 and sets the cluster uniforms
+        void bind(Shader *shader, GLuint firstUnit);
+
+        size_t getLightCount() { return lightCount; }
+        size_t getAssignmentCount() { return indices.size(); }
+        size_t getDroppedCount() { return dropped; }
+        uint32_t getMaxLightsPerCluster();
+
+        ~ClusteredLighting();
+
+    private:
+        // inclusive cluster ranges a light overlaps, empty when z0 > z1
+        struct LightBounds
+        {
+            uint8_t x0, x1, y0, y1, z0, z1;
+        };
+
+        JobSystem *jobs;
+
+        size_t lightCount;
+        const PointLight *lightSource;
+
+        std::vector<glm::vec4> lightData; // two texels per light: position & radius, colour * intensity
+        std::vector<LightBounds> bounds;
+        std::vector<uint32_t> grid; // offset into indices & light count per cluster
+        std::vector<uint32_t> indices;
+        size_t dropped;
+
+        // per depth slice scratch: the lights overlapping it, then its part of indices
+        std::vector<uint32_t> sliceLights[CLUSTERS_Z];
+        std::vector<uint32_t> sliceIndices[CLUSTERS_Z];
+
+        glm::mat4 clusterView;
+        GLfloat xScale, yScale; // projection[0][0] & projection[1][1]
+        GLfloat nearPlane, farPlane;
+        GLfloat sliceScale, sliceBias; // slice = log(depth) * sliceScale + sliceBias
+        GLfloat sliceStarts[CLUSTERS_Z + 1]; // view depth where each slice begins
+
+        GLuint buffers[3], textures[3]; // light data, cluster grid, light indices
+
+        void boundLights(size_t begin, size_t end);
+        void boundLight(size_t i);
+        void fillSlice(uint32_t slice);
+};
\ No newline at end of file
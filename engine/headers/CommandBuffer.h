@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "RenderStats.h"
+
+enum CommandType
+{
+    COMMAND_VIEWPORT,
+    COMMAND_USE_PROGRAM,
+    COMMAND_UNIFORM_MATRIX, // points at a matrix that must outlive the replay
+    COMMAND_UNIFORM_UINT,
+    COMMAND_BIND_MESH,
+    COMMAND_DRAW,
+    COMMAND_DRAW_INSTANCED
+};
+
+// payloads are written unaligned straight after their type byte
+struct ViewportCommand { GLint x, y; GLsizei width, height; };
+struct UniformMatrixCommand { GLint location; const GLfloat *value; };
+struct UniformUintCommand { GLint location; GLuint value; };
+struct BindMeshCommand { GLuint vao, ibo; };
+struct DrawInstancedCommand { GLsizei indexCount, instanceCount; };
+
+// draw submission recorded as a compact byte stream on any thread, then replayed in
+// order on the thread that owns the GL context. recording makes no GL calls at all
+class CommandBuffer
+{
+    public:
+        static const size_t INITIAL_SIZE = 16 * 1024;
+
+        CommandBuffer();
+
+        // keeps the storage, so a buffer recorded every frame stops allocating once warm
+        void reset() { used = 0; commandCount = 0; }
+
+        // recording sits on the per-draw path of every worker, so it stays inline
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+        {
+            ViewportCommand command = { x, y, width, height };
+            write(COMMAND_VIEWPORT, command);
+        }
+
+        void useProgram(GLuint program) { write(COMMAND_USE_PROGRAM, program); }
+
+        void uniformMatrix(GLint location, const GLfloat *value)
+        {
+            UniformMatrixCommand command = { location, value };
+            write(COMMAND_UNIFORM_MATRIX, command);
+        }
+
+        void uniformUint(GLint location, GLuint value)
+        {
+            UniformUintCommand command = { location, value };
+            write(COMMAND_UNIFORM_UINT, command);
+        }
+
+        void bindMesh(GLuint vao, GLuint ibo)
+        {
+            BindMeshCommand command = { vao, ibo };
+            write(COMMAND_BIND_MESH, command);
+        }
+
+        void draw(GLsizei indexCount) { write(COMMAND_DRAW, indexCount); }
+
+        void drawInstanced(GLsizei indexCount, GLsizei instanceCount)
+        {
+            DrawInstancedCommand command = { indexCount, instanceCount };
+            write(COMMAND_DRAW_INSTANCED, command);
+        }
+
+        size_t getCommandCount() const { return commandCount; }
+        size_t getByteCount() const { return used; }
+
+        // state carried from one buffer to the next so redundant binds are skipped across buffers
+        struct ReplayState
+        {
+            GLuint program;
+            GLuint vao;
+
+            ReplayState() : program(0), vao(0) {}
+        };
+
+        void replay(ReplayState &state) const;
+
+        ~CommandBuffer();
+
+    private:
+        std::vector<uint8_t> bytes; // only grows, used marks the end of the recorded commands
+        size_t used;
+        size_t commandCount;
+
+        template <typename T>
+        void write(uint8_t type, const T &payload)
+        {
+            if (used + 1 + sizeof(T) > bytes.size())
+                bytes.resize(bytes.size() * 2 > INITIAL_SIZE ? bytes.size() * 2 : INITIAL_SIZE);
+
+            uint8_t *target = bytes.data() + used;
+            target[0] = type;
+            memcpy(target + 1, &payload, sizeof(T));
+
+            used += 1 + sizeof(T);
+            commandCount++;
+        }
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <math.h>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "Shader.h"
+
+enum DebugDrawMode
+{
+    DEBUG_DEPTH_TESTED, // hidden behind the scene like any other geometry
+    DEBUG_OVERLAY, // over everything, drawn last
+    DEBUG_MODE_COUNT
+};
+
+// built with -DENABLE_DEBUG_DRAW, on in Debug builds; otherwise the class is gone & the macros below compile to nothing
+#ifdef ENABLE_DEBUG_DRAW
+
+struct DebugVertex
+{
+    glm::vec3 position;
+    uint32_t colour; // RGBA8, red in the lowest byte
+};
+
+// one thread's lines since the last upload, written only by that thread; the arrays only ever
+// grow, so a steady frame allocates nothing, & the first counts[mode] vertices are this frame's
+struct DebugDrawThread
+{
+    std::vector<DebugVertex> vertices[DEBUG_MODE_COUNT];
+    size_t counts[DEBUG_MODE_COUNT];
+};
+
+// Immediate-mode lines, boxes, spheres & frusta from any thread, for looking at culling & spatial
+// structures. Each thread appends to its own vertex arrays without locking; once a frame the GL
+// thread merges them into one streamed buffer, depth-tested lines ahead of the overlay, and each
+// view draws the lot with two draw calls.
+class DebugDraw
+{
+    public:
+        static const int SPHERE_SEGMENTS = 32; // lines around each of a sphere's three circles
+
+        DebugDraw();
+
+        // needs a current GL context
+        bool Initialise(Shader *shader);
+        void Shutdown();
+
+        // merges the threads' lines on the job system when set
+        void setJobSystem(JobSystem *jobSystem) { jobs = jobSystem; }
+
+        // from any thread, but never while upload() runs
+        void line(const glm::vec3 &from, const glm::vec3 &to, const glm::vec4 &colour, DebugDrawMode mode = DEBUG_DEPTH_TESTED);
+        void box(const glm::vec3 &minimum, const glm::vec3 &maximum, const glm::vec4 &colour, DebugDrawMode mode = DEBUG_DEPTH_TESTED);
+        void sphere(const glm::vec3 &centre, GLfloat radius, const glm::vec4 &colour, DebugDrawMode mode = DEBUG_DEPTH_TESTED);
+
+        // the volume viewProjection maps onto clip space, the near & far planes included
+        void frustum(const glm::mat4 &viewProjection, const glm::vec4 &colour, DebugDrawMode mode = DEBUG_DEPTH_TESTED);
+
+        // GL thread, once per frame after every thread has finished drawing: streams everything drawn
+        // since the last upload into the vertex buffer & starts collecting the next frame
+        void upload();
+
+        // draws the last upload into the current viewport
+        void render(const glm::mat4 &view, const glm::mat4 &projection);
+
+        // forgets everything drawn since the last upload, for callers without a GL context
+        void clear();
+
+        // of the last upload
+        size_t getLineCount() { return (uploadedCounts[DEBUG_DEPTH_TESTED] + uploadedCounts[DEBUG_OVERLAY]) / 2; }
+
+        size_t getThreadCount();
+
+        void printStatistics();
+
+        ~DebugDraw();
+
+    private:
+        std::mutex threadsMutex;
+        std::vector<DebugDrawThread*> threads;
+
+        JobSystem *jobs;
+
+        glm::vec2 circle[SPHERE_SEGMENTS]; // the unit circle, shared by every sphere
+
+        // first vertex of each thread's arrays in the streamed buffer, depth-tested arrays first
+        std::vector<size_t> offsets;
+
+        Shader *shader;
+        GLuint vertexArray, vertexBuffer;
+        size_t bufferCapacity; // vertices the buffer's storage holds
+        size_t uploadedCounts[DEBUG_MODE_COUNT]; // vertices
+
+        GLuint uniformView, uniformProjection;
+
+        uint64_t frameCount, lineTotal;
+        size_t peakLines;
+
+        DebugDrawThread* registerThread();
+        DebugDrawThread* currentThread();
+
+        // room for count more vertices in the calling thread's array
+        DebugVertex* append(DebugDrawMode mode, size_t count);
+
+        static uint32_t pack(const glm::vec4 &colour);
+};
+
+extern DebugDraw debugDraw;
+
+#define DEBUG_DRAW_LINE(...) debugDraw.line(__VA_ARGS__)
+#define DEBUG_DRAW_BOX(...) debugDraw.box(__VA_ARGS__)
+#define DEBUG_DRAW_SPHERE(...) debugDraw.sphere(__VA_ARGS__)
+#define DEBUG_DRAW_FRUSTUM(...) debugDraw.frustum(__VA_ARGS__)
+#else
+#define DEBUG_DRAW_LINE(...) do {} while (0)
+#define DEBUG_DRAW_BOX(...) do {} while (0)
+#define DEBUG_DRAW_SPHERE(...) do {} while (0)
+#define DEBUG_DRAW_FRUSTUM(...) do {} while (0)
+#endif
\ No newline at end of file
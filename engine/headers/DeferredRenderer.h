@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "ClusteredLighting.h"
+#include "MultiViewRenderer.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "Shader.h"
+
+// The alternative to drawing with each object's own shader: a depth pre-pass, then one G-buffer
+// write per visible pixel, then a full screen pass per view that shades from the G-buffer with the
+// lights of each pixel's cluster.
+//
+// G-buffer, 8 bytes a pixel plus depth:
+//   0  RGBA8  albedo, specular intensity & shininess packed 4:4 in alpha
+//   1  RG16   octahedral normal
+//   -  DEPTH24 from the pre-pass, view position is rebuilt from it
+class DeferredRenderer
+{
+    public:
+        static const GLuint GBUFFER_UNIT = 4; // first texture unit, after the diffuse texture & the cluster buffers
+        static const GLuint CLUSTER_UNIT = 1;
+        static const size_t COLOUR_BYTES = 8; // per pixel over both colour targets
+        static const size_t DEPTH_BYTES = 4;
+        static const int QUERY_FRAMES = 4; // samples passed are read back this many frames later
+
+        DeferredRenderer();
+
+        // depthShader & geometryShader share the scene's vertex shader so the depths match exactly
+        void setShaders(Shader *depthShader, Shader *geometryShader, Shader *lightingShader);
+
+        // where the lit image goes, the window unless set
+        void setOutputFramebuffer(GLuint framebuffer) { outputFramebuffer = framebuffer; }
+
+        // needs a current GL context, the G-buffer matches the output's size
+        bool Initialise(GLsizei width, GLsizei height);
+        void Shutdown();
+
+        // after renderer.cull(objects); the lights must have been binned & uploaded for this frame
+        void render(MultiViewRenderer &renderer, const std::vector<RenderObject> &objects, const std::vector<View> &views, ClusteredLighting &lighting);
+
+        // bytes written & read in the G-buffer by the last measured frame, depth tests not included
+        size_t getFrameBytes() { return frameBytes; }
+        double getMeanFrameBytes() { return measuredFrames > 0 ? (double)totalBytes / measuredFrames : 0.0; }
+
+        void printStatistics();
+
+        ~DeferredRenderer();
+
+    private:
+        Shader *depthShader;
+        Shader *geometryShader;
+        Shader *lightingShader;
+
+        GLsizei width, height;
+        GLuint framebuffer, outputFramebuffer;
+        GLuint targets[3]; // albedo & material, normal, depth
+        GLuint emptyVertexArray; // core profile draws need one, the full screen triangle comes from gl_VertexID
+
+        GLuint uniformInverseViewProjection;
+
+        // fragments that passed in the pre-pass & in the G-buffer pass, and the pixels the lighting pass covered
+        GLuint queries[QUERY_FRAMES][2];
+        size_t lightingPixels[QUERY_FRAMES];
+        bool queryIssued[QUERY_FRAMES];
+        int queryIndex;
+
+        size_t frameBytes;
+        uint64_t totalBytes;
+        size_t measuredFrames;
+
+        void readQueries(int index);
+};
\ No newline at end of file
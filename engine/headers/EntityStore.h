@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "Shader.h"
+
+// stable handle, the generation changes whenever the slot is reused
+struct Entity
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+enum ComponentType : uint32_t
+{
+    COMPONENT_TRANSFORM = 1 << 0, // transform hierarchy node & cached world matrix
+    COMPONENT_MESH = 1 << 1,
+    COMPONENT_MATERIAL = 1 << 2, // shader used to draw the mesh
+    COMPONENT_BOUNDS = 1 << 3 // bounding sphere
+};
+
+struct Bounds
+{
+    glm::vec3 center; // world space
+    GLfloat radius; // world space
+    GLfloat localRadius; // before the transform is applied
+};
+
+// every entity with exactly the same set of components lives in one archetype,
+// each component in its own dense array indexed by row
+struct Archetype
+{
+    uint32_t mask;
+
+    std::vector<Entity> entities; // owner of each row
+
+    std::vector<uint32_t> transformNodes;
+    std::vector<glm::mat4> worldMatrices;
+    std::vector<Mesh*> meshes;
+    std::vector<Shader*> materials;
+    std::vector<Bounds> bounds;
+
+    size_t size() { return entities.size(); }
+};
+
+class EntityStore
+{
+    public:
+        EntityStore();
+
+        Entity create(uint32_t mask);
+        void destroy(Entity entity);
+        bool isAlive(Entity entity);
+
+        // moves the entity to the archetype with the added or removed components
+        void addComponents(Entity entity, uint32_t mask);
+        void removeComponents(Entity entity, uint32_t mask);
+
+        uint32_t getMask(Entity entity) { return archetypes[slots[entity.index].archetype].mask; }
+
+        // component access, only valid while the entity has the component
+        uint32_t& transformNode(Entity entity) { return locate(entity).transformNodes[slots[entity.index].row]; }
+        glm::mat4& worldMatrix(Entity entity) { return locate(entity).worldMatrices[slots[entity.index].row]; }
+        Mesh*& mesh(Entity entity) { return locate(entity).meshes[slots[entity.index].row]; }
+        Shader*& material(Entity entity) { return locate(entity).materials[slots[entity.index].row]; }
+        Bounds& bounds(Entity entity) { return locate(entity).bounds[slots[entity.index].row]; }
+
+        size_t getEntityCount() { return entityCount; }
+
+        // calls system(archetype) for every archetype holding all the required components
+        template <typename System>
+        void forEach(uint32_t required, System system)
+        {
+            for (size_t i = 0; i < archetypes.size(); i++)
+            {
+                if ((archetypes[i].mask & required) == required && archetypes[i].size() > 0)
+                    system(archetypes[i]);
+            }
+        }
+
+        ~EntityStore();
+
+    private:
+        struct Slot
+        {
+            uint32_t generation;
+            uint32_t archetype;
+            uint32_t row;
+            bool alive;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        std::vector<Archetype> archetypes;
+        size_t entityCount;
+
+        Archetype& locate(Entity entity) { return archetypes[slots[entity.index].archetype]; }
+
+        uint32_t findArchetype(uint32_t mask);
+        uint32_t appendRow(uint32_t archetype, Entity entity);
+        void copyRow(Archetype &from, uint32_t fromRow, Archetype &to, uint32_t toRow);
+        void removeRow(uint32_t archetype, uint32_t row);
+        void moveEntity(Entity entity, uint32_t mask);
+};
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// bump allocator for data that only lives for one frame; memory is handed out from one of
+// framesInFlight regions and reclaimed all at once when that region comes round again.
+// nothing allocated here is destructed, so it suits plain data & FrameVector storage
+class FrameArena
+{
+    public:
+        static const int MAX_FRAMES_IN_FLIGHT = 4;
+        static const size_t BLOCK_SIZE = 64 * 1024; // what a thread takes from the shared region at a time
+
+        FrameArena();
+
+        bool Initialise(size_t bytesPerFrame, int framesInFlight);
+
+        // switches to the oldest region, whose previous frame must be finished everywhere
+        void beginFrame();
+
+        // safe from any thread, each thread bumps through its own block of the region
+        void* allocate(size_t size, size_t alignment = 16);
+
+        template <typename T>
+        T* allocateArray(size_t count) { return (T*)allocate(count * sizeof(T), alignof(T)); }
+
+        size_t getBytesUsed() { return regions[current].offset.load(std::memory_order_relaxed); }
+        size_t getHighWater() { return highWater; }
+        size_t getOverflowCount() { return overflowCount; }
+
+        ~FrameArena();
+
+    private:
+        struct Region
+        {
+            char *memory;
+            std::atomic<size_t> offset;
+            std::vector<void*> overflow; // heap fallbacks once the region is full, freed on reuse
+        };
+
+        Region regions[MAX_FRAMES_IN_FLIGHT];
+        int regionCount;
+        int current;
+        size_t capacity;
+
+        std::atomic<uint64_t> generation; // identifies the current frame to the per-thread blocks, read by every allocating thread
+        size_t highWater;
+        size_t overflowCount;
+
+        std::mutex overflowMutex;
+
+        char* claim(size_t size);
+        void* allocateOverflow(size_t size, size_t alignment);
+        void releaseOverflow(Region &region);
+};
+
+// lets standard containers draw from a frame arena; without an arena it uses the heap
+template <typename T>
+struct FrameAllocator
+{
+    typedef T value_type;
+
+    // moving a container moves its arena along with the storage
+    typedef std::true_type propagate_on_container_move_assignment;
+
+    FrameArena *arena;
+
+    FrameAllocator(FrameArena *frameArena = NULL) : arena(frameArena) {}
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U> &other) : arena(other.arena) {}
+
+    T* allocate(size_t count)
+    {
+        if (arena != NULL)
+            return arena->allocateArray<T>(count);
+
+        return (T*)::operator new(count * sizeof(T));
+    }
+
+    void deallocate(T *pointer, size_t count)
+    {
+        // arena memory goes back when its frame does
+        if (arena == NULL)
+            ::operator delete(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U> &other) const { return arena == other.arena; }
+
+    template <typename U>
+    bool operator!=(const FrameAllocator<U> &other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T> >;
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <time.h>
+
+#include <GL/glew.h>
+
+#include "Profiler.h"
+#include "Window.h"
+
+enum PacingMode
+{
+    PACING_VSYNC, // swap interval 1, the display paces the loop
+    PACING_UNCAPPED, // swap interval 0, as fast as possible
+    PACING_CAPPED // swap interval 0, limited to a target rate by the pacer
+};
+
+class FramePacer
+{
+    public:
+        static const int MAX_FRAMES_IN_FLIGHT = 4;
+
+        FramePacer();
+
+        void Initialise(Window *window, PacingMode pacingMode, double targetRate, int framesInFlight);
+
+        void beginFrame();
+        void endFrame();
+
+        double getMeanFrameTime() { return frameCount > 0 ? meanFrameTime : 0.0; }
+        double getFrameTimeDeviation();
+        double getCpuUtilisation();
+
+        void printStatistics();
+
+        ~FramePacer();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        PacingMode mode;
+        double targetPeriod; // seconds per frame when capped
+        int maxFramesInFlight;
+
+        Clock::time_point nextDeadline;
+        double sleepOvershoot; // running estimate of how late sleep_for wakes up
+
+        GLsync fences[MAX_FRAMES_IN_FLIGHT];
+        int fenceIndex;
+
+        // frame-to-frame interval statistics (Welford)
+        Clock::time_point lastFrameEnd;
+        long frameCount;
+        double meanFrameTime, frameTimeM2;
+        double minFrameTime, maxFrameTime;
+
+        Clock::time_point wallStart;
+        clock_t cpuStart;
+
+        void waitUntil(Clock::time_point deadline);
+};
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stddef.h>
+
+// build with -DTRACK_HEAP_ALLOCATIONS to count every operator new in the program,
+// otherwise the count stays at zero and tracking costs nothing
+bool HeapTrackingEnabled();
+size_t GetHeapAllocationCount();
+
+// the calling thread's share of the count
+size_t GetThreadHeapAllocationCount();
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Camera.h"
+#include "InputRecorder.h"
+
+class InputPlayer
+{
+    public:
+        InputPlayer();
+
+        bool load(const char *fileLocation);
+
+        // input replay: feeds recorded input to the camera at a fixed timestep
+        bool step(GLfloat fixedDeltaTime);
+
+        bool* getKeys() { return keys; }
+        GLfloat getXChange();
+        GLfloat getYChange();
+
+        // camera replay: poses the camera exactly as recorded at the given time
+        bool applyCameraPose(GLfloat time, Camera &camera);
+
+        GLfloat getDuration();
+        size_t getFrameCount() { return frames.size(); }
+
+        ~InputPlayer();
+
+    private:
+        std::vector<RecordedFrame> frames;
+        std::vector<uint32_t> keyEventStart; // first key event of each frame, plus one past the end
+        std::vector<uint16_t> keyEvents;
+
+        size_t nextFrame;
+        GLfloat replayTime;
+
+        bool keys[1024];
+        GLfloat xChange, yChange;
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <GL/glew.h>
+
+enum InputEventType : uint8_t
+{
+    INPUT_KEY,
+    INPUT_BUTTON,
+    INPUT_MOTION
+};
+
+struct InputEvent
+{
+    double time; // glfwGetTime() when the event was delivered
+
+    GLfloat xChange, yChange; // motion events only
+
+    int16_t code; // key or mouse button
+    uint8_t type;
+    uint8_t action; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+};
+
+// single-producer/single-consumer ring buffer, the window callbacks push and
+// whoever drives the camera pops, without locks on either side; when it is full
+// motion deltas are summed into one pending event instead of lost, keys & buttons are dropped
+class InputQueue
+{
+    public:
+        static const size_t CAPACITY = 4096; // must be a power of two
+
+        InputQueue();
+
+        // producer: false when the event was dropped, which only happens to keys & buttons
+        bool push(const InputEvent &event);
+
+        // producer: queues motion held back by a full queue, false while it is still waiting
+        bool flush();
+
+        bool pop(InputEvent &event);
+
+        size_t getDropped() { return dropped.load(std::memory_order_relaxed); }
+
+        ~InputQueue();
+
+    private:
+        // head and tail are written by different threads, keep them on separate cache lines
+        alignas(64) std::atomic<size_t> head; // next slot to pop, written by the consumer
+        size_t cachedTail; // consumer's last view of tail
+
+        alignas(64) std::atomic<size_t> tail; // next slot to push, written by the producer
+        size_t cachedHead; // producer's last view of head
+        std::atomic<size_t> dropped;
+
+        InputEvent pendingMotion; // deltas that did not fit yet, producer only
+        bool motionPending;
+
+        alignas(64) InputEvent events[CAPACITY];
+
+        bool enqueue(const InputEvent &event);
+};
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Camera.h"
+
+// file layout: magic, version, then one record per frame holding the timestamp,
+// mouse deltas, camera pose and the keys whose state changed during that frame
+static const uint32_t RECORDING_MAGIC = 0x52474F4C; // "LOGR"
+static const uint32_t RECORDING_VERSION = 1;
+static const uint16_t RECORDING_KEY_PRESSED = 0x8000; // set on a key event when the key went down
+
+struct RecordedFrame
+{
+    GLfloat time;
+    GLfloat xChange, yChange;
+
+    glm::vec3 position;
+    glm::quat orientation;
+};
+
+class InputRecorder
+{
+    public:
+        InputRecorder();
+
+        bool beginRecording(const char *fileLocation);
+        void recordFrame(GLfloat time, bool *keys, GLfloat xChange, GLfloat yChange, Camera &camera);
+        void endRecording();
+
+        bool isRecording() { return file != NULL; }
+
+        ~InputRecorder();
+
+    private:
+        FILE *file;
+
+        bool lastKeys[1024];
+        uint16_t keyEvents[1024];
+};
\ No newline at end of file
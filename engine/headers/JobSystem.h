@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+typedef void (*JobFunction)(void *data, size_t begin, size_t end);
+
+// counts unfinished jobs, anything waiting on it resumes once it reaches zero
+struct JobCounter
+{
+    std::atomic<int> value;
+
+    JobCounter() { value.store(0, std::memory_order_relaxed); }
+};
+
+struct Job
+{
+    JobFunction function;
+    void *data;
+
+    size_t begin, end;
+    size_t grain; // ranges above this size may be split between workers
+
+    JobCounter *counter; // decremented when the job finishes
+    JobCounter *dependency; // the job does not start before this reaches zero
+
+    std::atomic<bool> *busy; // its pool slot's flag, cleared once the job starts & no longer needs the slot
+};
+
+// Chase-Lev deque: the owning worker pushes & pops at the bottom, thieves take from the top
+class WorkStealingQueue
+{
+    public:
+        static const int64_t CAPACITY = 4096; // must be a power of two
+
+        WorkStealingQueue();
+
+        bool push(Job *job);
+        Job* pop();
+        Job* steal();
+
+        int64_t size();
+
+    private:
+        alignas(64) std::atomic<int64_t> top;
+        alignas(64) std::atomic<int64_t> bottom;
+        alignas(64) std::atomic<Job*> jobs[CAPACITY];
+};
+
+class JobSystem
+{
+    public:
+        static const size_t JOB_POOL_SIZE = 4096; // queued jobs per thread before allocation waits for a free slot
+
+        JobSystem();
+
+        // the calling thread becomes worker 0, threadCount - 1 more are started
+        void Initialise(unsigned int threadCount, bool pinThreads);
+        void Shutdown();
+
+        unsigned int getThreadCount() { return workers.size(); }
+
+        void run(JobFunction function, void *data, JobCounter *counter, JobCounter *dependency = NULL);
+        void parallelFor(size_t count, size_t grain, JobFunction function, void *data, JobCounter *counter, JobCounter *dependency = NULL);
+
+        // runs other jobs while waiting, so it is safe to call from inside a job
+        void wait(JobCounter *counter);
+
+        // blocking parallel loop over a lambda taking (begin, end), grain 0 picks one automatically
+        template <typename Body>
+        void parallelFor(size_t count, size_t grain, const Body &body)
+        {
+            JobCounter counter;
+            parallelFor(count, grain, &invokeBody<Body>, (void*)&body, &counter);
+            wait(&counter);
+        }
+
+        ~JobSystem();
+
+    private:
+        struct Worker
+        {
+            WorkStealingQueue queue;
+            Job jobPool[JOB_POOL_SIZE];
+            std::atomic<bool> jobBusy[JOB_POOL_SIZE];
+            size_t nextJob;
+            uint32_t random; // victim selection state
+
+            // popped before their dependency finished, only touched by the owner & rechecked once
+            // it finds no other work, so the dependency gets to run first
+            std::vector<Job*> pending;
+        };
+
+        std::vector<Worker*> workers;
+        std::vector<std::thread> threads;
+        std::atomic<bool> running;
+
+        // jobs submitted from threads that are not workers, e.g. the render thread
+        std::mutex externalMutex;
+        std::vector<Job*> externalJobs;
+        Job externalPool[JOB_POOL_SIZE];
+        std::atomic<bool> externalBusy[JOB_POOL_SIZE];
+        size_t nextExternalJob;
+        std::atomic<int> externalCount;
+
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        std::atomic<int> sleeping;
+
+        template <typename Body>
+        static void invokeBody(void *data, size_t begin, size_t end)
+        {
+            (*(const Body*)data)(begin, end);
+        }
+
+        int currentWorker();
+        Job* allocateJob();
+        Job* claimSlot(Job *job, std::atomic<bool> *busy, int worker);
+        void submit(Job *job);
+        Job* findJob(int worker);
+        void execute(Job *job, int worker);
+        void workerLoop(unsigned int index, bool pin);
+};
\ No newline at end of file
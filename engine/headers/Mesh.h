@@ -0,0 +1,28 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "Profiler.h"
+#include "RenderStats.h"
+
+class Mesh
+{
+    public:
+        Mesh();
+
+        // numOfVertices counts floats; more than 3 floats per vertex adds a normal (location 1) & a texture coordinate (location 2)
+        void CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices, unsigned int floatsPerVertex = 3);
+        void RenderMesh();
+        void RenderMeshInstanced(GLsizei instanceCount);
+        void ClearMesh();
+
+        GLuint GetVAO() { return VAO; }
+        GLuint GetIBO() { return IBO; }
+        GLsizei GetIndexCount() { return indexCount; }
+
+        ~Mesh();
+
+    private:
+        GLuint VAO, VBO, IBO;
+        GLsizei indexCount;  
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+
+// ready for Mesh::CreateMesh(vertices.data(), indices.data(), vertices.size(), indices.size(), FLOATS_PER_VERTEX)
+struct ModelData
+{
+    static const unsigned int FLOATS_PER_VERTEX = 8; // position, normal & texture coordinate, interleaved
+
+    std::vector<GLfloat> vertices;
+    std::vector<unsigned int> indices; // triangles
+
+    // sphere around every vertex
+    glm::vec3 boundsCentre;
+    GLfloat boundsRadius;
+
+    size_t getVertexCount() { return vertices.size() / FLOATS_PER_VERTEX; }
+};
+
+// Wavefront OBJ & glTF 2.0 (.gltf with external buffers, or .glb) into one indexed triangle list.
+// Files are memory mapped; OBJ text is parsed in chunks on the job system, two passes so every
+// array is allocated once at its final size, and equal position/texture/normal corners are merged
+// through a hash table. glTF meshes are taken without their node transforms.
+class ModelLoader
+{
+    public:
+        static const size_t OBJ_CHUNK_SIZE = 1 << 20; // bytes of text per parsing job
+
+        ModelLoader();
+
+        void setJobSystem(JobSystem *jobSystem) { jobs = jobSystem; }
+
+        // picks the format from the extension; prints the reason & returns false on failure
+        bool load(const char *fileLocation, ModelData &model);
+        bool loadObj(const char *fileLocation, ModelData &model);
+        bool loadGltf(const char *fileLocation, ModelData &model);
+
+        // unique vertices over the corners referenced by the last load, 1 when nothing was merged
+        double getLastDedupRatio() { return lastDedupRatio; }
+
+        ~ModelLoader();
+
+    private:
+        // a read only view of a whole file, mapped where the platform allows
+        struct MappedFile
+        {
+            const char *data;
+            size_t size;
+
+            void *mapping;
+            std::vector<char> fallback;
+        };
+
+        // one OBJ chunk: its text, then what it holds, then where its results start in the shared arrays
+        struct ObjChunk
+        {
+            const char *begin, *end;
+
+            size_t positions, texCoords, normals, corners;
+            size_t positionBase, texCoordBase, normalBase, cornerBase;
+
+            const char *error; // first malformed line, NULL if none
+        };
+
+        JobSystem *jobs;
+        double lastDedupRatio;
+
+        // OBJ scratch, kept between loads
+        std::vector<ObjChunk> chunks;
+        std::vector<GLfloat> positions, texCoords, normals;
+        std::vector<int32_t> corners; // position, texture coordinate & normal per triangle corner, -1 when absent
+        std::vector<uint32_t> table; // open addressing, vertex index + 1, 0 for empty
+        std::vector<uint32_t> firstCorner; // the corner each OBJ vertex was made from, or the remap when merging by content
+
+        bool mapFile(const char *fileLocation, MappedFile &file);
+        void unmapFile(MappedFile &file);
+
+        void countChunk(ObjChunk &chunk);
+        void parseChunk(ObjChunk &chunk);
+        bool buildObjVertices(ModelData &model);
+
+        void dedupVertices(ModelData &model);
+        void computeNormals(ModelData &model);
+        void computeBounds(ModelData &model);
+};
\ No newline at end of file
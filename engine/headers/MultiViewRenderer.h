@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "CommandBuffer.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "Shader.h"
+
+struct View
+{
+    GLint x, y;
+    GLsizei width, height;
+
+    glm::mat4 view;
+    glm::mat4 projection;
+};
+
+struct RenderObject
+{
+    Mesh *mesh;
+    Shader *shader; // NULL draws with the renderer's own shader
+    glm::mat4 model;
+
+    // world space bounding sphere
+    glm::vec3 center;
+    GLfloat radius;
+};
+
+class MultiViewRenderer
+{
+    public:
+        static const size_t MAX_VIEWS = 32; // one bit per view in the visibility masks
+        static const size_t MAX_INSTANCED_VIEWS = 8; // size of the viewProjections array in multiview.vert
+        static const size_t PARALLEL_CULL_THRESHOLD = 4096; // smaller scenes are culled on the calling thread
+        static const size_t PARALLEL_RECORD_THRESHOLD = 1024; // fewer draws are recorded on the calling thread
+        static const size_t RECORD_CHUNK_SIZE = 256; // draws per command buffer
+
+        MultiViewRenderer();
+
+        static bool instancingSupported();
+
+        void setShaders(Shader *perViewShader, Shader *instancedShader);
+        void setJobSystem(JobSystem *jobSystem) { jobs = jobSystem; }
+
+        // visibility masks & draw lists come from the arena's current frame when one is set
+        void setFrameArena(FrameArena *frameArena) { arena = frameArena; }
+
+        // the new view's index, or -1 once MAX_VIEWS views exist
+        int addView(GLint x, GLint y, GLsizei width, GLsizei height);
+        void setViewMatrices(size_t viewIndex, glm::mat4 view, glm::mat4 projection);
+        void clearViews();
+        size_t getViewCount() { return views.size(); }
+
+        void cull(const std::vector<RenderObject> &objects);
+
+        // overrideShader draws every object with one program & one view at a time, as the deferred passes need.
+        // the instanced path only runs the multi-view program, so it is skipped whenever an override is
+        // given or any object asks for a shader of its own
+        void render(const std::vector<RenderObject> &objects, Shader *overrideShader = NULL);
+
+        size_t getVisibleCount(size_t viewIndex) { return drawLists[viewIndex].size(); }
+
+        ~MultiViewRenderer();
+
+    private:
+        std::vector<View> views;
+        std::vector<glm::vec4> planes; // six frustum planes per view
+        std::vector<glm::mat4> viewProjections;
+
+        glm::vec3 unionMin, unionMax; // world space box around every view frustum
+
+        FrameVector<uint32_t> visibility; // per object mask of the views that see it
+        std::vector< FrameVector<uint32_t> > drawLists; // per view indices into the object list
+
+        Shader *perViewShader;
+        Shader *instancedShader;
+        Shader *overrideShader; // only set during render()
+
+        JobSystem *jobs;
+        FrameArena *arena;
+
+        // a range of one view's draw list, or of the object list when instanced
+        struct RecordChunk
+        {
+            size_t view;
+            size_t begin, end;
+        };
+
+        std::vector<RecordChunk> chunks;
+        std::vector<CommandBuffer> commandBuffers; // one per chunk, kept between frames
+
+        GLuint uniformViewMask;
+
+        void updateFrustums();
+        void cullRange(const std::vector<RenderObject> &objects, size_t begin, size_t end);
+        bool allUsePerViewShader(const std::vector<RenderObject> &objects);
+        GLuint beginInstanced();
+        void recordChunk(const std::vector<RenderObject> &objects, size_t chunkIndex, bool instanced);
+};
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "Shader.h"
+
+struct ParticleEmitter
+{
+    glm::vec3 position;
+    GLfloat radius; // particles start anywhere within this of position on each axis
+    glm::vec3 velocity; // mean launch velocity
+    GLfloat spread; // random velocity added on each axis, up to this either way
+    GLfloat rate; // particles per second
+    GLfloat lifetime; // seconds, each particle lives between half & all of it
+};
+
+// Particles as one array per component, cut into blocks of BLOCK_SIZE. A block's live particles
+// are always at its front, so each block is integrated, bounced off the ground, compacted & topped
+// up by the emitter as one job, with no state shared between blocks. The kernels are picked like
+// ComposeTransforms: AVX-512 compresses the survivors with a mask, AVX2 through a permutation
+// table, SSE & scalar code write every particle and advance the write position by its liveness.
+//
+// Live particles are streamed into one vertex buffer each frame & drawn as point sprites.
+class ParticleSystem
+{
+    public:
+        static const size_t BLOCK_SIZE = 16384; // particles per block, a multiple of every SIMD width
+        static const size_t FLOATS_PER_VERTEX = 4; // position & remaining life as a fraction of the lifetime
+
+        ParticleSystem();
+
+        // pure CPU work: room for capacity particles, rounded up to whole blocks
+        bool reserve(size_t capacity);
+
+        // the streamed vertex buffer, needs a current GL context
+        bool Initialise(Shader *shader, GLfloat particleSize);
+        void Shutdown();
+
+        bool isEnabled() { return blockCount > 0; }
+
+        void setJobSystem(JobSystem *jobSystem) { jobs = jobSystem; }
+        void setEmitter(const ParticleEmitter &particleEmitter) { emitter = particleEmitter; }
+
+        // drag is the fraction of velocity lost per second; below groundHeight particles bounce, keeping restitution of their speed
+        void setForces(GLfloat gravity, GLfloat drag, GLfloat groundHeight, GLfloat restitution);
+
+        // emitted all at once on the next update, on top of the emitter's rate
+        void spawn(size_t count) { spawnBacklog += count; }
+
+        // pure CPU work: integrates & compacts every block on the job system, then emits dt's worth of particles
+        void update(GLfloat dt);
+
+        // GL thread: streams the live particles into the vertex buffer, filled on the job system
+        void upload();
+
+        // draws the last upload as point sprites into the current viewport, blended additively over the depth buffer
+        void render(const glm::mat4 &view, const glm::mat4 &projection, GLsizei viewportHeight);
+
+        size_t getCapacity() { return blockCount * BLOCK_SIZE; }
+        size_t getLiveCount() { return liveCount; }
+        size_t getDroppedCount() { return droppedCount; }
+
+        // particles integrated per millisecond over every update
+        double getUpdateRate() { return updateTotal > 0.0 ? updatedTotal / (updateTotal * 1000.0) : 0.0; }
+        double getLastUpdateTime() { return lastUpdateTime; }
+
+        static const char* getKernelName();
+
+        void printStatistics();
+
+        ~ParticleSystem();
+
+    private:
+        JobSystem *jobs;
+
+        size_t blockCount;
+        std::vector<GLfloat> positionX, positionY, positionZ;
+        std::vector<GLfloat> velocityX, velocityY, velocityZ;
+        std::vector<GLfloat> life; // seconds left
+
+        std::vector<uint32_t> counts; // live particles at the front of each block
+        std::vector<uint32_t> emits; // new particles each block takes this update
+        std::vector<size_t> offsets; // each block's first vertex in the streamed buffer
+
+        ParticleEmitter emitter;
+        GLfloat gravity, drag, groundHeight, restitution;
+
+        double emitAccumulator; // fraction of a particle carried over between updates
+        size_t spawnBacklog;
+        uint64_t frame;
+
+        size_t liveCount, droppedCount;
+
+        double lastUpdateTime, updateTotal; // seconds
+        uint64_t updatedTotal;
+        size_t updateCount;
+
+        Shader *shader;
+        GLuint vertexArray, vertexBuffer;
+        size_t bufferCapacity; // vertices the buffer's storage holds
+        size_t uploadedCount;
+        GLfloat particleSize;
+
+        GLuint uniformView, uniformProjection, uniformPointScale, uniformParticleSize;
+
+        void updateBlock(size_t block, GLfloat dt, GLfloat damping);
+        void emitBlock(size_t block);
+        void writeVertices(size_t block, GLfloat *vertices);
+};
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+struct ProfileEvent
+{
+    const char *name;
+    uint64_t start, end; // nanoseconds since the profiler started
+    uint32_t depth;
+};
+
+// ring buffer of one thread's finished scopes, written only by that thread
+struct ProfileThread
+{
+    static const size_t CAPACITY = 1 << 15; // must be a power of two
+
+    ProfileEvent events[CAPACITY];
+    std::atomic<uint64_t> count;
+    uint32_t depth;
+    uint32_t id;
+    char name[32];
+};
+
+// CPU scopes per thread plus GPU scopes from timestamp queries that are read back
+// GPU_LATENCY frames later, so the CPU never waits on the GPU for a result
+class Profiler
+{
+    public:
+        static const size_t GPU_LATENCY = 4; // frames between issuing queries & reading them
+        static const size_t MAX_GPU_SCOPES = 256; // per frame, later scopes are not timed
+        static const size_t MAX_FRAMES = 4096; // frame boundaries kept for the summary
+
+        Profiler();
+
+        // gpu timing needs the context current on the calling thread
+        void Initialise(bool gpuTiming);
+        void Shutdown();
+
+        void setThreadName(const char *name);
+
+        uint64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count(); }
+
+        ProfileThread* currentThread();
+
+        int beginGpu(const char *name);
+        void endGpu(int scope);
+
+        // on the GL thread after the swap
+        void endFrame();
+
+        void printSummary();
+        bool writeChromeTrace(const char *fileLocation);
+
+        ~Profiler();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct GpuFrame
+        {
+            GLuint queries[MAX_GPU_SCOPES * 2];
+            const char *names[MAX_GPU_SCOPES];
+            uint32_t depths[MAX_GPU_SCOPES];
+            size_t scopeCount;
+            size_t openScopes;
+            bool pending;
+
+            // one cpu & gpu clock pair per frame to put gpu times on the cpu timeline
+            uint64_t cpuTime;
+            GLint64 gpuTime;
+        };
+
+        Clock::time_point startTime;
+
+        std::mutex threadsMutex;
+        std::vector<ProfileThread*> threads;
+        ProfileThread *gpuThread;
+
+        bool gpuEnabled;
+        GpuFrame gpuFrames[GPU_LATENCY];
+        size_t gpuFrameIndex;
+        size_t gpuFramesDropped;
+
+        uint64_t frameEnds[MAX_FRAMES];
+        uint64_t frameCount;
+
+        double scopeCost; // measured nanoseconds per cpu scope
+
+        ProfileThread* registerThread(const char *name);
+        void beginGpuFrame(GpuFrame &frame);
+        void readGpuFrame(GpuFrame &frame);
+        void calibrate();
+};
+
+extern Profiler profiler;
+
+class ProfileScope
+{
+    public:
+        ProfileScope(const char *name)
+        {
+            thread = profiler.currentThread();
+            this->name = name;
+            depth = thread->depth++;
+            start = profiler.now();
+        }
+
+        ~ProfileScope()
+        {
+            uint64_t end = profiler.now();
+            uint64_t index = thread->count.load(std::memory_order_relaxed);
+
+            ProfileEvent &event = thread->events[index & (ProfileThread::CAPACITY - 1)];
+            event.name = name;
+            event.start = start;
+            event.end = end;
+            event.depth = depth;
+
+            thread->count.store(index + 1, std::memory_order_release);
+            thread->depth--;
+        }
+
+    private:
+        ProfileThread *thread;
+        const char *name;
+        uint64_t start;
+        uint32_t depth;
+};
+
+class GpuProfileScope
+{
+    public:
+        GpuProfileScope(const char *name) { scope = profiler.beginGpu(name); }
+        ~GpuProfileScope() { profiler.endGpu(scope); }
+
+    private:
+        int scope;
+};
+
+// build with -DENABLE_PROFILER to record scopes, otherwise they compile to nothing
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) PROFILE_SCOPE(name); GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_GPU_SCOPE(name) do {} while (0)
+#endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+enum RenderCounter
+{
+    COUNTER_DRAW_CALLS,
+    COUNTER_INDICES, // summed over every instance drawn
+    COUNTER_PROGRAM_BINDS,
+    COUNTER_VAO_BINDS,
+    COUNTER_UNIFORM_UPLOADS,
+    COUNTER_UPLOAD_BYTES, // vertex & index data sent to buffers
+    COUNTER_PROGRAMS_COMPILED,
+    COUNTER_COUNT
+};
+
+// per-frame renderer counters: every thread adds to its own slot, endFrame sums the slots
+// and moves the difference into a rolling window, so nothing ever takes a lock
+class RenderStats
+{
+    public:
+        static const size_t WINDOW = 128; // frames in the rolling min/avg/max, a power of two
+        static const size_t MAX_THREADS = 64; // threads beyond this share the last slot
+
+        RenderStats();
+
+        void add(RenderCounter counter, uint64_t amount)
+        {
+            CounterSlot &slot = threadSlot();
+            std::atomic<uint64_t> &value = slot.values[counter];
+
+            // only the owning thread writes its slot, so a plain load & store is enough
+            if (slot.shared)
+                value.fetch_add(amount, std::memory_order_relaxed);
+            else
+                value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        // once per frame, on the thread that renders
+        void endFrame();
+
+        // safe from any thread while frames keep ending
+        uint64_t getLast(RenderCounter counter);
+        uint64_t getMin(RenderCounter counter);
+        uint64_t getMax(RenderCounter counter);
+        double getAverage(RenderCounter counter);
+        uint64_t getFrameCount() { return frameCount.load(std::memory_order_acquire); }
+
+        static const char* getName(RenderCounter counter);
+
+        // "draws 2 | triangles 8 | ..." averaged over the window
+        void formatSummary(char *buffer, size_t size);
+        void printStatistics();
+
+        ~RenderStats();
+
+    private:
+        // running totals of one thread, on their own cache line
+        struct alignas(64) CounterSlot
+        {
+            std::atomic<uint64_t> values[COUNTER_COUNT];
+            bool shared;
+        };
+
+        CounterSlot slots[MAX_THREADS];
+        std::atomic<size_t> slotCount;
+        uint64_t previousTotals[COUNTER_COUNT]; // slot sums at the last endFrame
+
+        std::atomic<uint64_t> history[COUNTER_COUNT][WINDOW];
+        std::atomic<uint64_t> frameCount;
+
+        // there is a single RenderStats, so one slot pointer per thread is enough
+        CounterSlot& threadSlot()
+        {
+            static thread_local CounterSlot *slot = NULL;
+
+            if (!slot)
+                slot = claimSlot();
+
+            return *slot;
+        }
+
+        CounterSlot* claimSlot();
+        size_t windowSize();
+};
+
+extern RenderStats renderStats;
\ No newline at end of file
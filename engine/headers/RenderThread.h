@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "ClusteredLighting.h"
+#include "MultiViewRenderer.h"
+#include "Window.h"
+
+// everything the renderer needs for one frame, written by the main thread and
+// never touched again by it once published
+struct FrameSnapshot
+{
+    long frameIndex;
+    double inputTime; // when the input shown by this frame was sampled
+
+    std::vector<View> views;
+    std::vector<RenderObject> objects;
+    std::vector<PointLight> lights;
+};
+
+class RenderThread
+{
+    public:
+        RenderThread();
+
+        // takes the GL context from the calling thread, runs setup once and then
+        // renderFrame for every published snapshot
+        void start(Window *window, std::function<void()> setup, std::function<void(const FrameSnapshot&)> renderFrame);
+        void stop();
+
+        bool isRunning() { return thread.joinable(); }
+
+        // the slot the main thread fills for the next frame
+        FrameSnapshot& getWriteSnapshot() { return slots[writeSlot]; }
+        void publish();
+
+        void printStatistics();
+
+        ~RenderThread();
+
+    private:
+        Window *window;
+        std::function<void()> setup;
+        std::function<void(const FrameSnapshot&)> renderFrame;
+
+        // write, ready & read slots, so neither thread ever waits on the other's copy
+        FrameSnapshot slots[3];
+        int writeSlot, readySlot, readSlot;
+        bool readyIsNew;
+        bool stopping;
+
+        std::mutex mutex;
+        std::condition_variable snapshotReady;
+        std::condition_variable snapshotTaken;
+
+        std::thread thread;
+
+        // timing, busy time excludes waiting for the other thread
+        double startTime;
+        double mainWaitTime;
+        double renderBusyTime;
+        double latencyTotal, latencyMax;
+        long renderedFrames;
+
+        void run();
+};
\ No newline at end of file
@@ -7,6 +7,9 @@
 
 #include <GL/glew.h>
 
+#include "Profiler.h"
+#include "RenderStats.h"
+
 class Shader
 {
     public:
@@ -20,6 +23,8 @@ class Shader
         GLuint GetProjectionLocation();
         GLuint GetModelLocation();
         GLuint GetViewLocation();
+        GLuint GetUniformLocation(const char *name);
+        GLuint GetShaderId() { return shaderId; }
 
         void UseShader();
         void ClearShader();
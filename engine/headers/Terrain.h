@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Mesh.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "Shader.h"
+
+// A square heightmap drawn with continuous distance-dependent LOD (CDLOD). A quadtree over the
+// heightmap keeps the height range of every node; each view walks it from the root, splitting
+// nodes that reach into the LOD range of the level below. Selected nodes are all drawn with one
+// shared grid patch, displaced in terrain.vert from a 16 bit height texture, and the vertices of
+// each level blend into the coarser grid before the next level takes over, so there are no
+// cracks or popping between levels.
+//
+// Heights are changed a tile at a time; changed tiles go to the GPU under a per-frame byte budget
+// and the quadtree ranges above them are refreshed as they land.
+class Terrain
+{
+    public:
+        static const int PATCH_RESOLUTION = 32; // quads along a patch side, one sample apart at level 0
+        static const int TILE_SIZE = 256; // samples along a tile side, the unit of updates
+        static const int MAX_LEVELS = 12;
+        static const int MAX_NODES_PER_DRAW = 128; // length of the nodes array in terrain.vert
+        static const GLuint HEIGHTMAP_UNIT = 7; // after the G-buffer units
+
+        Terrain();
+
+        // pure CPU work: size x size samples (a power of two, at least TILE_SIZE) spacing units apart, centred on the
+        // origin, copied from initialHeights (see updateTile) or flat at baseHeight when NULL; nodes of level 0 are
+        // split within lodDistance of the camera (at least 3 patch widths), each level above at twice the distance
+        bool createHeightmap(int size, GLfloat spacing, GLfloat heightScale, GLfloat baseHeight, GLfloat lodDistance, const uint16_t *initialHeights = NULL);
+
+        // the height texture & patch meshes, needs a current GL context; the heightmap goes up whole as it stands
+        bool Initialise(Shader *shader, size_t uploadBudgetPerFrame);
+        void Shutdown();
+
+        bool isEnabled() { return heightmap != 0; }
+
+        // TILE_SIZE x TILE_SIZE heights, row major, 0 at baseHeight & 65535 at baseHeight + heightScale;
+        // different tiles may be written from several threads at once, but never during update()
+        void updateTile(int tileX, int tileZ, const uint16_t *tileHeights);
+
+        // GL thread, once per frame: uploads changed tiles within the byte budget & refreshes their bounds
+        void update();
+
+        // pure CPU work: picks the nodes covering what the camera in view sees through projection
+        void select(const glm::mat4 &view, const glm::mat4 &projection);
+
+        // selects, then draws into the current viewport
+        void render(const glm::mat4 &view, const glm::mat4 &projection);
+
+        int getSize() { return size; }
+        int getTilesAcross() { return tilesAcross; }
+        int getLevelCount() { return levelCount; }
+        size_t getPendingTiles() { return pendingTiles.load(std::memory_order_relaxed); }
+
+        // of the last selection
+        size_t getSelectedCount() { return selected[0].size() + selected[1].size(); }
+        size_t getVertexCount();
+        double getLastSelectionTime() { return lastSelectionTime; }
+
+        double getMeanSelectionTime() { return selectionCount > 0 ? selectionTotal / selectionCount : 0.0; }
+        double getMeanVertexCount() { return selectionCount > 0 ? (double)vertexTotal / selectionCount : 0.0; }
+
+        void printStatistics();
+
+        ~Terrain();
+
+    private:
+        int size, tilesAcross, levelCount;
+        GLfloat spacing, heightScale, baseHeight;
+        GLfloat halfExtent;
+
+        std::vector<uint16_t> heights; // the CPU copy, row major
+        std::vector<uint8_t> dirtyTiles;
+        std::atomic<size_t> pendingTiles;
+        int nextTile; // where the next update() starts looking, so no tile waits forever
+
+        // height range of every node, level 0 first; each node covers its samples & the first of its neighbours
+        std::vector<uint16_t> minimums[MAX_LEVELS], maximums[MAX_LEVELS];
+        GLfloat ranges[MAX_LEVELS]; // a node of level L is split when the camera is within ranges[L - 1] of it
+        GLfloat morphRanges[MAX_LEVELS * 2]; // start & end of each level's blend into the grid above
+
+        // per selection: planes of the frustum, the camera & the nodes as corner x, corner z, size & level;
+        // whole nodes are drawn with the full patch, quarters of a node with the half resolution one
+        glm::vec4 planes[6];
+        glm::vec3 cameraPosition;
+        std::vector<glm::vec4> selected[2];
+
+        Shader *shader;
+        Mesh patches[2];
+        GLuint heightmap;
+        size_t uploadBudget;
+
+        GLuint uniformNodes, uniformPatchQuads, uniformCameraPosition;
+        GLuint uniformView, uniformProjection;
+
+        double lastSelectionTime, selectionTotal;
+        size_t selectionCount;
+        uint64_t vertexTotal;
+        size_t tilesUploaded;
+
+        void buildPatch(Mesh &patch, int quads);
+        void refreshBounds(int firstColumn, int lastColumn, int firstRow, int lastRow); // inclusive, in level 0 nodes
+        void nodeBounds(int level, int x, int z, glm::vec3 &minimum, glm::vec3 &maximum);
+        bool visible(const glm::vec3 &minimum, const glm::vec3 &maximum);
+        bool withinRange(const glm::vec3 &minimum, const glm::vec3 &maximum, GLfloat range);
+        void selectNode(int level, int x, int z);
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <ctype.h>
+#include <math.h>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+
+typedef uint32_t TextureHandle;
+
+enum TextureState
+{
+    TEXTURE_DECODING, // queued or running on the job system
+    TEXTURE_DECODED, // every mip level is in system memory, ready to stream
+    TEXTURE_FAILED // unreadable file, keeps drawing with the placeholder
+};
+
+class TextureManager
+{
+    public:
+        static const TextureHandle INVALID_TEXTURE = 0xffffffff;
+        static const size_t MAX_TEXTURES = 256;
+        static const int MAX_MIP_LEVELS = 16; // up to 32768 texels across
+        static const int STAGING_BUFFERS = 4; // pixel buffer objects cycled through for uploads
+        static const size_t STAGING_SIZE = 1024 * 1024; // bytes per pixel buffer, larger levels go up in bands of rows
+        static const size_t BANDWIDTH_WINDOW = 64; // frames averaged for the upload bandwidth
+        static const size_t DECODE_ROWS = 64; // rows per decode & downsample job
+
+        TextureManager();
+
+        // needs a current GL context; budgets are in bytes
+        bool Initialise(JobSystem *jobSystem, size_t residencyBudget, size_t uploadBudgetPerFrame);
+        void Shutdown();
+
+        // starts decoding on the job system and returns straight away; safe to call from any thread
+        TextureHandle load(const char *fileLocation);
+
+        // how many pixels across the texture covers on screen this frame, the largest request wins
+        void requestScreenSize(TextureHandle handle, GLfloat pixels);
+
+        // GL thread, once per frame: evicts under the budget and streams the next mip levels
+        void update();
+
+        // the resident part of the texture, or a white placeholder until its first level arrives
+        GLuint getTextureId(TextureHandle handle);
+        void bind(TextureHandle handle, GLuint unit);
+
+        // a decode is queued or running on the job system, it allocates the texture's pixel storage
+        bool isDecoding() { return pendingDecodes.value.load(std::memory_order_acquire) > 0; }
+
+        TextureState getState(TextureHandle handle) { return (TextureState)textures[handle].state.load(std::memory_order_acquire); }
+        int getResidentLevel(TextureHandle handle) { return textures[handle].residentBase; }
+
+        size_t getResidentBytes() { return residentBytes; }
+        size_t getBudget() { return budget; }
+        double getUploadBandwidth(); // bytes per second over the last BANDWIDTH_WINDOW frames
+        double getMeanTimeToFirstMip() { return firstMipCount > 0 ? firstMipTotal / firstMipCount : 0.0; }
+        double getMaxTimeToFirstMip() { return firstMipMax; }
+
+        void printStatistics();
+
+        ~TextureManager();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Texture;
+
+        // rows of one mip level, handed to the job system in bands of DECODE_ROWS
+        struct DecodeJob
+        {
+            TextureManager *manager;
+            Texture *texture;
+            int level;
+        };
+
+        struct Texture
+        {
+            std::atomic<int> state;
+            std::string location;
+
+            // RGBA8, every level back to back from the full size one down to 1x1
+            std::vector<uint8_t> pixels;
+            std::vector<uint8_t> fileData; // raw file contents until decoding has finished
+            size_t pixelsOffset; // start of the raster in fileData
+            int channels; // 1 for PGM, 3 for PPM
+
+            int levelCount;
+            GLsizei levelWidth[MAX_MIP_LEVELS], levelHeight[MAX_MIP_LEVELS];
+            size_t levelOffset[MAX_MIP_LEVELS];
+
+            GLuint textureId;
+            int residentBase; // finest level on the GPU, levelCount while nothing is
+            int uploadLevel; // level being streamed, -1 when idle
+            GLsizei uploadRow; // rows of uploadLevel already sent
+
+            int wantedLevel; // finest level asked for this frame
+            int demandedLevel; // wantedLevel of the last finished frame
+            uint64_t lastUsedFrame;
+
+            Clock::time_point loadTime;
+            bool firstMipRecorded;
+
+            DecodeJob decodeJobs[MAX_MIP_LEVELS];
+        };
+
+        JobSystem *jobs;
+
+        Texture textures[MAX_TEXTURES];
+        std::atomic<uint32_t> textureCount;
+        std::mutex loadMutex;
+
+        // decodes still running, waited on by Shutdown
+        JobCounter pendingDecodes;
+
+        GLuint placeholder;
+
+        GLuint stagingBuffers[STAGING_BUFFERS];
+        GLsync stagingFences[STAGING_BUFFERS];
+        int stagingIndex;
+
+        size_t budget;
+        size_t uploadBudget;
+        size_t residentBytes;
+        uint64_t frame;
+
+        // upload bandwidth over a window of frames
+        Clock::time_point windowTimes[BANDWIDTH_WINDOW];
+        size_t windowBytes[BANDWIDTH_WINDOW];
+        size_t windowIndex, windowCount;
+        size_t totalUploadBytes;
+
+        // load() to the first level being sampled, in seconds
+        double firstMipTotal, firstMipMax;
+        size_t firstMipCount;
+
+        size_t evictionCount;
+
+        static void decodeJob(void *data, size_t begin, size_t end);
+        static void convertRows(void *data, size_t begin, size_t end);
+        static void downsampleRows(void *data, size_t begin, size_t end);
+
+        void decode(Texture &texture);
+        bool readFile(Texture &texture);
+        bool parseHeader(Texture &texture);
+        void forEachBand(Texture &texture, int level, JobFunction function);
+
+        size_t levelBytes(const Texture &texture, int level) { return (size_t)texture.levelWidth[level] * texture.levelHeight[level] * 4; }
+
+        void createTexture(Texture &texture);
+        bool makeRoom(size_t bytes);
+        void evictLevel(Texture &texture);
+        Texture* nextUpload();
+        size_t uploadBand(Texture &texture, size_t bytesLeft);
+};
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "JobSystem.h"
+#include "TransformKernels.h"
+
+// scene graph of transforms stored as structure-of-arrays, nodes are only ever
+// added after their parent so one forward pass always sees parents first
+class TransformHierarchy
+{
+    public:
+        static const uint32_t NO_PARENT = 0xFFFFFFFF;
+        static const uint32_t INVALID_NODE = 0xFFFFFFFF; // what addNode returns when it adds nothing
+
+        // batch-compose every local matrix once at least 1 in this many nodes is dirty
+        static const size_t BATCH_DIRTY_RATIO = 4;
+
+        static const size_t PARALLEL_UPDATE_THRESHOLD = 4096; // smaller hierarchies & depth levels are updated on the calling thread
+
+        TransformHierarchy();
+
+        void reserve(size_t nodeCount);
+
+        // composes & updates large levels of the tree on the job system when set
+        void setJobSystem(JobSystem *jobSystem) { jobs = jobSystem; }
+
+        // the parent must already exist, otherwise no node is added & INVALID_NODE is returned
+        uint32_t addNode(uint32_t parent, glm::vec3 translation, glm::quat rotation, glm::vec3 scale);
+
+        void setTranslation(uint32_t node, glm::vec3 translation);
+        void setRotation(uint32_t node, glm::quat rotation);
+        void setScale(uint32_t node, glm::vec3 scale);
+
+        glm::vec3 getTranslation(uint32_t node) { return glm::vec3(tx[node], ty[node], tz[node]); }
+        uint32_t getParent(uint32_t node) { return parents[node]; }
+
+        // recomputes world matrices of dirty nodes and their descendants
+        size_t update();
+
+        const glm::mat4& getWorldMatrix(uint32_t node) { return worldMatrices[node]; }
+        size_t getNodeCount() { return parents.size(); }
+
+        ~TransformHierarchy();
+
+    private:
+        JobSystem *jobs;
+
+        std::vector<uint32_t> parents;
+        std::vector<uint32_t> depths; // 0 for roots
+
+        // node indices ordered by depth & where each depth starts among them, rebuilt once nodes
+        // were added: a node's world matrix needs only the level above, so a level runs in parallel
+        std::vector<uint32_t> levelNodes;
+        std::vector<size_t> levelStarts;
+        bool levelsStale;
+
+        // local translation, rotation & scale, one array per component
+        std::vector<float> tx, ty, tz;
+        std::vector<float> rx, ry, rz, rw;
+        std::vector<float> sx, sy, sz;
+
+        std::vector<uint8_t> dirty;
+        bool anyDirty;
+
+        std::vector<glm::mat4> localMatrices;
+        std::vector<glm::mat4> worldMatrices;
+
+        glm::mat4 composeLocal(size_t i);
+
+        void composeBatch(size_t begin, size_t end);
+        void updateWorld(size_t i, bool batched);
+        void buildLevels();
+};
\ No newline at end of file
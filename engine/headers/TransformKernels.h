@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <glm/glm.hpp>
+
+// translation, rotation quaternion & scale as one array per component
+struct TransformStreams
+{
+    const float *tx, *ty, *tz;
+    const float *rx, *ry, *rz, *rw;
+    const float *sx, *sy, *sz;
+};
+
+// writes count column-major 4x4 matrices (16 floats each) to out, which may be a
+// mapped buffer; with viewProjection set the result is viewProjection * T * R * S.
+// picks the widest of AVX-512, AVX2 or SSE the CPU supports on first use
+void ComposeTransforms(const TransformStreams &in, size_t count, float *out, const glm::mat4 *viewProjection);
+
+// forces "scalar", "sse", "avx2" or "avx512", false if the CPU lacks it; NULL goes back to the
+// automatic choice. not thread safe, meant for benchmarks & tests comparing the kernels
+bool SetTransformKernel(const char *name);
+
+const char* GetTransformKernelName();
\ No newline at end of file
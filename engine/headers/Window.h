@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "InputQueue.h"
+#include "Profiler.h"
+
+enum WindowBackend
+{
+    WINDOW_GLFW, // visible window with keyboard & mouse input
+    WINDOW_EGL_PBUFFER, // offscreen, EGL context on a tiny pbuffer
+    WINDOW_EGL_SURFACELESS // offscreen, Mesa surfaceless platform, needs no display or GPU
+};
+
+class Window
+{
+    public:
+        Window();
+        Window(GLint windowWidth, GLint windowHeight);
+
+        int Initialise(WindowBackend windowBackend = WINDOW_GLFW);
+
+        GLfloat getBufferWidth() { return bufferWidth; }
+        GLfloat getBufferHeight() { return bufferHeight; }
+
+        bool isHeadless() { return backend != WINDOW_GLFW; }
+
+        // offscreen backends render into this framebuffer object, 0 when windowed
+        GLuint getFramebuffer() { return framebuffer; }
+
+        bool getShouldClose();
+        void setShouldClose(bool shouldClose);
+
+        InputQueue& getInputQueue() { return inputQueue; }
+
+        void pollEvents();
+        double getTime();
+
+        void makeContextCurrent(bool current);
+        void setSwapInterval(int interval);
+        void setTitle(const char *title);
+        void swapBuffers();
+
+        ~Window();
+
+    private:
+        WindowBackend backend;
+
+        GLFWwindow *mainWindow;
+
+        EGLDisplay eglDisplay;
+        EGLSurface eglSurface;
+        EGLContext eglContext;
+
+        GLuint framebuffer, colourBuffer, depthBuffer;
+        bool closeRequested;
+        std::chrono::steady_clock::time_point startTime;
+
+        GLint width, height;
+        GLint bufferWidth, bufferHeight;
+
+        // every key, button & cursor event in arrival order, consumed by Camera
+        InputQueue inputQueue;
+
+        double lastX, lastY;
+        bool mouseFirstMoved;
+
+        int initialiseHeadless();
+        void clearHeadless();
+
+        void createCallbacks();
+        static void handleKeys(GLFWwindow *window, int key, int code, int action, int mode);
+        static void handleMouse(GLFWwindow *window, double xPos, double yPos);
+        static void handleButtons(GLFWwindow *window, int button, int action, int mode);
+};
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "MultiViewRenderer.h"
+#include "Profiler.h"
+
+enum ChunkState
+{
+    CHUNK_UNLOADED,
+    CHUNK_LOADING, // queued or running on the job system
+    CHUNK_LOADED, // vertices in system memory, waiting for upload budget
+    CHUNK_RESIDENT // on the GPU, drawn & subject to eviction
+};
+
+// A world larger than GPU memory, cut into a square grid of chunks on the XZ plane. Every frame
+// the chunks around the camera are ranked by distance, weighted towards the camera's front, and
+// around where its velocity will take it PREFETCH_MS from now. The best ranked are loaded on
+// the job system, uploaded under a per-frame byte budget and evicted least recently used first
+// once the GPU cache is over its budget.
+//
+// Chunk contents are generated, a procedural heightfield standing in for data read from disk.
+class WorldStreamer
+{
+    public:
+        static const int CHUNK_RESOLUTION = 64; // quads along each side of a chunk
+        static const int MAX_LOADS_IN_FLIGHT = 8;
+        static const size_t LATENCY_HISTOGRAM_SIZE = 64; // buckets of LATENCY_BUCKET_MS, the last one catches the rest
+        static const int LATENCY_BUCKET_MS = 2;
+        static const int PREFETCH_MS = 750; // how far ahead along the camera's velocity chunks are requested
+
+        WorldStreamer();
+
+        // chunksAcross x chunksAcross chunks of chunkSize units centred on the origin; budgets in bytes
+        bool Initialise(JobSystem *jobSystem, int chunksAcross, GLfloat chunkSize, GLfloat loadRadius, size_t cacheBudget, size_t uploadBudgetPerFrame);
+        void Shutdown();
+
+        bool isEnabled() { return chunks != NULL; }
+
+        // GL thread, once per frame: ranks chunks from the camera in the view matrix, starts loads, uploads & evicts
+        void update(const glm::mat4 &view);
+
+        // the resident chunks, drawn with the renderer's own shader
+        void appendRenderObjects(std::vector<RenderObject> &objects);
+
+        // loads are running or the last update created or freed buffers, both allocate
+        bool isStreaming() { return pendingLoads.value.load(std::memory_order_acquire) > 0 || streamedLastUpdate.load(std::memory_order_relaxed); }
+
+        size_t getResidentBytes() { return residentBytes; }
+        size_t getResidentCount() { return residentCount; }
+        double getHitRate() { return hits + misses > 0 ? (double)hits / (hits + misses) : 1.0; }
+        double getMeanLoadLatency() { return latencyCount > 0 ? latencyTotal / latencyCount : 0.0; }
+        double getLoadLatencyPercentile(double fraction);
+
+        void printStatistics();
+
+        ~WorldStreamer();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Chunk;
+
+        struct LoadJob
+        {
+            WorldStreamer *streamer;
+            Chunk *chunk;
+        };
+
+        struct Chunk
+        {
+            std::atomic<int> state;
+
+            glm::vec3 origin; // corner of the chunk, the vertices are relative to it
+            glm::vec3 centre;
+            GLfloat radius;
+
+            std::vector<GLfloat> vertices; // only between loading & upload
+            Mesh mesh;
+
+            GLfloat priority; // lower loads first, only meaningful while ranked
+            uint64_t lastUsedFrame; // last frame the chunk was ranked, around the camera or ahead of it
+            bool needed; // within the load radius of the camera itself this frame
+            Clock::time_point requestTime;
+
+            LoadJob loadJob;
+        };
+
+        JobSystem *jobs;
+
+        Chunk *chunks;
+        int chunksAcross;
+        GLfloat chunkSize, loadRadius;
+
+        std::vector<unsigned int> indices; // the same grid of triangles for every chunk
+        size_t chunkBytes; // vertex & index buffer of one resident chunk
+
+        std::vector<uint32_t> candidates; // chunks ranked this frame, best first
+
+        JobCounter pendingLoads;
+        int loadsInFlight;
+
+        size_t budget, uploadBudget;
+        size_t residentBytes, residentCount;
+        uint64_t frame;
+        std::atomic<bool> streamedLastUpdate; // read by the main thread while a render thread updates
+
+        // camera motion, for prefetching
+        glm::vec3 lastPosition, velocity;
+        Clock::time_point lastUpdate;
+        bool hasLastPosition;
+
+        // needed chunks that were, or weren't, resident when the frame was drawn
+        uint64_t hits, misses;
+
+        // request to residency, in seconds
+        double latencyTotal, latencyMax;
+        size_t latencyCount;
+        size_t latencyHistogram[LATENCY_HISTOGRAM_SIZE];
+
+        size_t loadCount, evictionCount, discardCount;
+
+        static void loadJob(void *data, size_t begin, size_t end);
+
+        void generate(Chunk &chunk);
+        GLfloat height(GLfloat x, GLfloat z);
+
+        void rank(glm::vec3 position, glm::vec3 front, glm::vec3 predicted);
+        void startLoads();
+        void uploadChunks();
+        bool makeRoom(size_t bytes);
+        void evict(Chunk &chunk);
+};
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "../headers/Camera.h"
+
+Camera::Camera()
+{
+    position = glm::vec3(0.0f, 0.0f, 0.0f);
+    worldUp = glm::vec3(0.0f, 1.0f, 0.0f);
+    yaw = -90.0f;
+    pitch = 0.0f;
+    front = glm::vec3(0.0f, 0.0f, -1.0f);
+
+    moveSpeed = 5.0f;
+    turnSpeed = 1.0f;
+
+    smoothing = 0.0f;
+    orientationDirty = true;
+    settling = false;
+
+    for (size_t i = 0; i < 1024; i++)
+    {
+        heldKeys[i] = false;
+        frameKeys[i] = false;
+    }
+
+    frameXChange = 0.0f;
+    frameYChange = 0.0f;
+
+    update(0.0f);
+}
+
+Camera::Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLfloat startPitch, GLfloat startMoveSpeed, GLfloat startTurnSpeed)
+{
+    position = startPosition;
+    worldUp = startUp;
+    yaw = startYaw;
+    pitch = startPitch;
+    front = glm::vec3(0.0f, 0.0f, -1.0f);
+
+    moveSpeed = startMoveSpeed;
+    turnSpeed = startTurnSpeed;
+
+    smoothing = 0.0f;
+    orientationDirty = true;
+    settling = false;
+
+    for (size_t i = 0; i < 1024; i++)
+    {
+        heldKeys[i] = false;
+        frameKeys[i] = false;
+    }
+
+    frameXChange = 0.0f;
+    frameYChange = 0.0f;
+
+    update(0.0f);
+}
+
+void Camera::keyControl(bool *keys, GLfloat deltaTime)
+{
+    // advance the smoothed orientation first so movement follows the current view
+    update(deltaTime);
+
+    GLfloat velocity = moveSpeed * deltaTime;
+
+    if (keys[GLFW_KEY_W])
+        position += front * velocity;
+
+    if (keys[GLFW_KEY_S])
+        position -= front * velocity;
+
+    if (keys[GLFW_KEY_A])
+        position -= right * velocity;
+
+    if (keys[GLFW_KEY_D])
+        position += right * velocity;
+}
+
+void Camera::mouseControl(GLfloat xChange, GLfloat yChange)
+{
+    xChange *= turnSpeed;
+    yChange *= turnSpeed;
+
+    yaw += xChange;
+    pitch += yChange;
+
+    if (pitch > 89.0f)
+        pitch = 89.0f;
+
+    if (pitch < -89.0f)
+        pitch = -89.0f;
+
+    // the quaternion is rebuilt once per frame no matter how many events arrive
+    orientationDirty = true;
+}
+
+void Camera::eventControl(InputQueue &queue, GLfloat deltaTime)
+{
+    // a key pressed at any point during the frame counts as down for the whole
+    // frame, so a tap shorter than a frame still moves the camera
+    for (size_t i = 0; i < 1024; i++)
+        frameKeys[i] = heldKeys[i];
+
+    GLfloat xChange = 0.0f;
+    GLfloat yChange = 0.0f;
+
+    // never drain more than one queue's worth, events arriving meanwhile wait for the next frame
+    InputEvent event;
+    size_t remaining = InputQueue::CAPACITY;
+
+    while (remaining-- > 0 && queue.pop(event))
+    {
+        if (event.type == INPUT_MOTION)
+        {
+            xChange += event.xChange;
+            yChange += event.yChange;
+        }
+        else if (event.type == INPUT_KEY && event.code >= 0 && event.code < 1024)
+        {
+            if (event.action == GLFW_PRESS)
+            {
+                heldKeys[event.code] = true;
+                frameKeys[event.code] = true;
+            }
+            else if (event.action == GLFW_RELEASE)
+            {
+                heldKeys[event.code] = false;
+            }
+        }
+    }
+
+    frameXChange = xChange;
+    frameYChange = yChange;
+
+    mouseControl(xChange, yChange);
+    keyControl(frameKeys, deltaTime);
+}
+
+void Camera::setOrientation(glm::quat newOrientation)
+{
+    orientation = glm::normalize(newOrientation);
+    targetOrientation = orientation;
+
+    // recover yaw & pitch so mouse input continues from the new orientation
+    glm::vec3 newFront = orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+    pitch = glm::degrees(asin(glm::clamp(newFront.y, -1.0f, 1.0f)));
+    yaw = glm::degrees(atan2(newFront.z, newFront.x));
+
+    orientationDirty = false;
+    settling = true;
+
+    update(0.0f);
+}
+
+void Camera::followPath(const glm::vec3 *positions, const glm::quat *orientations, size_t count, GLfloat t)
+{
+    if (count == 0)
+        return;
+
+    // t runs from 0 to count - 1, the integer part selects the path segment
+    t = glm::clamp(t, 0.0f, (GLfloat)(count - 1));
+
+    size_t segment = (size_t)t;
+    if (segment >= count - 1)
+        segment = count > 1 ? count - 2 : 0;
+
+    size_t next = count > 1 ? segment + 1 : 0;
+    GLfloat amount = t - (GLfloat)segment;
+
+    position = glm::mix(positions[segment], positions[next], amount);
+    setOrientation(glm::slerp(orientations[segment], orientations[next], amount));
+}
+
+glm::mat4 Camera::calculateViewMatrix()
+{
+    // picks up any mouse input not yet applied by keyControl
+    update(0.0f);
+
+    return glm::lookAt(position, position + front, up);
+}
+
+glm::quat Camera::eulerToQuat(GLfloat yawDegrees, GLfloat pitchDegrees)
+{
+    // yaw about the world up axis, then pitch about the local right axis,
+    // matching front = (cos(yaw) * cos(pitch), sin(pitch), sin(yaw) * cos(pitch))
+    glm::quat yawRotation = glm::angleAxis(glm::radians(-yawDegrees), worldUp);
+    glm::quat pitchRotation = glm::angleAxis(glm::radians(pitchDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    return yawRotation * pitchRotation;
+}
+
+void Camera::update(GLfloat deltaTime)
+{
+    if (orientationDirty)
+    {
+        targetOrientation = eulerToQuat(yaw, pitch);
+        orientationDirty = false;
+        settling = true;
+    }
+
+    if (!settling)
+        return;
+
+    if (smoothing > 0.0f)
+    {
+        // frame rate independent exponential approach towards the target
+        GLfloat amount = 1.0f - exp(-smoothing * deltaTime);
+        orientation = glm::normalize(glm::slerp(orientation, targetOrientation, amount));
+
+        if (fabs(glm::dot(orientation, targetOrientation)) > 1.0f - 1e-6f)
+        {
+            orientation = targetOrientation;
+            settling = false;
+        }
+    }
+    else
+    {
+        orientation = targetOrientation;
+        settling = false;
+    }
+
+    // columns of the rotation matrix are the rotated x, y & z axes
+    glm::mat3 basis = glm::mat3_cast(orientation);
+
+    front = basis[0];
+    up = basis[1];
+    right = basis[2];
+}
+
+Camera::~Camera()
+{
+
+}
\ No newline at end of file
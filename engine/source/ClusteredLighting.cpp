@@ -0,0 +1,442 @@
+#include "../headers/ClusteredLighting.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+ClusteredLighting::ClusteredLighting()
+{
+    jobs = NULL;
+
+    lightCount = 0;
+    lightSource = NULL;
+    dropped = 0;
+
+    clusterView = glm::mat4(1.0f);
+    xScale = 1.0f;
+    yScale = 1.0f;
+    nearPlane = 0.1f;
+    farPlane = 100.0f;
+    sliceScale = 0.0f;
+    sliceBias = 0.0f;
+
+    for (uint32_t k = 0; k <= CLUSTERS_Z; k++)
+        sliceStarts[k] = 0.0f;
+
+    for (int i = 0; i < 3; i++)
+    {
+        buffers[i] = 0;
+        textures[i] = 0;
+    }
+
+    grid.assign(CLUSTER_COUNT * 2, 0);
+}
+
+bool ClusteredLighting::Initialise()
+{
+    const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+
+    for (int i = 0; i < 3; i++)
+    {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+
+        // the texture keeps pointing at the buffer when upload() replaces its storage
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+    }
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        printf("Failed to create the light texture buffers \n");
+        return false;
+    }
+
+    return true;
+}
+
+void ClusteredLighting::bin(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection)
+{
+    PROFILE_SCOPE("light binning");
+
+    lightCount = lights.size();
+    lightSource = lights.data();
+
+    // perspective parameters straight from the projection matrix
+    clusterView = view;
+    xScale = projection[0][0];
+    yScale = projection[1][1];
+    nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+
+    GLfloat logRange = logf(farPlane / nearPlane);
+    sliceScale = CLUSTERS_Z / logRange;
+    sliceBias = -(GLfloat)CLUSTERS_Z * logf(nearPlane) / logRange;
+
+    for (uint32_t k = 0; k <= CLUSTERS_Z; k++)
+        sliceStarts[k] = nearPlane * powf(farPlane / nearPlane, (GLfloat)k / CLUSTERS_Z);
+
+    lightData.resize(lightCount * 2);
+    bounds.resize(lightCount);
+
+    bool parallel = jobs != NULL && lightCount >= PARALLEL_BIN_THRESHOLD;
+
+    // cluster ranges per light, then every depth slice builds its own part of the grid
+    if (parallel)
+        jobs->parallelFor(lightCount, 0, [&](size_t begin, size_t end) { boundLights(begin, end); });
+    else
+        boundLights(0, lightCount);
+
+    // most lights span a slice or two, so bucketing once is cheaper than every slice scanning all of them
+    for (uint32_t slice = 0; slice < CLUSTERS_Z; slice++)
+        sliceLights[slice].clear();
+
+    for (size_t i = 0; i < lightCount; i++)
+    {
+        for (uint32_t slice = bounds[i].z0; slice <= bounds[i].z1; slice++)
+            sliceLights[slice].push_back(i);
+    }
+
+    if (parallel)
+    {
+        jobs->parallelFor(CLUSTERS_Z, 1, [&](size_t begin, size_t end) {
+            for (size_t slice = begin; slice < end; slice++)
+                fillSlice(slice);
+        });
+    }
+    else
+    {
+        for (uint32_t slice = 0; slice < CLUSTERS_Z; slice++)
+            fillSlice(slice);
+    }
+
+    // concatenate the slice lists, clusters past MAX_LIGHT_INDICES lose their lights
+    size_t total = 0;
+
+    for (uint32_t slice = 0; slice < CLUSTERS_Z; slice++)
+        total += sliceIndices[slice].size();
+
+    size_t kept = total < MAX_LIGHT_INDICES ? total : MAX_LIGHT_INDICES;
+    dropped = total - kept;
+
+    // headroom, so lights moving between clusters don't reallocate every few frames
+    if (indices.capacity() < kept)
+        indices.reserve(kept + kept / 4);
+
+    indices.resize(kept);
+
+    size_t base = 0;
+
+    for (uint32_t slice = 0; slice < CLUSTERS_Z; slice++)
+    {
+        uint32_t *sliceGrid = &grid[slice * CLUSTERS_X * CLUSTERS_Y * 2];
+
+        for (uint32_t c = 0; c < CLUSTERS_X * CLUSTERS_Y; c++)
+        {
+            size_t offset = sliceGrid[c * 2] + base;
+            size_t count = sliceGrid[c * 2 + 1];
+
+            if (offset + count > kept)
+                count = offset < kept ? kept - offset : 0;
+
+            sliceGrid[c * 2] = offset < kept ? offset : 0;
+            sliceGrid[c * 2 + 1] = count;
+        }
+
+        size_t copied = sliceIndices[slice].size();
+
+        if (base + copied > kept)
+            copied = base < kept ? kept - base : 0;
+
+        if (copied > 0)
+            memcpy(&indices[base], sliceIndices[slice].data(), copied * sizeof(uint32_t));
+
+        base += sliceIndices[slice].size();
+    }
+}
+
+void ClusteredLighting::boundLights(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        const PointLight &light = lightSource[i];
+
+        lightData[i * 2] = glm::vec4(light.position, light.radius);
+        lightData[i * 2 + 1] = glm::vec4(light.colour * light.intensity, 0.0f);
+    }
+
+    size_t i = begin;
+
+#if defined(__SSE2__)
+    // four lights per iteration, the scalar loop below takes the remainder
+    const __m128 m00 = _mm_set1_ps(clusterView[0][0]), m10 = _mm_set1_ps(clusterView[1][0]), m20 = _mm_set1_ps(clusterView[2][0]), m30 = _mm_set1_ps(clusterView[3][0]);
+    const __m128 m01 = _mm_set1_ps(clusterView[0][1]), m11 = _mm_set1_ps(clusterView[1][1]), m21 = _mm_set1_ps(clusterView[2][1]), m31 = _mm_set1_ps(clusterView[3][1]);
+    const __m128 m02 = _mm_set1_ps(-clusterView[0][2]), m12 = _mm_set1_ps(-clusterView[1][2]), m22 = _mm_set1_ps(-clusterView[2][2]), m32 = _mm_set1_ps(-clusterView[3][2]);
+
+    const __m128 nearSplat = _mm_set1_ps(nearPlane), farSplat = _mm_set1_ps(farPlane);
+    const __m128 xScaleSplat = _mm_set1_ps(xScale), yScaleSplat = _mm_set1_ps(yScale);
+    const __m128 one = _mm_set1_ps(1.0f), minusOne = _mm_set1_ps(-1.0f), half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps();
+    const __m128 tilesX = _mm_set1_ps((GLfloat)CLUSTERS_X), tilesY = _mm_set1_ps((GLfloat)CLUSTERS_Y);
+    const __m128 lastX = _mm_set1_ps((GLfloat)(CLUSTERS_X - 1)), lastY = _mm_set1_ps((GLfloat)(CLUSTERS_Y - 1));
+
+    for (; i + 4 <= end; i += 4)
+    {
+        const PointLight *l = lightSource + i;
+
+        __m128 x = _mm_setr_ps(l[0].position.x, l[1].position.x, l[2].position.x, l[3].position.x);
+        __m128 y = _mm_setr_ps(l[0].position.y, l[1].position.y, l[2].position.y, l[3].position.y);
+        __m128 z = _mm_setr_ps(l[0].position.z, l[1].position.z, l[2].position.z, l[3].position.z);
+        __m128 r = _mm_setr_ps(l[0].radius, l[1].radius, l[2].radius, l[3].radius);
+
+        __m128 vx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_add_ps(_mm_mul_ps(m20, z), m30));
+        __m128 vy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_add_ps(_mm_mul_ps(m21, z), m31));
+        __m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_add_ps(_mm_mul_ps(m22, z), m32));
+
+        __m128 depthMin = _mm_sub_ps(depth, r);
+        __m128 depthMax = _mm_add_ps(depth, r);
+        __m128 visible = _mm_and_ps(_mm_cmpgt_ps(depthMax, nearSplat), _mm_cmplt_ps(depthMin, farSplat));
+
+        // x / depth is monotonic over the sphere's depth range, so its ends bound the projection
+        __m128 nearest = _mm_max_ps(depthMin, nearSplat);
+        __m128 farthest = _mm_max_ps(depthMax, nearest);
+        __m128 inverseNear = _mm_div_ps(one, nearest);
+        __m128 inverseFar = _mm_div_ps(one, farthest);
+
+        __m128 left = _mm_mul_ps(xScaleSplat, _mm_sub_ps(vx, r));
+        __m128 right = _mm_mul_ps(xScaleSplat, _mm_add_ps(vx, r));
+        __m128 bottom = _mm_mul_ps(yScaleSplat, _mm_sub_ps(vy, r));
+        __m128 top = _mm_mul_ps(yScaleSplat, _mm_add_ps(vy, r));
+
+        __m128 x0 = _mm_min_ps(_mm_mul_ps(left, inverseNear), _mm_mul_ps(left, inverseFar));
+        __m128 x1 = _mm_max_ps(_mm_mul_ps(right, inverseNear), _mm_mul_ps(right, inverseFar));
+        __m128 y0 = _mm_min_ps(_mm_mul_ps(bottom, inverseNear), _mm_mul_ps(bottom, inverseFar));
+        __m128 y1 = _mm_max_ps(_mm_mul_ps(top, inverseNear), _mm_mul_ps(top, inverseFar));
+
+        visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmpge_ps(x1, minusOne), _mm_cmple_ps(x0, one)));
+        visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmpge_ps(y1, minusOne), _mm_cmple_ps(y0, one)));
+
+        // normalised device coordinates to tiles, clamped before truncating so it acts as floor
+        __m128i tileX0 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(x0, half), half), tilesX), zero), lastX));
+        __m128i tileX1 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(x1, half), half), tilesX), zero), lastX));
+        __m128i tileY0 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(y0, half), half), tilesY), zero), lastY));
+        __m128i tileY1 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(y1, half), half), tilesY), zero), lastY));
+
+        // a depth's slice is the number of slice starts at or before it, exact without a log per light
+        __m128i slice0 = _mm_setzero_si128();
+        __m128i slice1 = _mm_setzero_si128();
+
+        for (uint32_t k = 1; k < CLUSTERS_Z; k++)
+        {
+            __m128 start = _mm_set1_ps(sliceStarts[k]);
+
+            slice0 = _mm_sub_epi32(slice0, _mm_castps_si128(_mm_cmple_ps(start, nearest)));
+            slice1 = _mm_sub_epi32(slice1, _mm_castps_si128(_mm_cmple_ps(start, depthMax)));
+        }
+
+        int32_t values[6][4];
+        _mm_storeu_si128((__m128i*)values[0], tileX0);
+        _mm_storeu_si128((__m128i*)values[1], tileX1);
+        _mm_storeu_si128((__m128i*)values[2], tileY0);
+        _mm_storeu_si128((__m128i*)values[3], tileY1);
+        _mm_storeu_si128((__m128i*)values[4], slice0);
+        _mm_storeu_si128((__m128i*)values[5], slice1);
+
+        int visibleMask = _mm_movemask_ps(visible);
+
+        for (int lane = 0; lane < 4; lane++)
+        {
+            LightBounds &b = bounds[i + lane];
+
+            if (visibleMask & (1 << lane))
+            {
+                b.x0 = values[0][lane];
+                b.x1 = values[1][lane];
+                b.y0 = values[2][lane];
+                b.y1 = values[3][lane];
+                b.z0 = values[4][lane];
+                b.z1 = values[5][lane];
+            }
+            else
+            {
+                b.x0 = b.x1 = b.y0 = b.y1 = 0;
+                b.z0 = 1;
+                b.z1 = 0;
+            }
+        }
+    }
+#endif
+
+    for (; i < end; i++)
+        boundLight(i);
+}
+
+void ClusteredLighting::boundLight(size_t i)
+{
+    const PointLight &light = lightSource[i];
+    LightBounds &b = bounds[i];
+
+    glm::vec4 viewPosition = clusterView * glm::vec4(light.position, 1.0f);
+    GLfloat depth = -viewPosition.z;
+    GLfloat depthMin = depth - light.radius, depthMax = depth + light.radius;
+
+    GLfloat nearest = fmax(depthMin, nearPlane);
+    GLfloat farthest = fmax(depthMax, nearest);
+
+    GLfloat left = xScale * (viewPosition.x - light.radius), right = xScale * (viewPosition.x + light.radius);
+    GLfloat bottom = yScale * (viewPosition.y - light.radius), top = yScale * (viewPosition.y + light.radius);
+
+    GLfloat x0 = fmin(left / nearest, left / farthest), x1 = fmax(right / nearest, right / farthest);
+    GLfloat y0 = fmin(bottom / nearest, bottom / farthest), y1 = fmax(top / nearest, top / farthest);
+
+    if (depthMax <= nearPlane || depthMin >= farPlane || x1 < -1.0f || x0 > 1.0f || y1 < -1.0f || y0 > 1.0f)
+    {
+        b.x0 = b.x1 = b.y0 = b.y1 = 0;
+        b.z0 = 1;
+        b.z1 = 0;
+        return;
+    }
+
+    b.x0 = (uint8_t)fmin(fmax((x0 * 0.5f + 0.5f) * CLUSTERS_X, 0.0f), CLUSTERS_X - 1);
+    b.x1 = (uint8_t)fmin(fmax((x1 * 0.5f + 0.5f) * CLUSTERS_X, 0.0f), CLUSTERS_X - 1);
+    b.y0 = (uint8_t)fmin(fmax((y0 * 0.5f + 0.5f) * CLUSTERS_Y, 0.0f), CLUSTERS_Y - 1);
+    b.y1 = (uint8_t)fmin(fmax((y1 * 0.5f + 0.5f) * CLUSTERS_Y, 0.0f), CLUSTERS_Y - 1);
+
+    b.z0 = 0;
+    b.z1 = 0;
+
+    for (uint32_t k = 1; k < CLUSTERS_Z; k++)
+    {
+        b.z0 += sliceStarts[k] <= nearest;
+        b.z1 += sliceStarts[k] <= depthMax;
+    }
+}
+
+void ClusteredLighting::fillSlice(uint32_t slice)
+{
+    PROFILE_SCOPE("light slice");
+
+    const std::vector<uint32_t> &lights = sliceLights[slice];
+    std::vector<uint32_t> &list = sliceIndices[slice];
+
+    uint32_t counts[CLUSTERS_X * CLUSTERS_Y];
+    memset(counts, 0, sizeof(counts));
+
+    // count first so every cluster gets a contiguous run of the slice's list
+    for (size_t l = 0; l < lights.size(); l++)
+    {
+        const LightBounds &b = bounds[lights[l]];
+
+        for (uint32_t y = b.y0; y <= b.y1; y++)
+            for (uint32_t x = b.x0; x <= b.x1; x++)
+                counts[y * CLUSTERS_X + x]++;
+    }
+
+    uint32_t *sliceGrid = &grid[slice * CLUSTERS_X * CLUSTERS_Y * 2];
+    uint32_t offset = 0;
+
+    for (uint32_t c = 0; c < CLUSTERS_X * CLUSTERS_Y; c++)
+    {
+        sliceGrid[c * 2] = offset;
+        sliceGrid[c * 2 + 1] = counts[c];
+
+        offset += counts[c];
+        counts[c] = sliceGrid[c * 2]; // reused as the write cursor
+    }
+
+    if (list.capacity() < offset)
+        list.reserve(offset + offset / 4);
+
+    list.resize(offset);
+
+    for (size_t l = 0; l < lights.size(); l++)
+    {
+        const LightBounds &b = bounds[lights[l]];
+
+        for (uint32_t y = b.y0; y <= b.y1; y++)
+            for (uint32_t x = b.x0; x <= b.x1; x++)
+                list[counts[y * CLUSTERS_X + x]++] = lights[l];
+    }
+}
+
+void ClusteredLighting::upload()
+{
+    PROFILE_SCOPE("light upload");
+
+    const void *data[3] = { lightData.data(), grid.data(), indices.data() };
+    size_t sizes[3] = { lightData.size() * sizeof(glm::vec4), grid.size() * sizeof(uint32_t), indices.size() * sizeof(uint32_t) };
+
+    for (int i = 0; i < 3; i++)
+    {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+
+        // fresh storage every frame, so the driver never waits for the previous frame's draws
+        if (sizes[i] > 0)
+            glBufferData(GL_TEXTURE_BUFFER, sizes[i], data[i], GL_STREAM_DRAW);
+        else
+            glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+
+        renderStats.add(COUNTER_UPLOAD_BYTES, sizes[i]);
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusteredLighting::bind(Shader *shader, GLuint firstUnit)
+{
+    shader->UseShader();
+
+    glUniform1i(shader->GetUniformLocation("lightData"), firstUnit);
+    glUniform1i(shader->GetUniformLocation("clusterGrid"), firstUnit + 1);
+    glUniform1i(shader->GetUniformLocation("lightIndices"), firstUnit + 2);
+
+    glUniform3ui(shader->GetUniformLocation("clusterCount"), CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z);
+    glUniformMatrix4fv(shader->GetUniformLocation("clusterView"), 1, GL_FALSE, glm::value_ptr(clusterView));
+    glUniform2f(shader->GetUniformLocation("clusterScale"), xScale, yScale);
+    glUniform2f(shader->GetUniformLocation("clusterSlices"), sliceScale, sliceBias);
+
+    renderStats.add(COUNTER_UNIFORM_UPLOADS, 7);
+
+    for (int i = 0; i < 3; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+}
+
+uint32_t ClusteredLighting::getMaxLightsPerCluster()
+{
+    uint32_t most = 0;
+
+    for (size_t c = 0; c < CLUSTER_COUNT; c++)
+        most = grid[c * 2 + 1] > most ? grid[c * 2 + 1] : most;
+
+    return most;
+}
+
+void ClusteredLighting::Shutdown()
+{
+    if (textures[0] != 0)
+    {
+        glDeleteTextures(3, textures);
+        glDeleteBuffers(3, buffers);
+
+        for (int i = 0; i < 3; i++)
+        {
+            textures[i] = 0;
+            buffers[i] = 0;
+        }
+    }
+}
+
+ClusteredLighting::~ClusteredLighting()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "../headers/CommandBuffer.h"
+
+template <typename T>
+static inline T read(const uint8_t *&cursor)
+{
+    T payload;
+    memcpy(&payload, cursor, sizeof(T));
+    cursor += sizeof(T);
+
+    return payload;
+}
+
+CommandBuffer::CommandBuffer()
+{
+    used = 0;
+    commandCount = 0;
+}
+
+void CommandBuffer::replay(ReplayState &state) const
+{
+    const uint8_t *cursor = bytes.data();
+    const uint8_t *end = cursor + used;
+
+    // counted locally and published once, keeping atomics out of the dispatch loop
+    uint64_t counts[COUNTER_COUNT] = { 0 };
+
+    while (cursor < end)
+    {
+        uint8_t type = *cursor++;
+
+        switch (type)
+        {
+            case COMMAND_VIEWPORT:
+            {
+                ViewportCommand command = read<ViewportCommand>(cursor);
+                glViewport(command.x, command.y, command.width, command.height);
+                break;
+            }
+            case COMMAND_USE_PROGRAM:
+            {
+                GLuint program = read<GLuint>(cursor);
+
+                if (program != state.program)
+                {
+                    glUseProgram(program);
+                    state.program = program;
+                    counts[COUNTER_PROGRAM_BINDS]++;
+                }
+                break;
+            }
+            case COMMAND_UNIFORM_MATRIX:
+            {
+                UniformMatrixCommand command = read<UniformMatrixCommand>(cursor);
+                glUniformMatrix4fv(command.location, 1, GL_FALSE, command.value);
+                counts[COUNTER_UNIFORM_UPLOADS]++;
+                break;
+            }
+            case COMMAND_UNIFORM_UINT:
+            {
+                UniformUintCommand command = read<UniformUintCommand>(cursor);
+                glUniform1ui(command.location, command.value);
+                counts[COUNTER_UNIFORM_UPLOADS]++;
+                break;
+            }
+            case COMMAND_BIND_MESH:
+            {
+                BindMeshCommand command = read<BindMeshCommand>(cursor);
+
+                // Mesh leaves no index buffer recorded in its vertex array, so both are bound
+                if (command.vao != state.vao)
+                {
+                    glBindVertexArray(command.vao);
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, command.ibo);
+                    state.vao = command.vao;
+                    counts[COUNTER_VAO_BINDS]++;
+                }
+                break;
+            }
+            case COMMAND_DRAW:
+            {
+                GLsizei indexCount = read<GLsizei>(cursor);
+                glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+                counts[COUNTER_DRAW_CALLS]++;
+                counts[COUNTER_INDICES] += indexCount;
+                break;
+            }
+            case COMMAND_DRAW_INSTANCED:
+            {
+                DrawInstancedCommand command = read<DrawInstancedCommand>(cursor);
+                glDrawElementsInstanced(GL_TRIANGLES, command.indexCount, GL_UNSIGNED_INT, 0, command.instanceCount);
+                counts[COUNTER_DRAW_CALLS]++;
+                counts[COUNTER_INDICES] += (uint64_t)command.indexCount * command.instanceCount;
+                break;
+            }
+            default:
+                printf("Unknown command %d in command buffer \n", type);
+                cursor = end;
+                break;
+        }
+    }
+
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        if (counts[c])
+            renderStats.add((RenderCounter)c, counts[c]);
+    }
+}
+
+CommandBuffer::~CommandBuffer()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "../headers/DebugDraw.h"
+
+#ifdef ENABLE_DEBUG_DRAW
+
+DebugDraw debugDraw;
+
+// the calling thread's arrays, created the first time it draws
+static thread_local DebugDrawThread *threadState = NULL;
+
+static const size_t COPY_GRAIN = 65536; // vertices per job when the merge is split up
+
+// the 12 edges of a box from its corners, corner i at the far end of each axis whose bit is set
+static void appendEdges(DebugVertex *out, const glm::vec3 *corners, uint32_t colour)
+{
+    for (int corner = 0; corner < 8; corner++)
+    {
+        for (int axis = 1; axis < 8; axis <<= 1)
+        {
+            if (corner & axis)
+                continue;
+
+            out[0].position = corners[corner];
+            out[0].colour = colour;
+            out[1].position = corners[corner | axis];
+            out[1].colour = colour;
+            out += 2;
+        }
+    }
+}
+
+DebugDraw::DebugDraw()
+{
+    jobs = NULL;
+
+    for (int i = 0; i < SPHERE_SEGMENTS; i++)
+    {
+        GLfloat angle = glm::radians(360.0f * i / SPHERE_SEGMENTS);
+        circle[i] = glm::vec2(cos(angle), sin(angle));
+    }
+
+    shader = NULL;
+    vertexArray = 0;
+    vertexBuffer = 0;
+    bufferCapacity = 0;
+    uploadedCounts[DEBUG_DEPTH_TESTED] = 0;
+    uploadedCounts[DEBUG_OVERLAY] = 0;
+
+    uniformView = 0;
+    uniformProjection = 0;
+
+    frameCount = 0;
+    lineTotal = 0;
+    peakLines = 0;
+}
+
+bool DebugDraw::Initialise(Shader *shader)
+{
+    this->shader = shader;
+
+    glGenVertexArrays(1, &vertexArray);
+    glGenBuffers(1, &vertexBuffer);
+
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+    // the storage comes with the first upload, sized to what was drawn
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, colour));
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        printf("Failed to create the debug draw buffer \n");
+        return false;
+    }
+
+    uniformView = shader->GetViewLocation();
+    uniformProjection = shader->GetProjectionLocation();
+
+    return true;
+}
+
+DebugDrawThread* DebugDraw::registerThread()
+{
+    DebugDrawThread *thread = new DebugDrawThread();
+    thread->counts[DEBUG_DEPTH_TESTED] = 0;
+    thread->counts[DEBUG_OVERLAY] = 0;
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    threads.push_back(thread);
+
+    return thread;
+}
+
+DebugDrawThread* DebugDraw::currentThread()
+{
+    if (!threadState)
+        threadState = registerThread();
+
+    return threadState;
+}
+
+size_t DebugDraw::getThreadCount()
+{
+    std::lock_guard<std::mutex> lock(threadsMutex);
+
+    return threads.size();
+}
+
+uint32_t DebugDraw::pack(const glm::vec4 &colour)
+{
+    glm::vec4 bytes = glm::clamp(colour, 0.0f, 1.0f) * 255.0f + 0.5f;
+
+    return (uint32_t)bytes.x | ((uint32_t)bytes.y << 8) | ((uint32_t)bytes.z << 16) | ((uint32_t)bytes.w << 24);
+}
+
+DebugVertex* DebugDraw::append(DebugDrawMode mode, size_t count)
+{
+    DebugDrawThread *thread = currentThread();
+    std::vector<DebugVertex> &vertices = thread->vertices[mode];
+
+    size_t first = thread->counts[mode];
+    thread->counts[mode] = first + count;
+
+    if (first + count > vertices.size())
+        vertices.resize(std::max(first + count, vertices.size() * 2));
+
+    return &vertices[first];
+}
+
+void DebugDraw::line(const glm::vec3 &from, const glm::vec3 &to, const glm::vec4 &colour, DebugDrawMode mode)
+{
+    DebugVertex *out = append(mode, 2);
+    uint32_t packed = pack(colour);
+
+    out[0].position = from;
+    out[0].colour = packed;
+    out[1].position = to;
+    out[1].colour = packed;
+}
+
+void DebugDraw::box(const glm::vec3 &minimum, const glm::vec3 &maximum, const glm::vec4 &colour, DebugDrawMode mode)
+{
+    glm::vec3 corners[8];
+
+    for (int corner = 0; corner < 8; corner++)
+    {
+        corners[corner] = glm::vec3(corner & 1 ? maximum.x : minimum.x,
+                                    corner & 2 ? maximum.y : minimum.y,
+                                    corner & 4 ? maximum.z : minimum.z);
+    }
+
+    appendEdges(append(mode, 24), corners, pack(colour));
+}
+
+void DebugDraw::sphere(const glm::vec3 &centre, GLfloat radius, const glm::vec4 &colour, DebugDrawMode mode)
+{
+    DebugVertex *out = append(mode, SPHERE_SEGMENTS * 6);
+    uint32_t packed = pack(colour);
+
+    // a circle around each axis
+    for (int i = 0; i < SPHERE_SEGMENTS; i++)
+    {
+        glm::vec2 a = circle[i] * radius;
+        glm::vec2 b = circle[(i + 1) % SPHERE_SEGMENTS] * radius;
+
+        out[0].position = centre + glm::vec3(a.x, a.y, 0.0f);
+        out[1].position = centre + glm::vec3(b.x, b.y, 0.0f);
+        out[2].position = centre + glm::vec3(a.x, 0.0f, a.y);
+        out[3].position = centre + glm::vec3(b.x, 0.0f, b.y);
+        out[4].position = centre + glm::vec3(0.0f, a.x, a.y);
+        out[5].position = centre + glm::vec3(0.0f, b.x, b.y);
+
+        for (int v = 0; v < 6; v++)
+            out[v].colour = packed;
+
+        out += 6;
+    }
+}
+
+void DebugDraw::frustum(const glm::mat4 &viewProjection, const glm::vec4 &colour, DebugDrawMode mode)
+{
+    glm::mat4 inverse = glm::inverse(viewProjection);
+    glm::vec3 corners[8];
+
+    // the corners of clip space, back through the inverse
+    for (int corner = 0; corner < 8; corner++)
+    {
+        glm::vec4 clip(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f, 1.0f);
+        glm::vec4 world = inverse * clip;
+
+        corners[corner] = glm::vec3(world) / world.w;
+    }
+
+    appendEdges(append(mode, 24), corners, pack(colour));
+}
+
+void DebugDraw::upload()
+{
+    if (vertexBuffer == 0)
+        return;
+
+    PROFILE_SCOPE("DebugDraw::upload");
+
+    // only keeps threads from registering, the contract keeps them from drawing
+    std::lock_guard<std::mutex> lock(threadsMutex);
+
+    size_t threadCount = threads.size();
+    size_t total = 0;
+
+    offsets.resize(threadCount * DEBUG_MODE_COUNT);
+
+    for (int mode = 0; mode < DEBUG_MODE_COUNT; mode++)
+    {
+        size_t first = total;
+
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            offsets[mode * threadCount + t] = total;
+            total += threads[t]->counts[mode];
+        }
+
+        uploadedCounts[mode] = total - first;
+    }
+
+    size_t lines = total / 2;
+    size_t bytes = total * sizeof(DebugVertex);
+
+    if (total == 0)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+    // grows by doubling, so a steady frame never reallocates
+    if (total > bufferCapacity)
+    {
+        bufferCapacity = std::max(total, bufferCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(DebugVertex), NULL, GL_STREAM_DRAW);
+    }
+
+    // invalidating lets the driver hand out fresh memory instead of syncing with the last frame's draws
+    DebugVertex *vertices = (DebugVertex*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    bool intact = false;
+
+    if (vertices != NULL)
+    {
+        // the merged buffer is cut into even ranges, so one thread's million lines still copy on every worker
+        auto copyRange = [&](size_t begin, size_t end) {
+            size_t array = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+
+            while (begin < end)
+            {
+                const DebugDrawThread *source = threads[array % threadCount];
+                size_t mode = array / threadCount;
+                size_t skip = begin - offsets[array];
+                size_t count = std::min(end - begin, source->counts[mode] - skip);
+
+                if (count > 0)
+                    memcpy(vertices + begin, source->vertices[mode].data() + skip, count * sizeof(DebugVertex));
+
+                begin += count;
+                array++;
+            }
+        };
+
+        if (jobs != NULL && jobs->getThreadCount() > 1 && total > COPY_GRAIN)
+            jobs->parallelFor(total, COPY_GRAIN, copyRange);
+        else
+            copyRange(0, total);
+
+        // the contents are lost if the mapping was, skip the frame then
+        intact = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        threads[t]->counts[DEBUG_DEPTH_TESTED] = 0;
+        threads[t]->counts[DEBUG_OVERLAY] = 0;
+    }
+
+    if (!intact)
+    {
+        uploadedCounts[DEBUG_DEPTH_TESTED] = 0;
+        uploadedCounts[DEBUG_OVERLAY] = 0;
+        return;
+    }
+
+    renderStats.add(COUNTER_UPLOAD_BYTES, bytes);
+
+    frameCount++;
+    lineTotal += lines;
+    peakLines = std::max(peakLines, lines);
+}
+
+void DebugDraw::render(const glm::mat4 &view, const glm::mat4 &projection)
+{
+    GLsizei depthTested = (GLsizei)uploadedCounts[DEBUG_DEPTH_TESTED];
+    GLsizei overlay = (GLsizei)uploadedCounts[DEBUG_OVERLAY];
+
+    if (depthTested + overlay == 0)
+        return;
+
+    PROFILE_GPU_SCOPE("debug draw");
+
+    shader->UseShader();
+    glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
+
+    renderStats.add(COUNTER_UNIFORM_UPLOADS, 2);
+
+    // translucent colours blend, lines never write depth so they can't hide each other
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+
+    glBindVertexArray(vertexArray);
+    renderStats.add(COUNTER_VAO_BINDS, 1);
+
+    if (depthTested > 0)
+    {
+        glDrawArrays(GL_LINES, 0, depthTested);
+
+        renderStats.add(COUNTER_DRAW_CALLS, 1);
+        renderStats.add(COUNTER_INDICES, depthTested);
+    }
+
+    if (overlay > 0)
+    {
+        glDisable(GL_DEPTH_TEST);
+        glDrawArrays(GL_LINES, depthTested, overlay);
+        glEnable(GL_DEPTH_TEST);
+
+        renderStats.add(COUNTER_DRAW_CALLS, 1);
+        renderStats.add(COUNTER_INDICES, overlay);
+    }
+
+    glBindVertexArray(0);
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glUseProgram(0);
+}
+
+void DebugDraw::clear()
+{
+    std::lock_guard<std::mutex> lock(threadsMutex);
+
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        threads[t]->counts[DEBUG_DEPTH_TESTED] = 0;
+        threads[t]->counts[DEBUG_OVERLAY] = 0;
+    }
+}
+
+void DebugDraw::printStatistics()
+{
+    if (frameCount == 0)
+        return;
+
+    printf("debug draw %.0f lines per frame | peak %zu | %zu threads drew \n", (double)lineTotal / frameCount, peakLines, getThreadCount());
+}
+
+void DebugDraw::Shutdown()
+{
+    if (vertexBuffer != 0)
+    {
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteVertexArrays(1, &vertexArray);
+
+        vertexBuffer = 0;
+        vertexArray = 0;
+    }
+
+    bufferCapacity = 0;
+    uploadedCounts[DEBUG_DEPTH_TESTED] = 0;
+    uploadedCounts[DEBUG_OVERLAY] = 0;
+
+    clear();
+}
+
+DebugDraw::~DebugDraw()
+{
+    // threads that drew still point at their arrays, so they live as long as the debug draw
+    for (size_t t = 0; t < threads.size(); t++)
+        delete threads[t];
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "../headers/DeferredRenderer.h"
+
+DeferredRenderer::DeferredRenderer()
+{
+    depthShader = NULL;
+    geometryShader = NULL;
+    lightingShader = NULL;
+
+    width = 0;
+    height = 0;
+    framebuffer = 0;
+    outputFramebuffer = 0;
+    emptyVertexArray = 0;
+    uniformInverseViewProjection = 0;
+
+    for (int i = 0; i < 3; i++)
+        targets[i] = 0;
+
+    for (int i = 0; i < QUERY_FRAMES; i++)
+    {
+        queries[i][0] = 0;
+        queries[i][1] = 0;
+        lightingPixels[i] = 0;
+        queryIssued[i] = false;
+    }
+
+    queryIndex = 0;
+
+    frameBytes = 0;
+    totalBytes = 0;
+    measuredFrames = 0;
+}
+
+void DeferredRenderer::setShaders(Shader *depthShader, Shader *geometryShader, Shader *lightingShader)
+{
+    this->depthShader = depthShader;
+    this->geometryShader = geometryShader;
+    this->lightingShader = lightingShader;
+}
+
+bool DeferredRenderer::Initialise(GLsizei width, GLsizei height)
+{
+    this->width = width;
+    this->height = height;
+
+    const GLenum internalFormats[3] = { GL_RGBA8, GL_RG16, GL_DEPTH_COMPONENT24 };
+    const GLenum formats[3] = { GL_RGBA, GL_RG, GL_DEPTH_COMPONENT };
+    const GLenum types[3] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT };
+    const GLenum attachments[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_DEPTH_ATTACHMENT };
+
+    // an offscreen window keeps its own framebuffer bound, so it goes back afterwards
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    glGenFramebuffers(1, &framebuffer);
+    glGenTextures(3, targets);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    for (int i = 0; i < 3; i++)
+    {
+        // read with texelFetch only, so no filtering & no mip levels
+        glBindTexture(GL_TEXTURE_2D, targets[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[i], width, height, 0, formats[i], types[i], NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachments[i], GL_TEXTURE_2D, targets[i], 0);
+    }
+
+    const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        printf("G-buffer framebuffer incomplete: 0x%x \n", status);
+        return false;
+    }
+
+    glGenVertexArrays(1, &emptyVertexArray);
+
+    for (int i = 0; i < QUERY_FRAMES; i++)
+        glGenQueries(2, queries[i]);
+
+    // the G-buffer samplers never move, so they are set once
+    lightingShader->UseShader();
+    glUniform1i(lightingShader->GetUniformLocation("gAlbedo"), GBUFFER_UNIT);
+    glUniform1i(lightingShader->GetUniformLocation("gNormal"), GBUFFER_UNIT + 1);
+    glUniform1i(lightingShader->GetUniformLocation("gDepth"), GBUFFER_UNIT + 2);
+    uniformInverseViewProjection = lightingShader->GetUniformLocation("inverseViewProjection");
+    glUseProgram(0);
+
+    return true;
+}
+
+void DeferredRenderer::render(MultiViewRenderer &renderer, const std::vector<RenderObject> &objects, const std::vector<View> &views, ClusteredLighting &lighting)
+{
+    PROFILE_GPU_SCOPE("deferred");
+
+    // the slot about to be reused was issued QUERY_FRAMES ago, long retired by the frame pacer
+    if (queryIssued[queryIndex])
+        readQueries(queryIndex);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    // depth only, so the G-buffer pass below writes each pixel once however deep the scene is
+    {
+        PROFILE_GPU_SCOPE("depth pre-pass");
+
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glBeginQuery(GL_SAMPLES_PASSED, queries[queryIndex][0]);
+        renderer.render(objects, depthShader);
+        glEndQuery(GL_SAMPLES_PASSED);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    {
+        PROFILE_GPU_SCOPE("G-buffer");
+
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+        glBeginQuery(GL_SAMPLES_PASSED, queries[queryIndex][1]);
+        renderer.render(objects, geometryShader);
+        glEndQuery(GL_SAMPLES_PASSED);
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+
+    // one full screen triangle per view, shading straight into the output
+    {
+        PROFILE_GPU_SCOPE("lighting");
+
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+        glDisable(GL_DEPTH_TEST);
+
+        lighting.bind(lightingShader, CLUSTER_UNIT);
+
+        for (int i = 0; i < 3; i++)
+        {
+            glActiveTexture(GL_TEXTURE0 + GBUFFER_UNIT + i);
+            glBindTexture(GL_TEXTURE_2D, targets[i]);
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(emptyVertexArray);
+
+        size_t pixels = 0;
+
+        for (size_t v = 0; v < views.size(); v++)
+        {
+            glm::mat4 inverseViewProjection = glm::inverse(views[v].projection * views[v].view);
+
+            glViewport(views[v].x, views[v].y, views[v].width, views[v].height);
+            glUniformMatrix4fv(uniformInverseViewProjection, 1, GL_FALSE, glm::value_ptr(inverseViewProjection));
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+
+            pixels += (size_t)views[v].width * views[v].height;
+        }
+
+        renderStats.add(COUNTER_UNIFORM_UPLOADS, views.size());
+        renderStats.add(COUNTER_DRAW_CALLS, views.size());
+
+        lightingPixels[queryIndex] = pixels;
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    queryIssued[queryIndex] = true;
+    queryIndex = (queryIndex + 1) % QUERY_FRAMES;
+}
+
+void DeferredRenderer::readQueries(int index)
+{
+    GLuint depthSamples = 0, geometrySamples = 0;
+
+    glGetQueryObjectuiv(queries[index][0], GL_QUERY_RESULT, &depthSamples);
+    glGetQueryObjectuiv(queries[index][1], GL_QUERY_RESULT, &geometrySamples);
+
+    // pre-pass depth writes, G-buffer writes, then every lit pixel reads both targets & depth
+    frameBytes = (size_t)depthSamples * DEPTH_BYTES + (size_t)geometrySamples * COLOUR_BYTES + lightingPixels[index] * (COLOUR_BYTES + DEPTH_BYTES);
+
+    totalBytes += frameBytes;
+    measuredFrames++;
+}
+
+void DeferredRenderer::printStatistics()
+{
+    if (measuredFrames == 0)
+        return;
+
+    printf("G-buffer %dx%d | %zu bytes per pixel | traffic %.2f MB per frame (mean of %zu) \n", width, height,
+        COLOUR_BYTES + DEPTH_BYTES, getMeanFrameBytes() / (1024.0 * 1024.0), measuredFrames);
+}
+
+void DeferredRenderer::Shutdown()
+{
+    if (framebuffer != 0)
+    {
+        for (int i = 0; i < QUERY_FRAMES; i++)
+        {
+            glDeleteQueries(2, queries[i]);
+            queryIssued[i] = false;
+        }
+
+        glDeleteVertexArrays(1, &emptyVertexArray);
+        glDeleteTextures(3, targets);
+        glDeleteFramebuffers(1, &framebuffer);
+
+        framebuffer = 0;
+        emptyVertexArray = 0;
+    }
+}
+
+DeferredRenderer::~DeferredRenderer()
+{
+
+}
\ No newline at end of file
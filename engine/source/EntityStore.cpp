@@ -0,0 +1,195 @@
+#include "../headers/EntityStore.h"
+
+EntityStore::EntityStore()
+{
+    entityCount = 0;
+}
+
+Entity EntityStore::create(uint32_t mask)
+{
+    Entity entity;
+
+    if (!freeSlots.empty())
+    {
+        entity.index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        entity.index = slots.size();
+
+        Slot slot;
+        slot.generation = 0;
+        slot.alive = false;
+        slots.push_back(slot);
+    }
+
+    Slot &slot = slots[entity.index];
+    entity.generation = slot.generation;
+
+    slot.archetype = findArchetype(mask);
+    slot.row = appendRow(slot.archetype, entity);
+    slot.alive = true;
+
+    entityCount++;
+
+    return entity;
+}
+
+void EntityStore::destroy(Entity entity)
+{
+    if (!isAlive(entity))
+        return;
+
+    Slot &slot = slots[entity.index];
+    removeRow(slot.archetype, slot.row);
+
+    // stale handles to this slot stop matching from now on
+    slot.generation++;
+    slot.alive = false;
+    freeSlots.push_back(entity.index);
+
+    entityCount--;
+}
+
+bool EntityStore::isAlive(Entity entity)
+{
+    return entity.index < slots.size() && slots[entity.index].alive && slots[entity.index].generation == entity.generation;
+}
+
+void EntityStore::addComponents(Entity entity, uint32_t mask)
+{
+    if (isAlive(entity))
+        moveEntity(entity, getMask(entity) | mask);
+}
+
+void EntityStore::removeComponents(Entity entity, uint32_t mask)
+{
+    if (isAlive(entity))
+        moveEntity(entity, getMask(entity) & ~mask);
+}
+
+uint32_t EntityStore::findArchetype(uint32_t mask)
+{
+    for (size_t i = 0; i < archetypes.size(); i++)
+    {
+        if (archetypes[i].mask == mask)
+            return i;
+    }
+
+    Archetype archetype;
+    archetype.mask = mask;
+    archetypes.push_back(archetype);
+
+    return archetypes.size() - 1;
+}
+
+uint32_t EntityStore::appendRow(uint32_t archetype, Entity entity)
+{
+    Archetype &target = archetypes[archetype];
+    uint32_t mask = target.mask;
+
+    target.entities.push_back(entity);
+
+    // arrays for components the archetype lacks stay empty
+    if (mask & COMPONENT_TRANSFORM)
+    {
+        target.transformNodes.push_back(0);
+        target.worldMatrices.push_back(glm::mat4(1.0f));
+    }
+
+    if (mask & COMPONENT_MESH)
+        target.meshes.push_back(NULL);
+
+    if (mask & COMPONENT_MATERIAL)
+        target.materials.push_back(NULL);
+
+    if (mask & COMPONENT_BOUNDS)
+    {
+        Bounds bounds;
+        bounds.center = glm::vec3(0.0f);
+        bounds.radius = 0.0f;
+        bounds.localRadius = 0.0f;
+
+        target.bounds.push_back(bounds);
+    }
+
+    return target.entities.size() - 1;
+}
+
+void EntityStore::copyRow(Archetype &from, uint32_t fromRow, Archetype &to, uint32_t toRow)
+{
+    uint32_t shared = from.mask & to.mask;
+
+    if (shared & COMPONENT_TRANSFORM)
+    {
+        to.transformNodes[toRow] = from.transformNodes[fromRow];
+        to.worldMatrices[toRow] = from.worldMatrices[fromRow];
+    }
+
+    if (shared & COMPONENT_MESH)
+        to.meshes[toRow] = from.meshes[fromRow];
+
+    if (shared & COMPONENT_MATERIAL)
+        to.materials[toRow] = from.materials[fromRow];
+
+    if (shared & COMPONENT_BOUNDS)
+        to.bounds[toRow] = from.bounds[fromRow];
+}
+
+void EntityStore::removeRow(uint32_t archetype, uint32_t row)
+{
+    Archetype &source = archetypes[archetype];
+    uint32_t last = source.entities.size() - 1;
+
+    // swap the last row into the hole so the arrays stay dense
+    if (row != last)
+    {
+        copyRow(source, last, source, row);
+        source.entities[row] = source.entities[last];
+        slots[source.entities[row].index].row = row;
+    }
+
+    source.entities.pop_back();
+
+    if (source.mask & COMPONENT_TRANSFORM)
+    {
+        source.transformNodes.pop_back();
+        source.worldMatrices.pop_back();
+    }
+
+    if (source.mask & COMPONENT_MESH)
+        source.meshes.pop_back();
+
+    if (source.mask & COMPONENT_MATERIAL)
+        source.materials.pop_back();
+
+    if (source.mask & COMPONENT_BOUNDS)
+        source.bounds.pop_back();
+}
+
+void EntityStore::moveEntity(Entity entity, uint32_t mask)
+{
+    Slot &slot = slots[entity.index];
+
+    if (archetypes[slot.archetype].mask == mask)
+        return;
+
+    uint32_t from = slot.archetype;
+    uint32_t fromRow = slot.row;
+
+    // findArchetype may grow the archetype list, so look both up by index afterwards
+    uint32_t to = findArchetype(mask);
+    uint32_t toRow = appendRow(to, entity);
+
+    copyRow(archetypes[from], fromRow, archetypes[to], toRow);
+    removeRow(from, fromRow);
+
+    slot.archetype = to;
+    slot.row = toRow;
+}
+
+EntityStore::~EntityStore()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "../headers/FrameArena.h"
+
+// the block a thread is currently bumping through, valid while owner & generation match
+struct ThreadBlock
+{
+    const FrameArena *owner;
+    uint64_t generation;
+    char *cursor;
+    char *end;
+};
+
+static thread_local ThreadBlock threadBlock = { NULL, 0, NULL, NULL };
+
+// shared by every arena so a block can never be mistaken for one from an earlier frame
+static std::atomic<uint64_t> nextGeneration(1);
+
+static char* alignPointer(char *pointer, size_t alignment)
+{
+    return (char*)(((uintptr_t)pointer + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+FrameArena::FrameArena()
+{
+    for (int r = 0; r < MAX_FRAMES_IN_FLIGHT; r++)
+    {
+        regions[r].memory = NULL;
+        regions[r].offset.store(0, std::memory_order_relaxed);
+    }
+
+    regionCount = 0;
+    current = 0;
+    capacity = 0;
+
+    generation.store(0, std::memory_order_relaxed);
+    highWater = 0;
+    overflowCount = 0;
+}
+
+bool FrameArena::Initialise(size_t bytesPerFrame, int framesInFlight)
+{
+    regionCount = framesInFlight < 1 ? 1 : (framesInFlight > MAX_FRAMES_IN_FLIGHT ? MAX_FRAMES_IN_FLIGHT : framesInFlight);
+    capacity = (bytesPerFrame + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+    for (int r = 0; r < regionCount; r++)
+    {
+        regions[r].memory = (char*)aligned_alloc(64, capacity);
+
+        if (!regions[r].memory)
+        {
+            printf("Failed to allocate %zu byte frame arena! \n", capacity);
+            return false;
+        }
+
+        regions[r].overflow.reserve(64);
+    }
+
+    current = 0;
+    generation.store(nextGeneration.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    return true;
+}
+
+void FrameArena::beginFrame()
+{
+    size_t used = regions[current].offset.load(std::memory_order_relaxed);
+    highWater = used > highWater ? used : highWater;
+
+    current = (current + 1) % regionCount;
+
+    Region &region = regions[current];
+    region.offset.store(0, std::memory_order_relaxed);
+    releaseOverflow(region);
+
+    // every thread's block is stale from here on
+    generation.store(nextGeneration.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+char* FrameArena::claim(size_t size)
+{
+    Region &region = regions[current];
+    size_t offset = region.offset.load(std::memory_order_relaxed);
+
+    // only advance when the claim fits, so a failed one neither uses up the rest of the region
+    // for smaller requests nor pushes the offset, & the high water mark, past the capacity
+    do
+    {
+        if (offset + size > capacity)
+            return NULL;
+    }
+    while (!region.offset.compare_exchange_weak(offset, offset + size, std::memory_order_relaxed));
+
+    return region.memory + offset;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    ThreadBlock &block = threadBlock;
+    uint64_t currentGeneration = generation.load(std::memory_order_relaxed);
+
+    if (block.owner == this && block.generation == currentGeneration)
+    {
+        char *pointer = alignPointer(block.cursor, alignment);
+
+        if (pointer + size <= block.end)
+        {
+            block.cursor = pointer + size;
+            return pointer;
+        }
+    }
+
+    // big requests go straight to the region instead of wasting most of a block
+    if (size + alignment > BLOCK_SIZE / 4)
+    {
+        char *memory = claim(size + alignment);
+        return memory ? alignPointer(memory, alignment) : allocateOverflow(size, alignment);
+    }
+
+    char *memory = claim(BLOCK_SIZE);
+
+    if (!memory)
+        return allocateOverflow(size, alignment);
+
+    block.owner = this;
+    block.generation = currentGeneration;
+    block.end = memory + BLOCK_SIZE;
+
+    char *pointer = alignPointer(memory, alignment);
+    block.cursor = pointer + size;
+
+    return pointer;
+}
+
+void* FrameArena::allocateOverflow(size_t size, size_t alignment)
+{
+    std::lock_guard<std::mutex> lock(overflowMutex);
+
+    if (overflowCount++ == 0)
+        printf("Frame arena of %zu bytes is full, falling back to the heap \n", capacity);
+
+    alignment = alignment < sizeof(void*) ? sizeof(void*) : alignment;
+
+    void *memory = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    regions[current].overflow.push_back(memory);
+
+    return memory;
+}
+
+void FrameArena::releaseOverflow(Region &region)
+{
+    for (size_t i = 0; i < region.overflow.size(); i++)
+        free(region.overflow[i]);
+
+    region.overflow.clear();
+}
+
+FrameArena::~FrameArena()
+{
+    for (int r = 0; r < regionCount; r++)
+    {
+        releaseOverflow(regions[r]);
+        free(regions[r].memory);
+    }
+}
\ No newline at end of file
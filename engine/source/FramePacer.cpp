@@ -0,0 +1,167 @@
+#include "../headers/FramePacer.h"
+
+#include <math.h>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+FramePacer::FramePacer()
+{
+    mode = PACING_VSYNC;
+    targetPeriod = 0.0;
+    maxFramesInFlight = 2;
+
+    sleepOvershoot = 0.001;
+
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        fences[i] = 0;
+
+    fenceIndex = 0;
+
+    frameCount = 0;
+    meanFrameTime = 0.0;
+    frameTimeM2 = 0.0;
+    minFrameTime = 0.0;
+    maxFrameTime = 0.0;
+
+    cpuStart = 0;
+}
+
+void FramePacer::Initialise(Window *window, PacingMode pacingMode, double targetRate, int framesInFlight)
+{
+    mode = pacingMode;
+    targetPeriod = targetRate > 0.0 ? 1.0 / targetRate : 0.0;
+
+    if (mode == PACING_CAPPED && targetPeriod == 0.0)
+        mode = PACING_UNCAPPED;
+
+    maxFramesInFlight = framesInFlight < 1 ? 1 : (framesInFlight > MAX_FRAMES_IN_FLIGHT ? MAX_FRAMES_IN_FLIGHT : framesInFlight);
+
+    // the pacer does the limiting itself, so only vsync mode waits in swapBuffers
+    window->setSwapInterval(mode == PACING_VSYNC ? 1 : 0);
+
+    wallStart = Clock::now();
+    cpuStart = clock();
+
+    lastFrameEnd = wallStart;
+    nextDeadline = wallStart;
+}
+
+void FramePacer::beginFrame()
+{
+    PROFILE_SCOPE("frame wait");
+
+    // block until the GPU has finished the frame submitted maxFramesInFlight frames ago,
+    // which bounds both queued latency and how far the CPU can run ahead
+    GLsync &fence = fences[fenceIndex];
+
+    if (fence)
+    {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+            ;
+
+        glDeleteSync(fence);
+        fence = 0;
+    }
+}
+
+void FramePacer::endFrame()
+{
+    fences[fenceIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fenceIndex = (fenceIndex + 1) % maxFramesInFlight;
+
+    if (mode == PACING_CAPPED)
+    {
+        nextDeadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetPeriod));
+
+        Clock::time_point now = Clock::now();
+
+        // after a long stall start a fresh schedule rather than rushing frames to catch up
+        if (now > nextDeadline + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetPeriod)))
+            nextDeadline = now;
+        else
+            waitUntil(nextDeadline);
+    }
+
+    Clock::time_point frameEnd = Clock::now();
+    double frameTime = std::chrono::duration<double>(frameEnd - lastFrameEnd).count();
+    lastFrameEnd = frameEnd;
+
+    frameCount++;
+
+    if (frameCount == 1)
+    {
+        minFrameTime = frameTime;
+        maxFrameTime = frameTime;
+    }
+    else
+    {
+        minFrameTime = fmin(minFrameTime, frameTime);
+        maxFrameTime = fmax(maxFrameTime, frameTime);
+    }
+
+    double delta = frameTime - meanFrameTime;
+    meanFrameTime += delta / frameCount;
+    frameTimeM2 += delta * (frameTime - meanFrameTime);
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline)
+{
+    // sleep while the deadline is further away than sleep's usual overshoot,
+    // then spin the remainder for sub-millisecond accuracy
+    for (;;)
+    {
+        double remaining = std::chrono::duration<double>(deadline - Clock::now()).count();
+
+        if (remaining <= sleepOvershoot * 1.5 + 0.0002)
+            break;
+
+        double request = remaining - sleepOvershoot * 1.5;
+
+        Clock::time_point before = Clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(request));
+        double slept = std::chrono::duration<double>(Clock::now() - before).count();
+
+        // slowly track the scheduler's wake-up latency
+        sleepOvershoot = 0.9 * sleepOvershoot + 0.1 * fmax(0.0, slept - request);
+    }
+
+    while (Clock::now() < deadline)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+}
+
+double FramePacer::getFrameTimeDeviation()
+{
+    return frameCount > 1 ? sqrt(frameTimeM2 / (frameCount - 1)) : 0.0;
+}
+
+double FramePacer::getCpuUtilisation()
+{
+    double wall = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    double cpu = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    return wall > 0.0 ? cpu / wall : 0.0;
+}
+
+void FramePacer::printStatistics()
+{
+    if (frameCount == 0)
+        return;
+
+    const char *modeNames[] = { "vsync", "uncapped", "capped" };
+
+    printf("pacing %s | frame time mean %.3f ms | std dev %.3f ms | min %.3f ms | max %.3f ms | cpu %.1f%% \n",
+        modeNames[mode], 1000.0 * meanFrameTime, 1000.0 * getFrameTimeDeviation(),
+        1000.0 * minFrameTime, 1000.0 * maxFrameTime, 100.0 * getCpuUtilisation());
+}
+
+FramePacer::~FramePacer()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "../headers/HeapTracker.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+#ifdef TRACK_HEAP_ALLOCATIONS
+
+static std::atomic<size_t> heapAllocations(0);
+static thread_local size_t threadHeapAllocations = 0;
+
+static void* trackedAllocate(size_t size, size_t alignment)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    threadHeapAllocations++;
+
+    if (size == 0)
+        size = 1;
+
+    if (alignment <= alignof(max_align_t))
+        return malloc(size);
+
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* operator new(size_t size)
+{
+    void *memory = trackedAllocate(size, 0);
+
+    if (!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedAllocate(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedAllocate(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void *memory = trackedAllocate(size, (size_t)alignment);
+
+    if (!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete[](void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t) noexcept { free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept { free(memory); }
+
+bool HeapTrackingEnabled()
+{
+    return true;
+}
+
+size_t GetHeapAllocationCount()
+{
+    return heapAllocations.load(std::memory_order_relaxed);
+}
+
+size_t GetThreadHeapAllocationCount()
+{
+    return threadHeapAllocations;
+}
+
+#else
+
+bool HeapTrackingEnabled()
+{
+    return false;
+}
+
+size_t GetHeapAllocationCount()
+{
+    return 0;
+}
+
+size_t GetThreadHeapAllocationCount()
+{
+    return 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "../headers/InputPlayer.h"
+
+InputPlayer::InputPlayer()
+{
+    nextFrame = 0;
+    replayTime = 0.0f;
+
+    xChange = 0.0f;
+    yChange = 0.0f;
+
+    for (size_t i = 0; i < 1024; i++)
+        keys[i] = false;
+}
+
+bool InputPlayer::load(const char *fileLocation)
+{
+    FILE *file = fopen(fileLocation, "rb");
+
+    if (!file)
+    {
+        printf("Failed to read %s \n", fileLocation);
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0;
+
+    if (fread(&magic, sizeof(magic), 1, file) != 1 || fread(&version, sizeof(version), 1, file) != 1 ||
+        magic != RECORDING_MAGIC || version != RECORDING_VERSION)
+    {
+        printf("%s is not a recording this build can replay \n", fileLocation);
+        fclose(file);
+        return false;
+    }
+
+    frames.clear();
+    keyEventStart.clear();
+    keyEvents.clear();
+
+    GLfloat record[10];
+    uint16_t eventCount;
+    bool complete = true;
+
+    // the file ends cleanly only on a frame boundary, anything shorter is a truncated recording
+    size_t recordRead;
+
+    while ((recordRead = fread(record, 1, sizeof(record), file)) > 0)
+    {
+        if (recordRead != sizeof(record) || fread(&eventCount, sizeof(eventCount), 1, file) != 1)
+        {
+            complete = false;
+            break;
+        }
+
+        RecordedFrame frame;
+        frame.time = record[0];
+        frame.xChange = record[1];
+        frame.yChange = record[2];
+        frame.position = glm::vec3(record[3], record[4], record[5]);
+        frame.orientation = glm::quat(record[9], record[6], record[7], record[8]);
+
+        size_t start = keyEvents.size();
+
+        if (eventCount > 0)
+        {
+            keyEvents.resize(start + eventCount);
+
+            if (fread(&keyEvents[start], sizeof(uint16_t), eventCount, file) != eventCount)
+            {
+                complete = false;
+                break;
+            }
+
+            // step() indexes keys[] with these, so a corrupt code must not get that far
+            for (size_t e = start; e < keyEvents.size(); e++)
+            {
+                if ((keyEvents[e] & ~RECORDING_KEY_PRESSED) >= 1024)
+                {
+                    complete = false;
+                    break;
+                }
+            }
+
+            if (!complete)
+                break;
+        }
+
+        frames.push_back(frame);
+        keyEventStart.push_back(start);
+    }
+
+    if (!complete)
+    {
+        printf("%s is truncated or corrupt after %zu frames \n", fileLocation, frames.size());
+
+        frames.clear();
+        keyEventStart.clear();
+        keyEvents.clear();
+        nextFrame = 0;
+
+        fclose(file);
+        return false;
+    }
+
+    keyEventStart.push_back(keyEvents.size());
+
+    fclose(file);
+
+    nextFrame = 0;
+    replayTime = frames.empty() ? 0.0f : frames[0].time;
+
+    return !frames.empty();
+}
+
+bool InputPlayer::step(GLfloat fixedDeltaTime)
+{
+    if (nextFrame >= frames.size())
+        return false;
+
+    // consume every recorded frame that falls inside this step, so the result
+    // depends only on the recording and the step size, never on the frame rate
+    replayTime += fixedDeltaTime;
+
+    while (nextFrame < frames.size() && frames[nextFrame].time <= replayTime)
+    {
+        xChange += frames[nextFrame].xChange;
+        yChange += frames[nextFrame].yChange;
+
+        for (uint32_t e = keyEventStart[nextFrame]; e < keyEventStart[nextFrame + 1]; e++)
+            keys[keyEvents[e] & ~RECORDING_KEY_PRESSED] = (keyEvents[e] & RECORDING_KEY_PRESSED) != 0;
+
+        nextFrame++;
+    }
+
+    return true;
+}
+
+GLfloat InputPlayer::getXChange()
+{
+    GLfloat theChange = xChange;
+    xChange = 0.0f;
+
+    return theChange;
+}
+
+GLfloat InputPlayer::getYChange()
+{
+    GLfloat theChange = yChange;
+    yChange = 0.0f;
+
+    return theChange;
+}
+
+bool InputPlayer::applyCameraPose(GLfloat time, Camera &camera)
+{
+    if (frames.empty())
+        return false;
+
+    time += frames[0].time;
+
+    if (time >= frames.back().time)
+    {
+        camera.setPosition(frames.back().position);
+        camera.setOrientation(frames.back().orientation);
+        return false;
+    }
+
+    // binary search for the recorded frames either side of the requested time
+    size_t low = 0, high = frames.size() - 1;
+
+    while (high - low > 1)
+    {
+        size_t middle = (low + high) / 2;
+
+        if (frames[middle].time <= time)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    GLfloat span = frames[high].time - frames[low].time;
+    GLfloat amount = span > 0.0f ? (time - frames[low].time) / span : 0.0f;
+
+    camera.setPosition(glm::mix(frames[low].position, frames[high].position, glm::clamp(amount, 0.0f, 1.0f)));
+    camera.setOrientation(glm::slerp(frames[low].orientation, frames[high].orientation, glm::clamp(amount, 0.0f, 1.0f)));
+
+    return true;
+}
+
+GLfloat InputPlayer::getDuration()
+{
+    return frames.empty() ? 0.0f : frames.back().time - frames[0].time;
+}
+
+InputPlayer::~InputPlayer()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "../headers/InputQueue.h"
+
+InputQueue::InputQueue()
+{
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+
+    cachedHead = 0;
+    cachedTail = 0;
+
+    motionPending = false;
+}
+
+bool InputQueue::push(const InputEvent &event)
+{
+    if (event.type == INPUT_MOTION)
+    {
+        // consecutive deltas merge until there is room, so the summed motion always arrives
+        if (motionPending)
+        {
+            pendingMotion.time = event.time;
+            pendingMotion.xChange += event.xChange;
+            pendingMotion.yChange += event.yChange;
+        }
+        else
+        {
+            pendingMotion = event;
+            motionPending = true;
+        }
+
+        flush();
+
+        return true;
+    }
+
+    // keys & buttons queue behind any held back motion, so the consumer sees them in order
+    if (!flush() || !enqueue(event))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+bool InputQueue::flush()
+{
+    if (!motionPending)
+        return true;
+
+    if (!enqueue(pendingMotion))
+        return false;
+
+    motionPending = false;
+
+    return true;
+}
+
+bool InputQueue::enqueue(const InputEvent &event)
+{
+    size_t currentTail = tail.load(std::memory_order_relaxed);
+
+    // only re-read the consumer's position when the queue looks full
+    if (currentTail - cachedHead == CAPACITY)
+    {
+        cachedHead = head.load(std::memory_order_acquire);
+
+        if (currentTail - cachedHead == CAPACITY)
+            return false;
+    }
+
+    events[currentTail & (CAPACITY - 1)] = event;
+    tail.store(currentTail + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool InputQueue::pop(InputEvent &event)
+{
+    size_t currentHead = head.load(std::memory_order_relaxed);
+
+    // only re-read the producer's position when the queue looks empty
+    if (currentHead == cachedTail)
+    {
+        cachedTail = tail.load(std::memory_order_acquire);
+
+        if (currentHead == cachedTail)
+            return false;
+    }
+
+    event = events[currentHead & (CAPACITY - 1)];
+    head.store(currentHead + 1, std::memory_order_release);
+
+    return true;
+}
+
+InputQueue::~InputQueue()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "../headers/InputRecorder.h"
+
+InputRecorder::InputRecorder()
+{
+    file = NULL;
+
+    for (size_t i = 0; i < 1024; i++)
+        lastKeys[i] = false;
+}
+
+bool InputRecorder::beginRecording(const char *fileLocation)
+{
+    endRecording();
+
+    file = fopen(fileLocation, "wb");
+
+    if (!file)
+    {
+        printf("Failed to open %s for recording \n", fileLocation);
+        return false;
+    }
+
+    fwrite(&RECORDING_MAGIC, sizeof(RECORDING_MAGIC), 1, file);
+    fwrite(&RECORDING_VERSION, sizeof(RECORDING_VERSION), 1, file);
+
+    for (size_t i = 0; i < 1024; i++)
+        lastKeys[i] = false;
+
+    return true;
+}
+
+void InputRecorder::recordFrame(GLfloat time, bool *keys, GLfloat xChange, GLfloat yChange, Camera &camera)
+{
+    if (!file)
+        return;
+
+    // only keys that changed since the previous frame are stored
+    uint16_t eventCount = 0;
+
+    for (uint16_t key = 0; key < 1024; key++)
+    {
+        if (keys[key] != lastKeys[key])
+        {
+            keyEvents[eventCount++] = (uint16_t)(key | (keys[key] ? RECORDING_KEY_PRESSED : 0));
+            lastKeys[key] = keys[key];
+        }
+    }
+
+    glm::vec3 position = camera.getPosition();
+    glm::quat orientation = camera.getOrientation();
+
+    GLfloat record[10] = {
+        time, xChange, yChange,
+        position.x, position.y, position.z,
+        orientation.x, orientation.y, orientation.z, orientation.w
+    };
+
+    fwrite(record, sizeof(record), 1, file);
+    fwrite(&eventCount, sizeof(eventCount), 1, file);
+    fwrite(keyEvents, sizeof(keyEvents[0]), eventCount, file);
+}
+
+void InputRecorder::endRecording()
+{
+    if (file)
+    {
+        fclose(file);
+        file = NULL;
+    }
+}
+
+InputRecorder::~InputRecorder()
+{
+    endRecording();
+}
\ No newline at end of file
@@ -0,0 +1,470 @@
+#include "../headers/JobSystem.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// index of the worker owning the calling thread, -1 for any other thread
+static thread_local int workerIndex = -1;
+static thread_local const JobSystem *workerSystem = NULL;
+
+static void spinPause()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+static void pinCurrentThread(unsigned int core)
+{
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core % CPU_SETSIZE, &cpus);
+
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#endif
+}
+
+WorkStealingQueue::WorkStealingQueue()
+{
+    top.store(0, std::memory_order_relaxed);
+    bottom.store(0, std::memory_order_relaxed);
+
+    for (int64_t i = 0; i < CAPACITY; i++)
+        jobs[i].store(NULL, std::memory_order_relaxed);
+}
+
+bool WorkStealingQueue::push(Job *job)
+{
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+
+    if (b - t >= CAPACITY)
+        return false;
+
+    jobs[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+Job* WorkStealingQueue::pop()
+{
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        // empty
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return NULL;
+    }
+
+    Job *job = jobs[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+    if (t == b)
+    {
+        // last job, race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = NULL;
+
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+Job* WorkStealingQueue::steal()
+{
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+        return NULL;
+
+    Job *job = jobs[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return NULL; // lost to the owner or another thief
+
+    return job;
+}
+
+int64_t WorkStealingQueue::size()
+{
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    return b > t ? b - t : 0;
+}
+
+JobSystem::JobSystem()
+{
+    running.store(false);
+    nextExternalJob = 0;
+    externalCount.store(0);
+    sleeping.store(0);
+
+    for (size_t i = 0; i < JOB_POOL_SIZE; i++)
+        externalBusy[i].store(false, std::memory_order_relaxed);
+}
+
+void JobSystem::Initialise(unsigned int threadCount, bool pinThreads)
+{
+    if (threadCount == 0)
+        threadCount = 1;
+
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        Worker *worker = new Worker();
+        worker->nextJob = 0;
+        worker->random = 0x9E3779B9u * (i + 1);
+
+        for (size_t j = 0; j < JOB_POOL_SIZE; j++)
+            worker->jobBusy[j].store(false, std::memory_order_relaxed);
+
+        workers.push_back(worker);
+    }
+
+    running.store(true);
+
+    workerIndex = 0;
+    workerSystem = this;
+
+    if (pinThreads)
+        pinCurrentThread(0);
+
+    for (unsigned int i = 1; i < threadCount; i++)
+        threads.push_back(std::thread(&JobSystem::workerLoop, this, i, pinThreads));
+}
+
+void JobSystem::Shutdown()
+{
+    if (!running.load())
+        return;
+
+    running.store(false);
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_all();
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    threads.clear();
+
+    for (size_t i = 0; i < workers.size(); i++)
+        delete workers[i];
+
+    workers.clear();
+
+    if (workerSystem == this)
+    {
+        workerIndex = -1;
+        workerSystem = NULL;
+    }
+}
+
+int JobSystem::currentWorker()
+{
+    return workerSystem == this ? workerIndex : -1;
+}
+
+Job* JobSystem::allocateJob()
+{
+    int worker = currentWorker();
+
+    if (worker >= 0)
+    {
+        Worker *owner = workers[worker];
+        size_t slot = owner->nextJob++ & (JOB_POOL_SIZE - 1);
+
+        return claimSlot(&owner->jobPool[slot], &owner->jobBusy[slot], worker);
+    }
+
+    size_t slot;
+
+    {
+        std::lock_guard<std::mutex> lock(externalMutex);
+        slot = nextExternalJob++ & (JOB_POOL_SIZE - 1);
+    }
+
+    // outside the lock, findJob needs it to make progress
+    return claimSlot(&externalPool[slot], &externalBusy[slot], worker);
+}
+
+Job* JobSystem::claimSlot(Job *job, std::atomic<bool> *busy, int worker)
+{
+    // the pools are rings, so with more than JOB_POOL_SIZE jobs queued the slot can still hold
+    // one that has not started: run other work until it does rather than overwrite it
+    bool expected = false;
+
+    while (!busy->compare_exchange_weak(expected, true, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        expected = false;
+
+        Job *other = findJob(worker);
+
+        if (other)
+            execute(other, worker);
+        else
+            spinPause();
+    }
+
+    job->busy = busy;
+    return job;
+}
+
+void JobSystem::submit(Job *job)
+{
+    int worker = currentWorker();
+
+    if (worker < 0 || !workers[worker]->queue.push(job))
+    {
+        // not a worker, or our deque is full
+        std::lock_guard<std::mutex> lock(externalMutex);
+        externalJobs.push_back(job);
+        externalCount.fetch_add(1, std::memory_order_release);
+    }
+
+    if (sleeping.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+void JobSystem::run(JobFunction function, void *data, JobCounter *counter, JobCounter *dependency)
+{
+    parallelFor(1, 1, function, data, counter, dependency);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, JobFunction function, void *data, JobCounter *counter, JobCounter *dependency)
+{
+    if (count == 0)
+        return;
+
+    // a few ranges per thread balances load without drowning in tiny jobs
+    if (grain == 0)
+    {
+        grain = count / (workers.size() * 8);
+        grain = grain > 0 ? grain : 1;
+    }
+
+    Job *job = allocateJob();
+    job->function = function;
+    job->data = data;
+    job->begin = 0;
+    job->end = count;
+    job->grain = grain;
+    job->counter = counter;
+    job->dependency = dependency;
+
+    if (counter)
+        counter->value.fetch_add(1, std::memory_order_relaxed);
+
+    submit(job);
+}
+
+Job* JobSystem::findJob(int worker)
+{
+    if (worker >= 0)
+    {
+        Job *job = workers[worker]->queue.pop();
+
+        if (job)
+            return job;
+    }
+
+    if (externalCount.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(externalMutex);
+
+        // newest first, passing over jobs set aside until their dependency finishes
+        for (size_t i = externalJobs.size(); i > 0; i--)
+        {
+            Job *job = externalJobs[i - 1];
+
+            if (job->dependency && job->dependency->value.load(std::memory_order_acquire) > 0)
+                continue;
+
+            externalJobs.erase(externalJobs.begin() + (i - 1));
+            externalCount.fetch_sub(1, std::memory_order_relaxed);
+
+            return job;
+        }
+    }
+
+    // steal from a random victim, then try the rest in order
+    size_t workerCount = workers.size();
+    uint32_t start = 0;
+
+    if (worker >= 0)
+    {
+        uint32_t &random = workers[worker]->random;
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        start = random;
+    }
+
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        size_t victim = (start + i) % workerCount;
+
+        if ((int)victim == worker)
+            continue;
+
+        Job *job = workers[victim]->queue.steal();
+
+        if (job)
+            return job;
+    }
+
+    if (worker >= 0)
+    {
+        std::vector<Job*> &pending = workers[worker]->pending;
+
+        for (size_t i = 0; i < pending.size(); i++)
+        {
+            if (pending[i]->dependency->value.load(std::memory_order_acquire) > 0)
+                continue;
+
+            Job *job = pending[i];
+            pending.erase(pending.begin() + i);
+
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+void JobSystem::execute(Job *queued, int worker)
+{
+    // not ready yet: set it aside where the next pop will not return it, or the dependency
+    // behind it in the same deque never runs
+    if (queued->dependency && queued->dependency->value.load(std::memory_order_acquire) > 0)
+    {
+        // the external list is searched for ready jobs, so other threads can set theirs aside there
+        if (worker >= 0)
+            workers[worker]->pending.push_back(queued);
+        else
+            submit(queued);
+
+        return;
+    }
+
+    // run from a copy & free the slot straight away, so a job spawning more jobs than the pool
+    // holds never ends up waiting for its own slot
+    Job started = *queued;
+    queued->busy->store(false, std::memory_order_release);
+
+    Job *job = &started;
+
+    size_t begin = job->begin;
+
+    while (begin < job->end)
+    {
+        // lazy binary splitting: whenever our own deque has run dry, hand off the upper half of
+        // what is left, so ranges stay large while every thread is busy & idle thieves always find work
+        while (job->end - begin > job->grain && (worker < 0 || workers[worker]->queue.size() == 0))
+        {
+            size_t middle = begin + (job->end - begin) / 2;
+
+            Job *half = allocateJob();
+            std::atomic<bool> *busy = half->busy;
+
+            *half = *job;
+            half->busy = busy;
+            half->begin = middle;
+            half->dependency = NULL;
+
+            if (job->counter)
+                job->counter->value.fetch_add(1, std::memory_order_relaxed);
+
+            job->end = middle;
+            submit(half);
+        }
+
+        size_t end = begin + job->grain < job->end ? begin + job->grain : job->end;
+        job->function(job->data, begin, end);
+        begin = end;
+    }
+
+    if (job->counter)
+        job->counter->value.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::wait(JobCounter *counter)
+{
+    int worker = currentWorker();
+
+    while (counter->value.load(std::memory_order_acquire) > 0)
+    {
+        Job *job = findJob(worker);
+
+        if (job)
+            execute(job, worker);
+        else
+            spinPause();
+    }
+}
+
+void JobSystem::workerLoop(unsigned int index, bool pin)
+{
+    workerIndex = index;
+    workerSystem = this;
+
+    if (pin)
+        pinCurrentThread(index);
+
+    int idle = 0;
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        Job *job = findJob(index);
+
+        if (job)
+        {
+            execute(job, index);
+            idle = 0;
+            continue;
+        }
+
+        // spin briefly, then yield, then sleep until new work is submitted
+        if (++idle < 64)
+        {
+            spinPause();
+        }
+        else if (idle < 128)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1, std::memory_order_acq_rel);
+            wake.wait_for(lock, std::chrono::milliseconds(1));
+            sleeping.fetch_sub(1, std::memory_order_acq_rel);
+            idle = 0;
+        }
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
\ No newline at end of file
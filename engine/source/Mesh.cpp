@@ -8,9 +8,11 @@ Mesh::Mesh()
     indexCount = 0;
 }
 
-void Mesh::CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices)
+void Mesh::CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices, unsigned int floatsPerVertex)
 {
     indexCount = numOfIndices;
+
+    renderStats.add(COUNTER_UPLOAD_BYTES, sizeof(vertices[0]) * numOfVertices + sizeof(indices[0]) * numOfIndices);
     
     // creating a vertex array in the memory of GPU and returns its ID
     glGenVertexArrays(1, &VAO);
@@ -24,8 +26,23 @@ void Mesh::CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int num
             glBindBuffer(GL_ARRAY_BUFFER, VBO);
             glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[0]) * numOfVertices, vertices, GL_STATIC_DRAW);
                 
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+                GLsizei stride = sizeof(vertices[0]) * floatsPerVertex;
+
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, 0);
                 glEnableVertexAttribArray(0);
+
+                // interleaved position, normal, texture coordinate as ModelLoader writes them
+                if (floatsPerVertex >= 6)
+                {
+                    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(vertices[0]) * 3));
+                    glEnableVertexAttribArray(1);
+                }
+
+                if (floatsPerVertex >= 8)
+                {
+                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(vertices[0]) * 6));
+                    glEnableVertexAttribArray(2);
+                }
             
             glBindBuffer(GL_ARRAY_BUFFER, 0);
         
@@ -38,6 +55,12 @@ void Mesh::CreateMesh(GLfloat *vertices, unsigned int *indices, unsigned int num
 
 void Mesh::RenderMesh()
 {
+    PROFILE_GPU_SCOPE("RenderMesh");
+
+    renderStats.add(COUNTER_DRAW_CALLS, 1);
+    renderStats.add(COUNTER_INDICES, indexCount);
+    renderStats.add(COUNTER_VAO_BINDS, 1);
+
     glBindVertexArray(VAO);    
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
             
@@ -47,6 +70,23 @@ void Mesh::RenderMesh()
     glBindVertexArray(0);
 }
 
+void Mesh::RenderMeshInstanced(GLsizei instanceCount)
+{
+    PROFILE_GPU_SCOPE("RenderMeshInstanced");
+
+    renderStats.add(COUNTER_DRAW_CALLS, 1);
+    renderStats.add(COUNTER_INDICES, (uint64_t)indexCount * instanceCount);
+    renderStats.add(COUNTER_VAO_BINDS, 1);
+
+    glBindVertexArray(VAO);    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+            
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, instanceCount);
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);     
+    glBindVertexArray(0);
+}
+
 void Mesh::ClearMesh()
 {
     if (IBO != 0)
@@ -0,0 +1,1310 @@
+#include "../headers/ModelLoader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// exact in a double, so one multiply or divide rounds correctly for up to 19 significant digits
+static const double powersOfTen[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool isDigit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
+static bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skipBlanks(const char *p, const char *end)
+{
+    while (p < end && isBlank(*p))
+        p++;
+
+    return p;
+}
+
+// the plain decimal forms OBJ files use, in the spirit of std::from_chars: no locale, no errno,
+// no copy of the text; returns NULL when there is no number at p
+static const char* parseFloat(const char *p, const char *end, float &value)
+{
+    bool negative = false;
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    // digits past the 19th only move the exponent
+    for (; p < end && isDigit(*p); p++)
+    {
+        if (mantissa < 1000000000000000000ULL)
+            mantissa = mantissa * 10 + (*p - '0');
+        else
+            exponent++;
+
+        anyDigits = true;
+    }
+
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && isDigit(*p); p++)
+        {
+            if (mantissa < 1000000000000000000ULL)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+
+            anyDigits = true;
+        }
+    }
+
+    if (!anyDigits)
+        return NULL;
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *q = p + 1;
+        bool negativeExponent = false;
+
+        if (q < end && (*q == '-' || *q == '+'))
+        {
+            negativeExponent = *q == '-';
+            q++;
+        }
+
+        if (q < end && isDigit(*q))
+        {
+            int written = 0;
+
+            for (; q < end && isDigit(*q); q++)
+            {
+                if (written < 10000)
+                    written = written * 10 + (*q - '0');
+            }
+
+            exponent += negativeExponent ? -written : written;
+            p = q;
+        }
+    }
+
+    double result = (double)mantissa;
+
+    if (mantissa != 0)
+    {
+        for (; exponent > 22; exponent -= 22)
+            result *= 1e22;
+
+        for (; exponent < -22; exponent += 22)
+            result /= 1e22;
+
+        result = exponent >= 0 ? result * powersOfTen[exponent] : result / powersOfTen[-exponent];
+    }
+
+    value = (float)(negative ? -result : result);
+
+    return p;
+}
+
+static const char* parseInt(const char *p, const char *end, long &value)
+{
+    bool negative = false;
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    if (p >= end || !isDigit(*p))
+        return NULL;
+
+    long result = 0;
+
+    for (; p < end && isDigit(*p); p++)
+    {
+        if (result < 1000000000000L)
+            result = result * 10 + (*p - '0');
+    }
+
+    value = negative ? -result : result;
+
+    return p;
+}
+
+// OBJ counts from 1, negative indices count back from the latest element
+static int32_t resolveIndex(long index, size_t countSoFar)
+{
+    if (index > 0 && index <= INT32_MAX)
+        return (int32_t)(index - 1);
+
+    if (index < 0 && (size_t)-index <= countSoFar)
+        return (int32_t)(countSoFar + index);
+
+    return INT32_MIN;
+}
+
+// case insensitive, without the POSIX only strcasecmp
+static bool hasExtension(const char *fileLocation, const char *extension)
+{
+    size_t length = strlen(fileLocation), extensionLength = strlen(extension);
+
+    if (length < extensionLength)
+        return false;
+
+    for (size_t i = 0; i < extensionLength; i++)
+    {
+        if (tolower((unsigned char)fileLocation[length - extensionLength + i]) != extension[i])
+            return false;
+    }
+
+    return true;
+}
+
+static uint32_t nextPowerOfTwo(size_t value)
+{
+    uint32_t power = 16;
+
+    while (power < value)
+        power <<= 1;
+
+    return power;
+}
+
+static uint32_t hashWords(const uint32_t *words, size_t count)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        hash ^= words[i];
+        hash *= 16777619u;
+        hash ^= hash >> 15;
+    }
+
+    return hash;
+}
+
+// just enough JSON for glTF: a flat token list, every token knows where its subtree ends
+enum JsonType { JSON_OBJECT, JSON_ARRAY, JSON_STRING, JSON_PRIMITIVE };
+
+struct JsonToken
+{
+    JsonType type;
+    uint32_t start, end; // text span, without the quotes of a string
+    uint32_t size; // members of an object, elements of an array
+    uint32_t next; // first token after this one's subtree
+};
+
+class JsonDocument
+{
+    public:
+        static const int MAX_DEPTH = 64;
+
+        bool parse(const char *jsonText, size_t length)
+        {
+            text = jsonText;
+            tokens.clear();
+
+            const char *p = parseValue(skip(text, text + length), text + length, 0);
+
+            return p != NULL && skip(p, text + length) == text + length;
+        }
+
+        // the value of key in an object, -1 if it isn't there
+        int find(int object, const char *key)
+        {
+            if (object < 0 || tokens[object].type != JSON_OBJECT)
+                return -1;
+
+            size_t keyLength = strlen(key);
+            int member = object + 1;
+
+            for (uint32_t i = 0; i < tokens[object].size; i++)
+            {
+                const JsonToken &name = tokens[member];
+
+                if (name.end - name.start == keyLength && memcmp(text + name.start, key, keyLength) == 0)
+                    return member + 1;
+
+                member = tokens[member + 1].next;
+            }
+
+            return -1;
+        }
+
+        int at(int array, size_t index)
+        {
+            if (array < 0 || tokens[array].type != JSON_ARRAY || index >= tokens[array].size)
+                return -1;
+
+            int element = array + 1;
+
+            for (size_t i = 0; i < index; i++)
+                element = tokens[element].next;
+
+            return element;
+        }
+
+        size_t count(int array) { return array >= 0 && tokens[array].type == JSON_ARRAY ? tokens[array].size : 0; }
+
+        long integer(int token, long fallback)
+        {
+            if (token < 0 || tokens[token].type != JSON_PRIMITIVE)
+                return fallback;
+
+            long value;
+            const char *p = parseInt(text + tokens[token].start, text + tokens[token].end, value);
+
+            return p != NULL ? value : fallback;
+        }
+
+        bool boolean(int token)
+        {
+            return token >= 0 && tokens[token].type == JSON_PRIMITIVE && tokens[token].end - tokens[token].start == 4 &&
+                memcmp(text + tokens[token].start, "true", 4) == 0;
+        }
+
+        std::string string(int token)
+        {
+            if (token < 0 || tokens[token].type != JSON_STRING)
+                return "";
+
+            return std::string(text + tokens[token].start, tokens[token].end - tokens[token].start);
+        }
+
+    private:
+        const char *text;
+        std::vector<JsonToken> tokens;
+
+        const char* skip(const char *p, const char *end)
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+                p++;
+
+            return p;
+        }
+
+        size_t push(JsonType type, const char *start)
+        {
+            JsonToken token = { type, (uint32_t)(start - text), 0, 0, 0 };
+            tokens.push_back(token);
+
+            return tokens.size() - 1;
+        }
+
+        const char* parseValue(const char *p, const char *end, int depth)
+        {
+            if (p >= end || depth > MAX_DEPTH)
+                return NULL;
+
+            if (*p == '{' || *p == '[')
+            {
+                bool object = *p == '{';
+                char close = object ? '}' : ']';
+                size_t index = push(object ? JSON_OBJECT : JSON_ARRAY, p);
+
+                p = skip(p + 1, end);
+
+                while (p < end && *p != close)
+                {
+                    if (tokens[index].size > 0)
+                    {
+                        if (*p != ',')
+                            return NULL;
+
+                        p = skip(p + 1, end);
+                    }
+
+                    if (object)
+                    {
+                        if (p >= end || *p != '"' || (p = parseValue(p, end, depth + 1)) == NULL)
+                            return NULL;
+
+                        p = skip(p, end);
+
+                        if (p >= end || *p != ':')
+                            return NULL;
+
+                        p = skip(p + 1, end);
+                    }
+
+                    if ((p = parseValue(p, end, depth + 1)) == NULL)
+                        return NULL;
+
+                    tokens[index].size++;
+                    p = skip(p, end);
+                }
+
+                if (p >= end)
+                    return NULL;
+
+                tokens[index].end = p + 1 - text;
+                tokens[index].next = tokens.size();
+
+                return p + 1;
+            }
+
+            if (*p == '"')
+            {
+                size_t index = push(JSON_STRING, p + 1);
+
+                for (p++; p < end && *p != '"'; p++)
+                {
+                    if (*p == '\\')
+                        p++;
+                }
+
+                if (p >= end)
+                    return NULL;
+
+                tokens[index].end = p - text;
+                tokens[index].next = tokens.size();
+
+                return p + 1;
+            }
+
+            size_t index = push(JSON_PRIMITIVE, p);
+
+            while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+                p++;
+
+            if (p == text + tokens[index].start)
+                return NULL;
+
+            tokens[index].end = p - text;
+            tokens[index].next = tokens.size();
+
+            return p;
+        }
+};
+
+// a typed view of one glTF accessor inside its buffer
+struct GltfAccessor
+{
+    const uint8_t *data;
+    size_t count, stride;
+    long componentType;
+    int components;
+    bool normalized;
+};
+
+static size_t componentSize(long componentType)
+{
+    switch (componentType)
+    {
+        case 5120: case 5121: return 1; // byte, unsigned byte
+        case 5122: case 5123: return 2; // short, unsigned short
+        case 5125: case 5126: return 4; // unsigned int, float
+        default: return 0;
+    }
+}
+
+static bool readAccessor(JsonDocument &json, long accessorIndex, const std::vector<const uint8_t*> &bufferData,
+    const std::vector<size_t> &bufferSizes, int components, GltfAccessor &accessor)
+{
+    int accessorToken = json.at(json.find(0, "accessors"), accessorIndex);
+    int viewToken = json.at(json.find(0, "bufferViews"), json.integer(json.find(accessorToken, "bufferView"), -1));
+
+    if (accessorToken < 0 || viewToken < 0 || json.find(accessorToken, "sparse") >= 0)
+        return false;
+
+    long bufferIndex = json.integer(json.find(viewToken, "buffer"), -1);
+
+    if (bufferIndex < 0 || (size_t)bufferIndex >= bufferData.size() || bufferData[bufferIndex] == NULL)
+        return false;
+
+    accessor.componentType = json.integer(json.find(accessorToken, "componentType"), 0);
+    accessor.count = json.integer(json.find(accessorToken, "count"), 0);
+    accessor.components = components;
+    accessor.normalized = json.boolean(json.find(accessorToken, "normalized"));
+
+    size_t elementSize = componentSize(accessor.componentType) * components;
+    size_t viewOffset = json.integer(json.find(viewToken, "byteOffset"), 0);
+    size_t viewLength = json.integer(json.find(viewToken, "byteLength"), 0);
+    size_t offset = json.integer(json.find(accessorToken, "byteOffset"), 0);
+
+    accessor.stride = json.integer(json.find(viewToken, "byteStride"), 0);
+
+    if (accessor.stride == 0)
+        accessor.stride = elementSize;
+
+    // every element has to lie inside the view, and the view inside its buffer
+    if (elementSize == 0 || accessor.count == 0 || viewOffset + viewLength > bufferSizes[bufferIndex] ||
+        offset + accessor.stride * (accessor.count - 1) + elementSize > viewLength)
+        return false;
+
+    accessor.data = bufferData[bufferIndex] + viewOffset + offset;
+
+    return true;
+}
+
+static float readComponent(const GltfAccessor &accessor, size_t element, int component)
+{
+    const uint8_t *p = accessor.data + element * accessor.stride;
+
+    switch (accessor.componentType)
+    {
+        case 5126:
+        {
+            float value;
+            memcpy(&value, p + component * 4, 4);
+            return value;
+        }
+        case 5121:
+            return accessor.normalized ? p[component] / 255.0f : p[component];
+        case 5123:
+        {
+            uint16_t value;
+            memcpy(&value, p + component * 2, 2);
+            return accessor.normalized ? value / 65535.0f : value;
+        }
+        case 5120:
+            return accessor.normalized ? fmax((int8_t)p[component] / 127.0f, -1.0f) : (int8_t)p[component];
+        case 5122:
+        {
+            int16_t value;
+            memcpy(&value, p + component * 2, 2);
+            return accessor.normalized ? fmax(value / 32767.0f, -1.0f) : value;
+        }
+        default:
+            return 0.0f;
+    }
+}
+
+static uint32_t readIndex(const GltfAccessor &accessor, size_t element)
+{
+    const uint8_t *p = accessor.data + element * accessor.stride;
+
+    if (accessor.componentType == 5121)
+        return *p;
+
+    if (accessor.componentType == 5123)
+    {
+        uint16_t value;
+        memcpy(&value, p, 2);
+        return value;
+    }
+
+    uint32_t value;
+    memcpy(&value, p, 4);
+    return value;
+}
+
+ModelLoader::ModelLoader()
+{
+    jobs = NULL;
+    lastDedupRatio = 1.0;
+}
+
+bool ModelLoader::load(const char *fileLocation, ModelData &model)
+{
+    if (hasExtension(fileLocation, ".obj"))
+        return loadObj(fileLocation, model);
+
+    if (hasExtension(fileLocation, ".gltf") || hasExtension(fileLocation, ".glb"))
+        return loadGltf(fileLocation, model);
+
+    printf("Unknown model format %s \n", fileLocation);
+    return false;
+}
+
+bool ModelLoader::mapFile(const char *fileLocation, MappedFile &file)
+{
+    file.data = NULL;
+    file.size = 0;
+    file.mapping = NULL;
+    file.fallback.clear();
+
+#if defined(__unix__) || defined(__APPLE__)
+    int descriptor = open(fileLocation, O_RDONLY);
+
+    if (descriptor < 0)
+    {
+        printf("Failed to open %s \n", fileLocation);
+        return false;
+    }
+
+    struct stat info;
+
+    if (fstat(descriptor, &info) == 0)
+    {
+        file.size = info.st_size;
+
+        if (file.size == 0)
+        {
+            close(descriptor);
+            return true;
+        }
+
+        void *mapping = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        if (mapping != MAP_FAILED)
+        {
+            // every chunk is about to be read at once by the workers
+            madvise(mapping, file.size, MADV_WILLNEED);
+
+            file.mapping = mapping;
+            file.data = (const char*)mapping;
+        }
+    }
+
+    close(descriptor);
+
+    if (file.mapping != NULL)
+        return true;
+#endif
+
+    // no mapping on this platform, or it failed: read the whole file instead
+    FILE *stream = fopen(fileLocation, "rb");
+
+    if (!stream)
+    {
+        printf("Failed to open %s \n", fileLocation);
+        return false;
+    }
+
+    fseek(stream, 0, SEEK_END);
+    long size = ftell(stream);
+    fseek(stream, 0, SEEK_SET);
+
+    file.fallback.resize(size > 0 ? size : 0);
+    file.size = fread(file.fallback.data(), 1, file.fallback.size(), stream);
+    file.data = file.fallback.data();
+
+    fclose(stream);
+
+    return true;
+}
+
+void ModelLoader::unmapFile(MappedFile &file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (file.mapping != NULL)
+        munmap(file.mapping, file.size);
+#endif
+
+    file.mapping = NULL;
+    file.data = NULL;
+    file.size = 0;
+    file.fallback.clear();
+}
+
+bool ModelLoader::loadObj(const char *fileLocation, ModelData &model)
+{
+    PROFILE_SCOPE("loadObj");
+
+    MappedFile file;
+
+    if (!mapFile(fileLocation, file))
+        return false;
+
+    // chunks end on line breaks, so no line is split between two jobs
+    chunks.clear();
+
+    const char *p = file.data;
+    const char *fileEnd = file.data + file.size;
+
+    while (p < fileEnd)
+    {
+        const char *chunkEnd = (size_t)(fileEnd - p) > OBJ_CHUNK_SIZE ? p + OBJ_CHUNK_SIZE : fileEnd;
+
+        if (chunkEnd < fileEnd)
+        {
+            const char *newline = (const char*)memchr(chunkEnd, '\n', fileEnd - chunkEnd);
+            chunkEnd = newline ? newline + 1 : fileEnd;
+        }
+
+        ObjChunk chunk;
+        memset(&chunk, 0, sizeof(chunk));
+        chunk.begin = p;
+        chunk.end = chunkEnd;
+
+        chunks.push_back(chunk);
+        p = chunkEnd;
+    }
+
+    bool parallel = jobs != NULL && chunks.size() > 1;
+
+    // first pass only counts, so the shared arrays are sized once & every chunk knows where to write
+    if (parallel)
+    {
+        jobs->parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c++)
+                countChunk(chunks[c]);
+        });
+    }
+    else
+    {
+        for (size_t c = 0; c < chunks.size(); c++)
+            countChunk(chunks[c]);
+    }
+
+    size_t positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0;
+
+    for (size_t c = 0; c < chunks.size(); c++)
+    {
+        chunks[c].positionBase = positionCount;
+        chunks[c].texCoordBase = texCoordCount;
+        chunks[c].normalBase = normalCount;
+        chunks[c].cornerBase = cornerCount;
+
+        positionCount += chunks[c].positions;
+        texCoordCount += chunks[c].texCoords;
+        normalCount += chunks[c].normals;
+        cornerCount += chunks[c].corners;
+    }
+
+    positions.resize(positionCount * 3);
+    texCoords.resize(texCoordCount * 2);
+    normals.resize(normalCount * 3);
+    corners.resize(cornerCount * 3);
+
+    if (parallel)
+    {
+        jobs->parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c++)
+                parseChunk(chunks[c]);
+        });
+    }
+    else
+    {
+        for (size_t c = 0; c < chunks.size(); c++)
+            parseChunk(chunks[c]);
+    }
+
+    bool valid = true;
+
+    for (size_t c = 0; c < chunks.size() && valid; c++)
+    {
+        if (chunks[c].error != NULL)
+        {
+            printf("Failed to parse %s at byte %zu \n", fileLocation, (size_t)(chunks[c].error - file.data));
+            valid = false;
+        }
+    }
+
+    if (valid && cornerCount == 0)
+    {
+        printf("No triangles in %s \n", fileLocation);
+        valid = false;
+    }
+
+    if (valid && !buildObjVertices(model))
+    {
+        printf("Face index out of range in %s \n", fileLocation);
+        valid = false;
+    }
+
+    unmapFile(file);
+
+    if (!valid)
+        return false;
+
+    computeNormals(model);
+    computeBounds(model);
+
+    return true;
+}
+
+void ModelLoader::countChunk(ObjChunk &chunk)
+{
+    PROFILE_SCOPE("count obj chunk");
+
+    const char *p = chunk.begin;
+
+    while (p < chunk.end)
+    {
+        const char *lineEnd = (const char*)memchr(p, '\n', chunk.end - p);
+
+        if (lineEnd == NULL)
+            lineEnd = chunk.end;
+
+        p = skipBlanks(p, lineEnd);
+
+        if (lineEnd - p >= 2 && p[0] == 'v')
+        {
+            if (isBlank(p[1]))
+                chunk.positions++;
+            else if (p[1] == 't' && lineEnd - p >= 3 && isBlank(p[2]))
+                chunk.texCoords++;
+            else if (p[1] == 'n' && lineEnd - p >= 3 && isBlank(p[2]))
+                chunk.normals++;
+        }
+        else if (lineEnd - p >= 2 && p[0] == 'f' && isBlank(p[1]))
+        {
+            // a polygon of n corners is fanned into n - 2 triangles
+            size_t cornerTokens = 0;
+
+            for (p = skipBlanks(p + 1, lineEnd); p < lineEnd; p = skipBlanks(p, lineEnd))
+            {
+                cornerTokens++;
+
+                while (p < lineEnd && !isBlank(*p))
+                    p++;
+            }
+
+            if (cornerTokens >= 3)
+                chunk.corners += (cornerTokens - 2) * 3;
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+void ModelLoader::parseChunk(ObjChunk &chunk)
+{
+    PROFILE_SCOPE("parse obj chunk");
+
+    size_t positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0;
+    const char *p = chunk.begin;
+
+    while (p < chunk.end)
+    {
+        const char *lineStart = p;
+        const char *lineEnd = (const char*)memchr(p, '\n', chunk.end - p);
+
+        if (lineEnd == NULL)
+            lineEnd = chunk.end;
+
+        p = skipBlanks(p, lineEnd);
+
+        bool ok = true;
+
+        if (lineEnd - p >= 2 && p[0] == 'v' && isBlank(p[1]))
+        {
+            GLfloat *out = &positions[(chunk.positionBase + positionCount++) * 3];
+            p += 1;
+
+            for (int i = 0; i < 3 && ok; i++)
+                ok = (p = parseFloat(skipBlanks(p, lineEnd), lineEnd, out[i])) != NULL;
+        }
+        else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2]))
+        {
+            GLfloat *out = &texCoords[(chunk.texCoordBase + texCoordCount++) * 2];
+            p += 2;
+
+            // the second coordinate is optional
+            ok = (p = parseFloat(skipBlanks(p, lineEnd), lineEnd, out[0])) != NULL;
+
+            if (ok && parseFloat(skipBlanks(p, lineEnd), lineEnd, out[1]) == NULL)
+                out[1] = 0.0f;
+        }
+        else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2]))
+        {
+            GLfloat *out = &normals[(chunk.normalBase + normalCount++) * 3];
+            p += 2;
+
+            for (int i = 0; i < 3 && ok; i++)
+                ok = (p = parseFloat(skipBlanks(p, lineEnd), lineEnd, out[i])) != NULL;
+        }
+        else if (lineEnd - p >= 2 && p[0] == 'f' && isBlank(p[1]))
+        {
+            int32_t first[3], previous[3];
+            size_t cornerTokens = 0;
+
+            for (p = skipBlanks(p + 1, lineEnd); p < lineEnd && ok; p = skipBlanks(p, lineEnd))
+            {
+                // v, v/vt, v//vn or v/vt/vn
+                long values[3] = { 0, 0, 0 };
+                int32_t corner[3] = { -1, -1, -1 };
+
+                ok = (p = parseInt(p, lineEnd, values[0])) != NULL;
+
+                if (ok && p < lineEnd && *p == '/')
+                {
+                    p++;
+
+                    if (p < lineEnd && *p != '/')
+                        ok = (p = parseInt(p, lineEnd, values[1])) != NULL;
+
+                    if (ok && p < lineEnd && *p == '/')
+                        ok = (p = parseInt(p + 1, lineEnd, values[2])) != NULL;
+                }
+
+                if (!ok || (p < lineEnd && !isBlank(*p)))
+                {
+                    ok = false;
+                    break;
+                }
+
+                corner[0] = resolveIndex(values[0], chunk.positionBase + positionCount);
+
+                if (values[1] != 0)
+                    corner[1] = resolveIndex(values[1], chunk.texCoordBase + texCoordCount);
+
+                if (values[2] != 0)
+                    corner[2] = resolveIndex(values[2], chunk.normalBase + normalCount);
+
+                if (corner[0] == INT32_MIN || corner[1] == INT32_MIN || corner[2] == INT32_MIN)
+                {
+                    ok = false;
+                    break;
+                }
+
+                if (cornerTokens == 0)
+                    memcpy(first, corner, sizeof(first));
+
+                // fan around the first corner
+                if (cornerTokens >= 2)
+                {
+                    int32_t *out = &corners[(chunk.cornerBase + cornerCount) * 3];
+
+                    memcpy(out, first, sizeof(first));
+                    memcpy(out + 3, previous, sizeof(previous));
+                    memcpy(out + 6, corner, sizeof(corner));
+
+                    cornerCount += 3;
+                }
+
+                memcpy(previous, corner, sizeof(previous));
+                cornerTokens++;
+            }
+        }
+
+        if (!ok)
+        {
+            chunk.error = lineStart;
+            return;
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+bool ModelLoader::buildObjVertices(ModelData &model)
+{
+    PROFILE_SCOPE("dedup obj vertices");
+
+    size_t cornerCount = corners.size() / 3;
+    size_t positionCount = positions.size() / 3;
+    size_t texCoordCount = texCoords.size() / 2;
+    size_t normalCount = normals.size() / 3;
+
+    uint32_t mask = nextPowerOfTwo(cornerCount * 2) - 1;
+    table.assign(mask + 1, 0);
+    firstCorner.resize(cornerCount);
+
+    // at most one vertex per corner, trimmed at the end
+    model.vertices.resize(cornerCount * ModelData::FLOATS_PER_VERTEX);
+    model.indices.resize(cornerCount);
+
+    size_t vertexCount = 0;
+
+    for (size_t c = 0; c < cornerCount; c++)
+    {
+        const int32_t *corner = &corners[c * 3];
+
+        if (corner[0] < 0 || (size_t)corner[0] >= positionCount || corner[1] >= (int32_t)texCoordCount || corner[2] >= (int32_t)normalCount)
+            return false;
+
+        uint32_t slot = hashWords((const uint32_t*)corner, 3) & mask;
+
+        // linear probing, the table is at most half full
+        while (table[slot] != 0)
+        {
+            const int32_t *other = &corners[firstCorner[table[slot] - 1] * 3];
+
+            if (other[0] == corner[0] && other[1] == corner[1] && other[2] == corner[2])
+                break;
+
+            slot = (slot + 1) & mask;
+        }
+
+        if (table[slot] == 0)
+        {
+            GLfloat *out = &model.vertices[vertexCount * ModelData::FLOATS_PER_VERTEX];
+
+            memcpy(out, &positions[corner[0] * 3], 3 * sizeof(GLfloat));
+
+            if (corner[2] >= 0)
+                memcpy(out + 3, &normals[corner[2] * 3], 3 * sizeof(GLfloat));
+            else
+                out[3] = out[4] = out[5] = 0.0f;
+
+            if (corner[1] >= 0)
+                memcpy(out + 6, &texCoords[corner[1] * 2], 2 * sizeof(GLfloat));
+            else
+                out[6] = out[7] = 0.0f;
+
+            firstCorner[vertexCount] = c;
+            table[slot] = ++vertexCount;
+        }
+
+        model.indices[c] = table[slot] - 1;
+    }
+
+    model.vertices.resize(vertexCount * ModelData::FLOATS_PER_VERTEX);
+    lastDedupRatio = (double)vertexCount / cornerCount;
+
+    return true;
+}
+
+bool ModelLoader::loadGltf(const char *fileLocation, ModelData &model)
+{
+    PROFILE_SCOPE("loadGltf");
+
+    MappedFile file;
+
+    if (!mapFile(fileLocation, file))
+        return false;
+
+    const char *jsonText = file.data;
+    size_t jsonLength = file.size;
+    const uint8_t *binary = NULL;
+    size_t binaryLength = 0;
+
+    // .glb: a 12 byte header, then a JSON chunk & an optional binary chunk
+    if (file.size >= 20 && memcmp(file.data, "glTF", 4) == 0)
+    {
+        uint32_t header[5];
+        memcpy(header, file.data, sizeof(header));
+
+        if (header[1] != 2 || header[3] + 20 > file.size || header[4] != 0x4E4F534A)
+        {
+            printf("Unsupported binary glTF %s \n", fileLocation);
+            unmapFile(file);
+            return false;
+        }
+
+        jsonText = file.data + 20;
+        jsonLength = header[3];
+
+        size_t binaryStart = 20 + ((jsonLength + 3) & ~(size_t)3);
+
+        if (binaryStart + 8 <= file.size)
+        {
+            uint32_t chunkHeader[2];
+            memcpy(chunkHeader, file.data + binaryStart, sizeof(chunkHeader));
+
+            if (chunkHeader[1] == 0x004E4942 && binaryStart + 8 + chunkHeader[0] <= file.size)
+            {
+                binary = (const uint8_t*)file.data + binaryStart + 8;
+                binaryLength = chunkHeader[0];
+            }
+        }
+    }
+
+    JsonDocument json;
+
+    if (!json.parse(jsonText, jsonLength))
+    {
+        printf("Failed to parse the JSON of %s \n", fileLocation);
+        unmapFile(file);
+        return false;
+    }
+
+    // buffers without a uri are the .glb's binary chunk, the rest are files next to this one
+    std::string directory(fileLocation);
+    size_t slash = directory.find_last_of("/\\");
+    directory = slash == std::string::npos ? "" : directory.substr(0, slash + 1);
+
+    int buffersToken = json.find(0, "buffers");
+    size_t bufferCount = json.count(buffersToken);
+
+    std::vector<MappedFile> externals(bufferCount);
+    std::vector<const uint8_t*> bufferData(bufferCount, NULL);
+    std::vector<size_t> bufferSizes(bufferCount, 0);
+
+    bool valid = true;
+
+    for (size_t b = 0; b < bufferCount && valid; b++)
+    {
+        int uriToken = json.find(json.at(buffersToken, b), "uri");
+
+        if (uriToken < 0)
+        {
+            bufferData[b] = binary;
+            bufferSizes[b] = binaryLength;
+            continue;
+        }
+
+        std::string uri = json.string(uriToken);
+
+        if (uri.compare(0, 5, "data:") == 0)
+        {
+            printf("Embedded data URIs are not supported in %s \n", fileLocation);
+            valid = false;
+        }
+        else if (mapFile((directory + uri).c_str(), externals[b]))
+        {
+            bufferData[b] = (const uint8_t*)externals[b].data;
+            bufferSizes[b] = externals[b].size;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    // every triangle primitive of every mesh, appended in order
+    struct Primitive
+    {
+        GltfAccessor positions, normals, texCoords, indices;
+        bool hasNormals, hasTexCoords, hasIndices;
+        size_t vertexBase, indexBase;
+    };
+
+    std::vector<Primitive> primitives;
+    size_t vertexCount = 0, indexCount = 0;
+
+    int meshesToken = json.find(0, "meshes");
+
+    for (size_t m = 0; m < json.count(meshesToken) && valid; m++)
+    {
+        int primitivesToken = json.find(json.at(meshesToken, m), "primitives");
+
+        for (size_t i = 0; i < json.count(primitivesToken) && valid; i++)
+        {
+            int primitiveToken = json.at(primitivesToken, i);
+            int attributes = json.find(primitiveToken, "attributes");
+
+            // points & lines have no place in a triangle list
+            if (json.integer(json.find(primitiveToken, "mode"), 4) != 4)
+                continue;
+
+            Primitive primitive;
+            long positionAccessor = json.integer(json.find(attributes, "POSITION"), -1);
+            long normalAccessor = json.integer(json.find(attributes, "NORMAL"), -1);
+            long texCoordAccessor = json.integer(json.find(attributes, "TEXCOORD_0"), -1);
+            long indexAccessor = json.integer(json.find(primitiveToken, "indices"), -1);
+
+            valid = positionAccessor >= 0 && readAccessor(json, positionAccessor, bufferData, bufferSizes, 3, primitive.positions);
+
+            primitive.hasNormals = valid && normalAccessor >= 0 && readAccessor(json, normalAccessor, bufferData, bufferSizes, 3, primitive.normals) &&
+                primitive.normals.count == primitive.positions.count;
+            primitive.hasTexCoords = valid && texCoordAccessor >= 0 && readAccessor(json, texCoordAccessor, bufferData, bufferSizes, 2, primitive.texCoords) &&
+                primitive.texCoords.count == primitive.positions.count;
+            primitive.hasIndices = valid && indexAccessor >= 0;
+
+            if (primitive.hasIndices)
+                valid = readAccessor(json, indexAccessor, bufferData, bufferSizes, 1, primitive.indices) && primitive.indices.componentType != 5126;
+
+            if (!valid)
+            {
+                printf("Unsupported or out of range accessor in mesh %zu of %s \n", m, fileLocation);
+                break;
+            }
+
+            primitive.vertexBase = vertexCount;
+            primitive.indexBase = indexCount;
+
+            vertexCount += primitive.positions.count;
+            indexCount += (primitive.hasIndices ? primitive.indices.count : primitive.positions.count) / 3 * 3;
+
+            primitives.push_back(primitive);
+        }
+    }
+
+    if (valid && indexCount == 0)
+    {
+        printf("No triangles in %s \n", fileLocation);
+        valid = false;
+    }
+
+    if (valid)
+    {
+        model.vertices.resize(vertexCount * ModelData::FLOATS_PER_VERTEX);
+        model.indices.resize(indexCount);
+
+        for (size_t i = 0; i < primitives.size() && valid; i++)
+        {
+            const Primitive &primitive = primitives[i];
+            size_t primitiveIndices = (primitive.hasIndices ? primitive.indices.count : primitive.positions.count) / 3 * 3;
+
+            // interleaving is independent per vertex, so large primitives are split over the workers
+            auto interleave = [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++)
+                {
+                    GLfloat *out = &model.vertices[(primitive.vertexBase + v) * ModelData::FLOATS_PER_VERTEX];
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        out[c] = readComponent(primitive.positions, v, c);
+                        out[3 + c] = primitive.hasNormals ? readComponent(primitive.normals, v, c) : 0.0f;
+                    }
+
+                    out[6] = primitive.hasTexCoords ? readComponent(primitive.texCoords, v, 0) : 0.0f;
+                    out[7] = primitive.hasTexCoords ? readComponent(primitive.texCoords, v, 1) : 0.0f;
+                }
+            };
+
+            if (jobs != NULL && primitive.positions.count >= 65536)
+                jobs->parallelFor(primitive.positions.count, 0, interleave);
+            else
+                interleave(0, primitive.positions.count);
+
+            for (size_t j = 0; j < primitiveIndices; j++)
+            {
+                uint32_t index = primitive.hasIndices ? readIndex(primitive.indices, j) : j;
+
+                if (index >= primitive.positions.count)
+                {
+                    printf("Index out of range in %s \n", fileLocation);
+                    valid = false;
+                    break;
+                }
+
+                model.indices[primitive.indexBase + j] = primitive.vertexBase + index;
+            }
+        }
+    }
+
+    for (size_t b = 0; b < externals.size(); b++)
+        unmapFile(externals[b]);
+
+    unmapFile(file);
+
+    if (!valid)
+        return false;
+
+    // exporters split vertices per primitive & per seam, merge the ones that ended up identical
+    dedupVertices(model);
+
+    computeNormals(model);
+    computeBounds(model);
+
+    return true;
+}
+
+void ModelLoader::dedupVertices(ModelData &model)
+{
+    PROFILE_SCOPE("dedup vertices");
+
+    const size_t stride = ModelData::FLOATS_PER_VERTEX;
+    size_t vertexCount = model.getVertexCount();
+
+    uint32_t mask = nextPowerOfTwo(vertexCount * 2) - 1;
+    table.assign(mask + 1, 0);
+    firstCorner.resize(vertexCount);
+
+    // compacts in place: a vertex only ever moves down to a slot that has already been read
+    size_t uniqueCount = 0;
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        const GLfloat *vertex = &model.vertices[v * stride];
+        uint32_t slot = hashWords((const uint32_t*)vertex, stride) & mask;
+
+        while (table[slot] != 0 && memcmp(&model.vertices[(table[slot] - 1) * stride], vertex, stride * sizeof(GLfloat)) != 0)
+            slot = (slot + 1) & mask;
+
+        if (table[slot] == 0)
+        {
+            if (uniqueCount != v)
+                memcpy(&model.vertices[uniqueCount * stride], vertex, stride * sizeof(GLfloat));
+
+            table[slot] = ++uniqueCount;
+        }
+
+        firstCorner[v] = table[slot] - 1;
+    }
+
+    for (size_t i = 0; i < model.indices.size(); i++)
+        model.indices[i] = firstCorner[model.indices[i]];
+
+    model.vertices.resize(uniqueCount * stride);
+    lastDedupRatio = vertexCount > 0 ? (double)uniqueCount / vertexCount : 1.0;
+}
+
+void ModelLoader::computeNormals(ModelData &model)
+{
+    PROFILE_SCOPE("compute normals");
+
+    const size_t stride = ModelData::FLOATS_PER_VERTEX;
+    GLfloat *vertices = model.vertices.data();
+
+    // area weighted face normals, only for the vertices the file gave none
+    std::vector<bool> missing(model.getVertexCount());
+    bool anyMissing = false;
+
+    for (size_t v = 0; v < missing.size(); v++)
+    {
+        GLfloat *n = &vertices[v * stride + 3];
+        missing[v] = n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f;
+        anyMissing = anyMissing || missing[v];
+    }
+
+    if (!anyMissing)
+        return;
+
+    for (size_t i = 0; i + 2 < model.indices.size(); i += 3)
+    {
+        const unsigned int *triangle = &model.indices[i];
+
+        glm::vec3 a(vertices[triangle[0] * stride], vertices[triangle[0] * stride + 1], vertices[triangle[0] * stride + 2]);
+        glm::vec3 b(vertices[triangle[1] * stride], vertices[triangle[1] * stride + 1], vertices[triangle[1] * stride + 2]);
+        glm::vec3 c(vertices[triangle[2] * stride], vertices[triangle[2] * stride + 1], vertices[triangle[2] * stride + 2]);
+        glm::vec3 face = glm::cross(b - a, c - a);
+
+        for (int k = 0; k < 3; k++)
+        {
+            if (!missing[triangle[k]])
+                continue;
+
+            GLfloat *n = &vertices[triangle[k] * stride + 3];
+            n[0] += face.x;
+            n[1] += face.y;
+            n[2] += face.z;
+        }
+    }
+
+    for (size_t v = 0; v < missing.size(); v++)
+    {
+        if (!missing[v])
+            continue;
+
+        GLfloat *n = &vertices[v * stride + 3];
+        GLfloat length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+        if (length > 0.0f)
+        {
+            n[0] /= length;
+            n[1] /= length;
+            n[2] /= length;
+        }
+    }
+}
+
+void ModelLoader::computeBounds(ModelData &model)
+{
+    const size_t stride = ModelData::FLOATS_PER_VERTEX;
+    size_t vertexCount = model.getVertexCount();
+
+    glm::vec3 minimum(INFINITY), maximum(-INFINITY);
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        glm::vec3 position(model.vertices[v * stride], model.vertices[v * stride + 1], model.vertices[v * stride + 2]);
+
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+
+    model.boundsCentre = (minimum + maximum) * 0.5f;
+    model.boundsRadius = 0.0f;
+
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        glm::vec3 position(model.vertices[v * stride], model.vertices[v * stride + 1], model.vertices[v * stride + 2]);
+        model.boundsRadius = fmax(model.boundsRadius, glm::length(position - model.boundsCentre));
+    }
+}
+
+ModelLoader::~ModelLoader()
+{
+
+}
\ No newline at end of file
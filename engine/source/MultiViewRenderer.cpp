@@ -0,0 +1,371 @@
+#include "../headers/MultiViewRenderer.h"
+
+MultiViewRenderer::MultiViewRenderer()
+{
+    unionMin = glm::vec3(0.0f);
+    unionMax = glm::vec3(0.0f);
+
+    perViewShader = NULL;
+    instancedShader = NULL;
+    overrideShader = NULL;
+
+    jobs = NULL;
+    arena = NULL;
+
+    uniformViewMask = 0;
+}
+
+bool MultiViewRenderer::instancingSupported()
+{
+    // selecting the viewport from the vertex shader needs both extensions
+    return GLEW_ARB_viewport_array && GLEW_ARB_shader_viewport_layer_array;
+}
+
+void MultiViewRenderer::setShaders(Shader *perViewShader, Shader *instancedShader)
+{
+    this->perViewShader = perViewShader;
+    this->instancedShader = instancedShader;
+}
+
+int MultiViewRenderer::addView(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    if (views.size() >= MAX_VIEWS)
+    {
+        printf("Multi-view renderer supports at most %zu views \n", MAX_VIEWS);
+        return -1;
+    }
+
+    View newView;
+    newView.x = x;
+    newView.y = y;
+    newView.width = width;
+    newView.height = height;
+    newView.view = glm::mat4(1.0f);
+    newView.projection = glm::mat4(1.0f);
+
+    views.push_back(newView);
+    drawLists.resize(views.size());
+
+    return (int)views.size() - 1;
+}
+
+void MultiViewRenderer::setViewMatrices(size_t viewIndex, glm::mat4 view, glm::mat4 projection)
+{
+    views[viewIndex].view = view;
+    views[viewIndex].projection = projection;
+}
+
+void MultiViewRenderer::clearViews()
+{
+    views.clear();
+    drawLists.clear();
+}
+
+void MultiViewRenderer::updateFrustums()
+{
+    planes.resize(views.size() * 6);
+    viewProjections.resize(views.size());
+
+    unionMin = glm::vec3(INFINITY);
+    unionMax = glm::vec3(-INFINITY);
+
+    for (size_t v = 0; v < views.size(); v++)
+    {
+        glm::mat4 m = views[v].projection * views[v].view;
+        viewProjections[v] = m;
+
+        // planes straight from the rows of the view-projection matrix (Gribb & Hartmann)
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        glm::vec4 *viewPlanes = &planes[v * 6];
+        viewPlanes[0] = row3 + row0; // left
+        viewPlanes[1] = row3 - row0; // right
+        viewPlanes[2] = row3 + row1; // bottom
+        viewPlanes[3] = row3 - row1; // top
+        viewPlanes[4] = row3 + row2; // near
+        viewPlanes[5] = row3 - row2; // far
+
+        for (size_t p = 0; p < 6; p++)
+            viewPlanes[p] /= glm::length(glm::vec3(viewPlanes[p]));
+
+        // grow the union box by the eight frustum corners
+        glm::mat4 inverse = glm::inverse(m);
+
+        for (int corner = 0; corner < 8; corner++)
+        {
+            glm::vec4 ndc((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f, 1.0f);
+            glm::vec4 world = inverse * ndc;
+            glm::vec3 point = glm::vec3(world) / world.w;
+
+            unionMin = glm::min(unionMin, point);
+            unionMax = glm::max(unionMax, point);
+        }
+    }
+}
+
+void MultiViewRenderer::cull(const std::vector<RenderObject> &objects)
+{
+    PROFILE_SCOPE("cull");
+
+    updateFrustums();
+
+    // with an arena every list starts over in this frame's memory, otherwise heap storage is kept and reused
+    if (arena != NULL)
+    {
+        FrameAllocator<uint32_t> allocator(arena);
+        visibility = FrameVector<uint32_t>(allocator);
+
+        for (size_t v = 0; v < drawLists.size(); v++)
+        {
+            drawLists[v] = FrameVector<uint32_t>(allocator);
+            drawLists[v].reserve(objects.size());
+        }
+    }
+
+    visibility.resize(objects.size());
+
+    for (size_t v = 0; v < drawLists.size(); v++)
+        drawLists[v].clear();
+
+    // a single pass over the scene, split across the job system for large scenes
+    if (jobs != NULL && objects.size() >= PARALLEL_CULL_THRESHOLD)
+        jobs->parallelFor(objects.size(), 0, [&](size_t begin, size_t end) { cullRange(objects, begin, end); });
+    else
+        cullRange(objects, 0, objects.size());
+
+    // emit per view draw lists from the masks
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        uint32_t mask = visibility[i];
+
+        while (mask)
+        {
+            int v = __builtin_ctz(mask);
+            drawLists[v].push_back(i);
+            mask &= mask - 1;
+        }
+    }
+}
+
+void MultiViewRenderer::cullRange(const std::vector<RenderObject> &objects, size_t begin, size_t end)
+{
+    PROFILE_SCOPE("cull range");
+
+    size_t viewCount = views.size();
+
+    // every object is tested against all views at once
+    for (size_t i = begin; i < end; i++)
+    {
+        const glm::vec3 &c = objects[i].center;
+        GLfloat r = objects[i].radius;
+        uint32_t mask = 0;
+
+        // cheap reject against the union of all frustums
+        if (c.x + r >= unionMin.x && c.x - r <= unionMax.x &&
+            c.y + r >= unionMin.y && c.y - r <= unionMax.y &&
+            c.z + r >= unionMin.z && c.z - r <= unionMax.z)
+        {
+            for (size_t v = 0; v < viewCount; v++)
+            {
+                const glm::vec4 *viewPlanes = &planes[v * 6];
+                bool inside = true;
+
+                for (size_t p = 0; p < 6 && inside; p++)
+                    inside = viewPlanes[p].x * c.x + viewPlanes[p].y * c.y + viewPlanes[p].z * c.z + viewPlanes[p].w >= -r;
+
+                if (inside)
+                    mask |= 1u << v;
+            }
+        }
+
+        visibility[i] = mask;
+    }
+}
+
+void MultiViewRenderer::render(const std::vector<RenderObject> &objects, Shader *overrideShader)
+{
+    this->overrideShader = overrideShader;
+
+    bool instanced = overrideShader == NULL && instancedShader != NULL && views.size() <= MAX_INSTANCED_VIEWS &&
+        allUsePerViewShader(objects);
+    size_t drawCount = 0;
+
+    chunks.clear();
+
+    // split the work into fixed ranges, each recorded into its own command buffer
+    if (instanced)
+    {
+        for (size_t begin = 0; begin < objects.size(); begin += RECORD_CHUNK_SIZE)
+        {
+            RecordChunk chunk = { 0, begin, std::min(begin + RECORD_CHUNK_SIZE, objects.size()) };
+            chunks.push_back(chunk);
+        }
+
+        drawCount = objects.size();
+    }
+    else
+    {
+        for (size_t v = 0; v < views.size(); v++)
+        {
+            // an empty view still needs a chunk to set its viewport
+            size_t begin = 0;
+
+            do
+            {
+                RecordChunk chunk = { v, begin, std::min(begin + RECORD_CHUNK_SIZE, drawLists[v].size()) };
+                chunks.push_back(chunk);
+
+                begin += RECORD_CHUNK_SIZE;
+            } while (begin < drawLists[v].size());
+
+            drawCount += drawLists[v].size();
+        }
+    }
+
+    if (commandBuffers.size() < chunks.size())
+        commandBuffers.resize(chunks.size());
+
+    CommandBuffer::ReplayState state;
+
+    // everything that has to touch GL happens here, before recording starts
+    if (instanced)
+        state.program = beginInstanced();
+
+    // recording is pure CPU work, so it can run on any worker
+    {
+        PROFILE_SCOPE("record");
+
+        if (jobs != NULL && drawCount >= PARALLEL_RECORD_THRESHOLD)
+        {
+            jobs->parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; c++)
+                    recordChunk(objects, c, instanced);
+            });
+        }
+        else
+        {
+            for (size_t c = 0; c < chunks.size(); c++)
+                recordChunk(objects, c, instanced);
+        }
+    }
+
+    // replayed in chunk order, so the result matches a serial walk
+    {
+        PROFILE_GPU_SCOPE("replay");
+
+        for (size_t c = 0; c < chunks.size(); c++)
+            commandBuffers[c].replay(state);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    this->overrideShader = NULL;
+}
+
+bool MultiViewRenderer::allUsePerViewShader(const std::vector<RenderObject> &objects)
+{
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        if (objects[i].shader != NULL && objects[i].shader != perViewShader)
+            return false;
+    }
+
+    return true;
+}
+
+GLuint MultiViewRenderer::beginInstanced()
+{
+    GLfloat viewports[MAX_INSTANCED_VIEWS * 4];
+
+    for (size_t v = 0; v < views.size(); v++)
+    {
+        viewports[v * 4 + 0] = views[v].x;
+        viewports[v * 4 + 1] = views[v].y;
+        viewports[v * 4 + 2] = views[v].width;
+        viewports[v * 4 + 3] = views[v].height;
+    }
+
+    glViewportArrayv(0, views.size(), viewports);
+
+    instancedShader->UseShader();
+
+    GLuint uniformViewProjections = instancedShader->GetUniformLocation("viewProjections");
+    uniformViewMask = instancedShader->GetUniformLocation("viewMask");
+
+    glUniformMatrix4fv(uniformViewProjections, views.size(), GL_FALSE, glm::value_ptr(viewProjections[0]));
+    renderStats.add(COUNTER_UNIFORM_UPLOADS, 1);
+
+    return instancedShader->GetShaderId();
+}
+
+void MultiViewRenderer::recordChunk(const std::vector<RenderObject> &objects, size_t chunkIndex, bool instanced)
+{
+    PROFILE_SCOPE("record chunk");
+
+    const RecordChunk &chunk = chunks[chunkIndex];
+    CommandBuffer &commands = commandBuffers[chunkIndex];
+
+    commands.reset();
+
+    if (instanced)
+    {
+        GLuint uniformModel = instancedShader->GetModelLocation();
+
+        // one draw per visible object, one instance per view that sees it, all through the
+        // multi-view program: render() only gets here when no object needs another shader
+        for (size_t i = chunk.begin; i < chunk.end; i++)
+        {
+            uint32_t mask = visibility[i];
+
+            if (!mask)
+                continue;
+
+            commands.uniformMatrix(uniformModel, glm::value_ptr(objects[i].model));
+            commands.uniformUint(uniformViewMask, mask);
+            commands.bindMesh(objects[i].mesh->GetVAO(), objects[i].mesh->GetIBO());
+            commands.drawInstanced(objects[i].mesh->GetIndexCount(), __builtin_popcount(mask));
+        }
+
+        return;
+    }
+
+    const View &view = views[chunk.view];
+    const FrameVector<uint32_t> &drawList = drawLists[chunk.view];
+
+    if (chunk.begin == 0)
+        commands.viewport(view.x, view.y, view.width, view.height);
+
+    // view & projection are set again whenever the program changes, and at the start of every chunk
+    Shader *current = NULL;
+    GLuint uniformModel = 0;
+
+    for (size_t i = chunk.begin; i < chunk.end; i++)
+    {
+        const RenderObject &object = objects[drawList[i]];
+        Shader *shader = overrideShader != NULL ? overrideShader : (object.shader != NULL ? object.shader : perViewShader);
+
+        if (shader != current)
+        {
+            current = shader;
+            commands.useProgram(current->GetShaderId());
+
+            uniformModel = current->GetModelLocation();
+            commands.uniformMatrix(current->GetProjectionLocation(), glm::value_ptr(view.projection));
+            commands.uniformMatrix(current->GetViewLocation(), glm::value_ptr(view.view));
+        }
+
+        commands.uniformMatrix(uniformModel, glm::value_ptr(object.model));
+        commands.bindMesh(object.mesh->GetVAO(), object.mesh->GetIBO());
+        commands.draw(object.mesh->GetIndexCount());
+    }
+}
+
+MultiViewRenderer::~MultiViewRenderer()
+{
+
+}
\ No newline at end of file
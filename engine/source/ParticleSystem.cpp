@@ -0,0 +1,637 @@
+#include "../headers/ParticleSystem.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PARTICLE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// one block's arrays, from its first particle
+struct ParticleStreams
+{
+    GLfloat *px, *py, *pz;
+    GLfloat *vx, *vy, *vz;
+    GLfloat *life;
+};
+
+struct IntegrateParameters
+{
+    GLfloat dt, gravity, damping, ground, restitution;
+};
+
+// integrates particles begin to count, writing the survivors from write on; returns the new write position.
+// write never passes the particle being read, so the block is compacted in place
+typedef size_t (*UpdateFunction)(const ParticleStreams &s, size_t begin, size_t count, size_t write, const IntegrateParameters &p);
+
+static size_t updateScalar(const ParticleStreams &s, size_t begin, size_t count, size_t write, const IntegrateParameters &p)
+{
+    for (size_t i = begin; i < count; i++)
+    {
+        GLfloat vx = s.vx[i] * p.damping;
+        GLfloat vy = (s.vy[i] + p.gravity * p.dt) * p.damping;
+        GLfloat vz = s.vz[i] * p.damping;
+
+        GLfloat px = s.px[i] + vx * p.dt;
+        GLfloat py = s.py[i] + vy * p.dt;
+        GLfloat pz = s.pz[i] + vz * p.dt;
+
+        // under the ground: back on it, heading up with restitution of the speed
+        vy *= py < p.ground ? -p.restitution : 1.0f;
+        py = std::max(py, p.ground);
+
+        GLfloat remaining = s.life[i] - p.dt;
+
+        // every particle is written, only the living move the write position on
+        s.px[write] = px;
+        s.py[write] = py;
+        s.pz[write] = pz;
+        s.vx[write] = vx;
+        s.vy[write] = vy;
+        s.vz[write] = vz;
+        s.life[write] = remaining;
+
+        write += remaining > 0.0f;
+    }
+
+    return write;
+}
+
+#ifdef PARTICLE_KERNELS_X86
+
+static size_t updateSSE(const ParticleStreams &s, size_t begin, size_t count, size_t write, const IntegrateParameters &p)
+{
+    __m128 dt = _mm_set1_ps(p.dt), gravityStep = _mm_set1_ps(p.gravity * p.dt), damping = _mm_set1_ps(p.damping);
+    __m128 ground = _mm_set1_ps(p.ground), bounce = _mm_set1_ps(-p.restitution);
+    __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+
+    alignas(16) GLfloat lanes[7][4];
+
+    size_t i = begin;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vx = _mm_mul_ps(_mm_loadu_ps(s.vx + i), damping);
+        __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(s.vy + i), gravityStep), damping);
+        __m128 vz = _mm_mul_ps(_mm_loadu_ps(s.vz + i), damping);
+
+        __m128 px = _mm_add_ps(_mm_loadu_ps(s.px + i), _mm_mul_ps(vx, dt));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(s.py + i), _mm_mul_ps(vy, dt));
+        __m128 pz = _mm_add_ps(_mm_loadu_ps(s.pz + i), _mm_mul_ps(vz, dt));
+
+        __m128 below = _mm_cmplt_ps(py, ground);
+        vy = _mm_mul_ps(vy, _mm_or_ps(_mm_and_ps(below, bounce), _mm_andnot_ps(below, one)));
+        py = _mm_max_ps(py, ground);
+
+        __m128 remaining = _mm_sub_ps(_mm_loadu_ps(s.life + i), dt);
+        int alive = _mm_movemask_ps(_mm_cmpgt_ps(remaining, zero));
+
+        _mm_store_ps(lanes[0], px);
+        _mm_store_ps(lanes[1], py);
+        _mm_store_ps(lanes[2], pz);
+        _mm_store_ps(lanes[3], vx);
+        _mm_store_ps(lanes[4], vy);
+        _mm_store_ps(lanes[5], vz);
+        _mm_store_ps(lanes[6], remaining);
+
+        // SSE has no lane compaction, so the four are written out one by one as in updateScalar
+        for (int lane = 0; lane < 4; lane++)
+        {
+            s.px[write] = lanes[0][lane];
+            s.py[write] = lanes[1][lane];
+            s.pz[write] = lanes[2][lane];
+            s.vx[write] = lanes[3][lane];
+            s.vy[write] = lanes[4][lane];
+            s.vz[write] = lanes[5][lane];
+            s.life[write] = lanes[6][lane];
+
+            write += (alive >> lane) & 1;
+        }
+    }
+
+    return updateScalar(s, i, count, write, p);
+}
+
+// for every mask of live lanes, the lane indices that pack them to the front
+alignas(32) static int32_t compactTable[256][8];
+
+static void buildCompactTable()
+{
+    for (int mask = 0; mask < 256; mask++)
+    {
+        int packed = 0;
+
+        for (int lane = 0; lane < 8; lane++)
+        {
+            if (mask & (1 << lane))
+                compactTable[mask][packed++] = lane;
+        }
+
+        while (packed < 8)
+            compactTable[mask][packed++] = 0;
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static size_t updateAVX2(const ParticleStreams &s, size_t begin, size_t count, size_t write, const IntegrateParameters &p)
+{
+    __m256 dt = _mm256_set1_ps(p.dt), gravityStep = _mm256_set1_ps(p.gravity * p.dt), damping = _mm256_set1_ps(p.damping);
+    __m256 ground = _mm256_set1_ps(p.ground), bounce = _mm256_set1_ps(-p.restitution);
+    __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+
+    size_t i = begin;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vx = _mm256_mul_ps(_mm256_loadu_ps(s.vx + i), damping);
+        __m256 vy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(s.vy + i), gravityStep), damping);
+        __m256 vz = _mm256_mul_ps(_mm256_loadu_ps(s.vz + i), damping);
+
+        __m256 px = _mm256_fmadd_ps(vx, dt, _mm256_loadu_ps(s.px + i));
+        __m256 py = _mm256_fmadd_ps(vy, dt, _mm256_loadu_ps(s.py + i));
+        __m256 pz = _mm256_fmadd_ps(vz, dt, _mm256_loadu_ps(s.pz + i));
+
+        vy = _mm256_mul_ps(vy, _mm256_blendv_ps(one, bounce, _mm256_cmp_ps(py, ground, _CMP_LT_OQ)));
+        py = _mm256_max_ps(py, ground);
+
+        __m256 remaining = _mm256_sub_ps(_mm256_loadu_ps(s.life + i), dt);
+        int alive = _mm256_movemask_ps(_mm256_cmp_ps(remaining, zero, _CMP_GT_OQ));
+
+        // the survivors permuted to the front & all eight lanes stored, the dead ones land past the new write position
+        __m256i pack = _mm256_load_si256((const __m256i*)compactTable[alive]);
+
+        _mm256_storeu_ps(s.px + write, _mm256_permutevar8x32_ps(px, pack));
+        _mm256_storeu_ps(s.py + write, _mm256_permutevar8x32_ps(py, pack));
+        _mm256_storeu_ps(s.pz + write, _mm256_permutevar8x32_ps(pz, pack));
+        _mm256_storeu_ps(s.vx + write, _mm256_permutevar8x32_ps(vx, pack));
+        _mm256_storeu_ps(s.vy + write, _mm256_permutevar8x32_ps(vy, pack));
+        _mm256_storeu_ps(s.vz + write, _mm256_permutevar8x32_ps(vz, pack));
+        _mm256_storeu_ps(s.life + write, _mm256_permutevar8x32_ps(remaining, pack));
+
+        write += __builtin_popcount(alive);
+    }
+
+    return updateScalar(s, i, count, write, p);
+}
+
+__attribute__((target("avx512f")))
+static size_t updateAVX512(const ParticleStreams &s, size_t begin, size_t count, size_t write, const IntegrateParameters &p)
+{
+    __m512 dt = _mm512_set1_ps(p.dt), gravityStep = _mm512_set1_ps(p.gravity * p.dt), damping = _mm512_set1_ps(p.damping);
+    __m512 ground = _mm512_set1_ps(p.ground), bounce = _mm512_set1_ps(-p.restitution);
+    __m512 zero = _mm512_setzero_ps();
+
+    size_t i = begin;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 vx = _mm512_mul_ps(_mm512_loadu_ps(s.vx + i), damping);
+        __m512 vy = _mm512_mul_ps(_mm512_add_ps(_mm512_loadu_ps(s.vy + i), gravityStep), damping);
+        __m512 vz = _mm512_mul_ps(_mm512_loadu_ps(s.vz + i), damping);
+
+        __m512 px = _mm512_fmadd_ps(vx, dt, _mm512_loadu_ps(s.px + i));
+        __m512 py = _mm512_fmadd_ps(vy, dt, _mm512_loadu_ps(s.py + i));
+        __m512 pz = _mm512_fmadd_ps(vz, dt, _mm512_loadu_ps(s.pz + i));
+
+        vy = _mm512_mask_mul_ps(vy, _mm512_cmp_ps_mask(py, ground, _CMP_LT_OQ), vy, bounce);
+        py = _mm512_max_ps(py, ground);
+
+        __m512 remaining = _mm512_sub_ps(_mm512_loadu_ps(s.life + i), dt);
+        __mmask16 alive = _mm512_cmp_ps_mask(remaining, zero, _CMP_GT_OQ);
+
+        // only the live lanes are stored, packed together
+        _mm512_mask_compressstoreu_ps(s.px + write, alive, px);
+        _mm512_mask_compressstoreu_ps(s.py + write, alive, py);
+        _mm512_mask_compressstoreu_ps(s.pz + write, alive, pz);
+        _mm512_mask_compressstoreu_ps(s.vx + write, alive, vx);
+        _mm512_mask_compressstoreu_ps(s.vy + write, alive, vy);
+        _mm512_mask_compressstoreu_ps(s.vz + write, alive, vz);
+        _mm512_mask_compressstoreu_ps(s.life + write, alive, remaining);
+
+        write += __builtin_popcount(alive);
+    }
+
+    return updateScalar(s, i, count, write, p);
+}
+
+static UpdateFunction selectKernel(const char **name)
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        *name = "avx512";
+        return updateAVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        buildCompactTable();
+
+        *name = "avx2";
+        return updateAVX2;
+    }
+
+    *name = "sse";
+    return updateSSE;
+}
+
+#else
+
+static UpdateFunction selectKernel(const char **name)
+{
+    *name = "scalar";
+    return updateScalar;
+}
+
+#endif
+
+static const char *kernelName = "";
+static UpdateFunction kernel = selectKernel(&kernelName);
+
+// xorshift, 0 to 1
+static inline GLfloat nextRandom(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+ParticleSystem::ParticleSystem()
+{
+    jobs = NULL;
+    blockCount = 0;
+
+    emitter.position = glm::vec3(0.0f, 0.0f, 0.0f);
+    emitter.radius = 0.0f;
+    emitter.velocity = glm::vec3(0.0f, 1.0f, 0.0f);
+    emitter.spread = 0.0f;
+    emitter.rate = 0.0f;
+    emitter.lifetime = 1.0f;
+
+    gravity = -9.81f;
+    drag = 0.0f;
+    groundHeight = -INFINITY;
+    restitution = 0.5f;
+
+    emitAccumulator = 0.0;
+    spawnBacklog = 0;
+    frame = 0;
+
+    liveCount = 0;
+    droppedCount = 0;
+
+    lastUpdateTime = 0.0;
+    updateTotal = 0.0;
+    updatedTotal = 0;
+    updateCount = 0;
+
+    shader = NULL;
+    vertexArray = 0;
+    vertexBuffer = 0;
+    bufferCapacity = 0;
+    uploadedCount = 0;
+    particleSize = 0.05f;
+
+    uniformView = 0;
+    uniformProjection = 0;
+    uniformPointScale = 0;
+    uniformParticleSize = 0;
+}
+
+bool ParticleSystem::reserve(size_t capacity)
+{
+    if (capacity == 0)
+    {
+        printf("Particle system needs room for at least one particle \n");
+        return false;
+    }
+
+    blockCount = (capacity + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    size_t total = blockCount * BLOCK_SIZE;
+
+    positionX.assign(total, 0.0f);
+    positionY.assign(total, 0.0f);
+    positionZ.assign(total, 0.0f);
+    velocityX.assign(total, 0.0f);
+    velocityY.assign(total, 0.0f);
+    velocityZ.assign(total, 0.0f);
+    life.assign(total, 0.0f);
+
+    counts.assign(blockCount, 0);
+    emits.assign(blockCount, 0);
+    offsets.assign(blockCount, 0);
+
+    liveCount = 0;
+
+    return true;
+}
+
+bool ParticleSystem::Initialise(Shader *shader, GLfloat particleSize)
+{
+    if (blockCount == 0)
+    {
+        printf("Particle system needs reserve() before Initialise \n");
+        return false;
+    }
+
+    this->shader = shader;
+    this->particleSize = particleSize;
+
+    // sized for every particle up front, so streaming never reallocates
+    bufferCapacity = getCapacity();
+
+    glGenVertexArrays(1, &vertexArray);
+    glGenBuffers(1, &vertexBuffer);
+
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, bufferCapacity * FLOATS_PER_VERTEX * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+
+    glVertexAttribPointer(0, FLOATS_PER_VERTEX, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(0);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        printf("Failed to create a particle buffer for %zu particles \n", bufferCapacity);
+        return false;
+    }
+
+    uniformView = shader->GetViewLocation();
+    uniformProjection = shader->GetProjectionLocation();
+    uniformPointScale = shader->GetUniformLocation("pointScale");
+    uniformParticleSize = shader->GetUniformLocation("particleSize");
+
+    return true;
+}
+
+void ParticleSystem::setForces(GLfloat gravity, GLfloat drag, GLfloat groundHeight, GLfloat restitution)
+{
+    this->gravity = gravity;
+    this->drag = drag;
+    this->groundHeight = groundHeight;
+    this->restitution = restitution;
+}
+
+void ParticleSystem::update(GLfloat dt)
+{
+    if (blockCount == 0)
+        return;
+
+    PROFILE_SCOPE("ParticleSystem::update");
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    emitAccumulator += emitter.rate * dt;
+
+    size_t toEmit = (size_t)emitAccumulator;
+    emitAccumulator -= toEmit;
+    toEmit += spawnBacklog;
+    spawnBacklog = 0;
+
+    // shared out against the room before this update's deaths, so no block can overflow
+    for (size_t b = 0; b < blockCount && toEmit > 0; b++)
+    {
+        size_t room = BLOCK_SIZE - counts[b];
+        size_t take = room < toEmit ? room : toEmit;
+
+        emits[b] = (uint32_t)take;
+        toEmit -= take;
+    }
+
+    droppedCount += toEmit;
+
+    GLfloat damping = pow(1.0f - drag, dt);
+    size_t integrated = liveCount;
+
+    if (jobs != NULL && jobs->getThreadCount() > 1 && blockCount > 1)
+    {
+        jobs->parallelFor(blockCount, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; b++)
+                updateBlock(b, dt, damping);
+        });
+    }
+    else
+    {
+        for (size_t b = 0; b < blockCount; b++)
+            updateBlock(b, dt, damping);
+    }
+
+    liveCount = 0;
+
+    for (size_t b = 0; b < blockCount; b++)
+        liveCount += counts[b];
+
+    frame++;
+
+    lastUpdateTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    updateTotal += lastUpdateTime;
+    updatedTotal += integrated;
+    updateCount++;
+}
+
+void ParticleSystem::updateBlock(size_t block, GLfloat dt, GLfloat damping)
+{
+    if (counts[block] == 0 && emits[block] == 0)
+        return;
+
+    size_t first = block * BLOCK_SIZE;
+
+    ParticleStreams streams = { &positionX[first], &positionY[first], &positionZ[first],
+        &velocityX[first], &velocityY[first], &velocityZ[first], &life[first] };
+
+    IntegrateParameters parameters = { dt, gravity, damping, groundHeight, restitution };
+
+    counts[block] = (uint32_t)kernel(streams, 0, counts[block], 0, parameters);
+
+    emitBlock(block);
+}
+
+void ParticleSystem::emitBlock(size_t block)
+{
+    uint32_t count = emits[block];
+
+    if (count == 0)
+        return;
+
+    emits[block] = 0;
+
+    // seeded by the block & the frame, so a run repeats exactly whatever the thread count
+    uint32_t state = (uint32_t)(frame * 2654435761u) ^ (uint32_t)(block * 40503u + 1);
+    state = state != 0 ? state : 1;
+
+    size_t begin = block * BLOCK_SIZE + counts[block];
+    size_t end = begin + count;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        positionX[i] = emitter.position.x + emitter.radius * (2.0f * nextRandom(state) - 1.0f);
+        positionY[i] = emitter.position.y + emitter.radius * (2.0f * nextRandom(state) - 1.0f);
+        positionZ[i] = emitter.position.z + emitter.radius * (2.0f * nextRandom(state) - 1.0f);
+        velocityX[i] = emitter.velocity.x + emitter.spread * (2.0f * nextRandom(state) - 1.0f);
+        velocityY[i] = emitter.velocity.y + emitter.spread * (2.0f * nextRandom(state) - 1.0f);
+        velocityZ[i] = emitter.velocity.z + emitter.spread * (2.0f * nextRandom(state) - 1.0f);
+        life[i] = emitter.lifetime * (0.5f + 0.5f * nextRandom(state));
+    }
+
+    counts[block] += count;
+}
+
+void ParticleSystem::upload()
+{
+    if (vertexBuffer == 0)
+        return;
+
+    PROFILE_SCOPE("ParticleSystem::upload");
+
+    size_t total = 0;
+
+    for (size_t b = 0; b < blockCount; b++)
+    {
+        offsets[b] = total;
+        total += counts[b];
+    }
+
+    uploadedCount = 0;
+
+    if (total == 0)
+        return;
+
+    size_t bytes = total * FLOATS_PER_VERTEX * sizeof(GLfloat);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+    // invalidating lets the driver hand out fresh memory instead of syncing with the last frame's draws
+    GLfloat *vertices = (GLfloat*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (vertices == NULL)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    // the workers write straight into the mapping, each block at its own offset
+    if (jobs != NULL && jobs->getThreadCount() > 1 && blockCount > 1)
+    {
+        jobs->parallelFor(blockCount, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; b++)
+                writeVertices(b, vertices);
+        });
+    }
+    else
+    {
+        for (size_t b = 0; b < blockCount; b++)
+            writeVertices(b, vertices);
+    }
+
+    // the contents are lost if the mapping was, skip the frame then
+    bool intact = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (!intact)
+        return;
+
+    uploadedCount = total;
+    renderStats.add(COUNTER_UPLOAD_BYTES, bytes);
+}
+
+void ParticleSystem::writeVertices(size_t block, GLfloat *vertices)
+{
+    size_t first = block * BLOCK_SIZE;
+    size_t count = counts[block];
+    GLfloat inverseLifetime = 1.0f / emitter.lifetime;
+
+    // sequential stores only, the mapping may be write combined memory
+    GLfloat *out = vertices + offsets[block] * FLOATS_PER_VERTEX;
+
+    for (size_t i = first; i < first + count; i++)
+    {
+        out[0] = positionX[i];
+        out[1] = positionY[i];
+        out[2] = positionZ[i];
+        out[3] = life[i] * inverseLifetime;
+        out += FLOATS_PER_VERTEX;
+    }
+}
+
+void ParticleSystem::render(const glm::mat4 &view, const glm::mat4 &projection, GLsizei viewportHeight)
+{
+    if (uploadedCount == 0)
+        return;
+
+    PROFILE_GPU_SCOPE("particles");
+
+    shader->UseShader();
+    glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform1f(uniformPointScale, viewportHeight * projection[1][1] * 0.5f);
+    glUniform1f(uniformParticleSize, particleSize);
+
+    renderStats.add(COUNTER_UNIFORM_UPLOADS, 4);
+
+    // tested against the scene but not written, so overlapping sprites add up in any order
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    glDepthMask(GL_FALSE);
+
+    glBindVertexArray(vertexArray);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)uploadedCount);
+    glBindVertexArray(0);
+
+    renderStats.add(COUNTER_DRAW_CALLS, 1);
+    renderStats.add(COUNTER_VAO_BINDS, 1);
+    renderStats.add(COUNTER_INDICES, uploadedCount);
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    glUseProgram(0);
+}
+
+const char* ParticleSystem::getKernelName()
+{
+    return kernelName;
+}
+
+void ParticleSystem::printStatistics()
+{
+    if (blockCount == 0)
+        return;
+
+    printf("particles %zu live of %zu | %s kernel | %.0f updated per ms | dropped %zu \n", liveCount, getCapacity(), kernelName,
+        getUpdateRate(), droppedCount);
+}
+
+void ParticleSystem::Shutdown()
+{
+    if (vertexBuffer != 0)
+    {
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteVertexArrays(1, &vertexArray);
+
+        vertexBuffer = 0;
+        vertexArray = 0;
+    }
+
+    positionX.clear();
+    positionY.clear();
+    positionZ.clear();
+    velocityX.clear();
+    velocityY.clear();
+    velocityZ.clear();
+    life.clear();
+
+    blockCount = 0;
+    liveCount = 0;
+    uploadedCount = 0;
+}
+
+ParticleSystem::~ParticleSystem()
+{
+
+}
\ No newline at end of file
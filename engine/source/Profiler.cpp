@@ -0,0 +1,316 @@
+#include "../headers/Profiler.h"
+
+Profiler profiler;
+
+// the calling thread's ring buffer, created the first time it opens a scope
+static thread_local ProfileThread *threadState = NULL;
+
+struct ProfileStat
+{
+    const ProfileThread *thread;
+    const char *name;
+    uint64_t total, longest;
+    size_t calls;
+};
+
+Profiler::Profiler()
+{
+    startTime = Clock::now();
+
+    gpuThread = NULL;
+    gpuEnabled = false;
+    gpuFrameIndex = 0;
+    gpuFramesDropped = 0;
+
+    frameCount = 0;
+    scopeCost = 0.0;
+}
+
+void Profiler::Initialise(bool gpuTiming)
+{
+    gpuThread = registerThread("GPU");
+    gpuEnabled = gpuTiming && GLEW_ARB_timer_query;
+
+    if (gpuEnabled)
+    {
+        for (size_t f = 0; f < GPU_LATENCY; f++)
+        {
+            glGenQueries(MAX_GPU_SCOPES * 2, gpuFrames[f].queries);
+            gpuFrames[f].pending = false;
+        }
+
+        gpuFrameIndex = 0;
+        beginGpuFrame(gpuFrames[0]);
+    }
+
+    calibrate();
+}
+
+ProfileThread* Profiler::registerThread(const char *name)
+{
+    ProfileThread *thread = new ProfileThread();
+    thread->count.store(0, std::memory_order_relaxed);
+    thread->depth = 0;
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+
+    thread->id = threads.size() + 1;
+
+    if (name)
+        snprintf(thread->name, sizeof(thread->name), "%s", name);
+    else
+        snprintf(thread->name, sizeof(thread->name), "thread %u", thread->id);
+
+    threads.push_back(thread);
+
+    return thread;
+}
+
+ProfileThread* Profiler::currentThread()
+{
+    if (!threadState)
+        threadState = registerThread(NULL);
+
+    return threadState;
+}
+
+void Profiler::setThreadName(const char *name)
+{
+    snprintf(currentThread()->name, sizeof(threadState->name), "%s", name);
+}
+
+void Profiler::calibrate()
+{
+    // time a batch of empty scopes, then forget them
+    ProfileThread *thread = currentThread();
+    uint64_t savedCount = thread->count.load(std::memory_order_relaxed);
+
+    const int samples = 10000;
+    uint64_t start = now();
+
+    for (int i = 0; i < samples; i++)
+        ProfileScope scope("calibrate");
+
+    scopeCost = (double)(now() - start) / samples;
+
+    thread->count.store(savedCount, std::memory_order_relaxed);
+}
+
+int Profiler::beginGpu(const char *name)
+{
+    if (!gpuEnabled)
+        return -1;
+
+    GpuFrame &frame = gpuFrames[gpuFrameIndex];
+
+    if (frame.scopeCount >= MAX_GPU_SCOPES)
+        return -1;
+
+    size_t scope = frame.scopeCount++;
+    frame.names[scope] = name;
+    frame.depths[scope] = frame.openScopes++;
+
+    // timestamps rather than GL_TIME_ELAPSED, which cannot be nested
+    glQueryCounter(frame.queries[scope * 2], GL_TIMESTAMP);
+
+    return scope;
+}
+
+void Profiler::endGpu(int scope)
+{
+    if (scope < 0)
+        return;
+
+    GpuFrame &frame = gpuFrames[gpuFrameIndex];
+
+    glQueryCounter(frame.queries[scope * 2 + 1], GL_TIMESTAMP);
+    frame.openScopes--;
+}
+
+void Profiler::beginGpuFrame(GpuFrame &frame)
+{
+    frame.scopeCount = 0;
+    frame.openScopes = 0;
+    frame.pending = false;
+
+    frame.cpuTime = now();
+    glGetInteger64v(GL_TIMESTAMP, &frame.gpuTime);
+}
+
+void Profiler::readGpuFrame(GpuFrame &frame)
+{
+    // queries finish in order, so the last one being ready means they all are
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.scopeCount * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (!available)
+    {
+        gpuFramesDropped++;
+        return;
+    }
+
+    for (size_t scope = 0; scope < frame.scopeCount; scope++)
+    {
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(frame.queries[scope * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(frame.queries[scope * 2 + 1], GL_QUERY_RESULT, &end);
+
+        uint64_t index = gpuThread->count.load(std::memory_order_relaxed);
+
+        ProfileEvent &event = gpuThread->events[index & (ProfileThread::CAPACITY - 1)];
+        event.name = frame.names[scope];
+        event.start = frame.cpuTime + (int64_t)(begin - frame.gpuTime);
+        event.end = frame.cpuTime + (int64_t)(end - frame.gpuTime);
+        event.depth = frame.depths[scope];
+
+        gpuThread->count.store(index + 1, std::memory_order_release);
+    }
+}
+
+void Profiler::endFrame()
+{
+    frameEnds[frameCount % MAX_FRAMES] = now();
+    frameCount++;
+
+    if (!gpuEnabled)
+        return;
+
+    gpuFrames[gpuFrameIndex].pending = gpuFrames[gpuFrameIndex].scopeCount > 0;
+
+    // the slot about to be reused was issued GPU_LATENCY frames ago
+    gpuFrameIndex = (gpuFrameIndex + 1) % GPU_LATENCY;
+    GpuFrame &frame = gpuFrames[gpuFrameIndex];
+
+    if (frame.pending)
+        readGpuFrame(frame);
+
+    beginGpuFrame(frame);
+}
+
+void Profiler::printSummary()
+{
+    if (frameCount < 2)
+        return;
+
+    // the summary covers the frames whose boundaries are still known
+    uint64_t frames = std::min<uint64_t>(frameCount, MAX_FRAMES) - 1;
+    uint64_t windowStart = frameEnds[(frameCount - frames - 1) % MAX_FRAMES];
+    uint64_t windowEnd = frameEnds[(frameCount - 1) % MAX_FRAMES];
+    double frameTime = (double)(windowEnd - windowStart) / frames;
+
+    std::vector<ProfileStat> stats;
+    size_t cpuScopes = 0;
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        const ProfileThread *thread = threads[t];
+        uint64_t count = thread->count.load(std::memory_order_acquire);
+        uint64_t first = count > ProfileThread::CAPACITY ? count - ProfileThread::CAPACITY : 0;
+
+        for (uint64_t i = first; i < count; i++)
+        {
+            const ProfileEvent &event = thread->events[i & (ProfileThread::CAPACITY - 1)];
+
+            if (event.start < windowStart || event.end > windowEnd)
+                continue;
+
+            if (thread != gpuThread)
+                cpuScopes++;
+
+            size_t s = 0;
+
+            while (s < stats.size() && (stats[s].thread != thread || strcmp(stats[s].name, event.name) != 0))
+                s++;
+
+            if (s == stats.size())
+            {
+                ProfileStat stat = { thread, event.name, 0, 0, 0 };
+                stats.push_back(stat);
+            }
+
+            uint64_t duration = event.end - event.start;
+            stats[s].total += duration;
+            stats[s].longest = std::max(stats[s].longest, duration);
+            stats[s].calls++;
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const ProfileStat &a, const ProfileStat &b) {
+        return a.thread->id != b.thread->id ? a.thread->id < b.thread->id : a.total > b.total;
+    });
+
+    printf("profile of the last %llu frames | mean frame %.3f ms \n", (unsigned long long)frames, frameTime / 1e6);
+
+    for (size_t s = 0; s < stats.size(); s++)
+    {
+        printf("  %-10s %-20s %8.2f calls/frame | %8.3f ms/frame | max %.3f ms \n",
+            stats[s].thread->name, stats[s].name, (double)stats[s].calls / frames,
+            stats[s].total / 1e6 / frames, stats[s].longest / 1e6);
+    }
+
+    // what recording the scopes themselves cost, against the frame it measured
+    double overhead = cpuScopes * scopeCost / frames;
+    printf("profiler overhead %.1f scopes/frame at %.0f ns = %.3f%% of the frame | gpu frames dropped %zu \n",
+        (double)cpuScopes / frames, scopeCost, 100.0 * overhead / frameTime, gpuFramesDropped);
+}
+
+bool Profiler::writeChromeTrace(const char *fileLocation)
+{
+    FILE *file = fopen(fileLocation, "w");
+
+    if (!file)
+    {
+        printf("Failed to open %s for the trace! \n", fileLocation);
+        return false;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    bool first = true;
+
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        const ProfileThread *thread = threads[t];
+
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", thread->id, thread->name);
+        first = false;
+
+        uint64_t count = thread->count.load(std::memory_order_acquire);
+        uint64_t oldest = count > ProfileThread::CAPACITY ? count - ProfileThread::CAPACITY : 0;
+
+        // complete events, timestamps in microseconds
+        for (uint64_t i = oldest; i < count; i++)
+        {
+            const ProfileEvent &event = thread->events[i & (ProfileThread::CAPACITY - 1)];
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                event.name, thread == gpuThread ? "gpu" : "cpu", event.start / 1e3, (event.end - event.start) / 1e3, thread->id);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    return true;
+}
+
+void Profiler::Shutdown()
+{
+    if (!gpuEnabled)
+        return;
+
+    for (size_t f = 0; f < GPU_LATENCY; f++)
+        glDeleteQueries(MAX_GPU_SCOPES * 2, gpuFrames[f].queries);
+
+    gpuEnabled = false;
+}
+
+Profiler::~Profiler()
+{
+    for (size_t t = 0; t < threads.size(); t++)
+        delete threads[t];
+}
\ No newline at end of file
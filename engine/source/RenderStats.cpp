@@ -0,0 +1,152 @@
+#include "../headers/RenderStats.h"
+
+RenderStats renderStats;
+
+static const char* counterNames[COUNTER_COUNT] = {
+    "draws",
+    "indices",
+    "program binds",
+    "vao binds",
+    "uniforms",
+    "upload bytes",
+    "programs compiled"
+};
+
+RenderStats::RenderStats()
+{
+    for (size_t s = 0; s < MAX_THREADS; s++)
+    {
+        for (int c = 0; c < COUNTER_COUNT; c++)
+            slots[s].values[c].store(0, std::memory_order_relaxed);
+
+        slots[s].shared = s == MAX_THREADS - 1;
+    }
+
+    slotCount.store(0, std::memory_order_relaxed);
+
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        previousTotals[c] = 0;
+
+        for (size_t f = 0; f < WINDOW; f++)
+            history[c][f].store(0, std::memory_order_relaxed);
+    }
+
+    frameCount.store(0, std::memory_order_relaxed);
+}
+
+RenderStats::CounterSlot* RenderStats::claimSlot()
+{
+    size_t index = slotCount.fetch_add(1, std::memory_order_relaxed);
+    return &slots[index < MAX_THREADS ? index : MAX_THREADS - 1];
+}
+
+void RenderStats::endFrame()
+{
+    uint64_t frame = frameCount.load(std::memory_order_relaxed);
+    size_t used = slotCount.load(std::memory_order_relaxed);
+    used = used < MAX_THREADS ? used : MAX_THREADS;
+
+    // totals only grow, so a frame is the difference since the last call; adds that
+    // race with this simply land in the next frame
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        uint64_t total = 0;
+
+        for (size_t s = 0; s < used; s++)
+            total += slots[s].values[c].load(std::memory_order_relaxed);
+
+        history[c][frame & (WINDOW - 1)].store(total - previousTotals[c], std::memory_order_relaxed);
+        previousTotals[c] = total;
+    }
+
+    frameCount.store(frame + 1, std::memory_order_release);
+}
+
+size_t RenderStats::windowSize()
+{
+    uint64_t frames = getFrameCount();
+    return frames < WINDOW ? frames : WINDOW;
+}
+
+uint64_t RenderStats::getLast(RenderCounter counter)
+{
+    uint64_t frames = getFrameCount();
+    return frames > 0 ? history[counter][(frames - 1) & (WINDOW - 1)].load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t RenderStats::getMin(RenderCounter counter)
+{
+    size_t size = windowSize();
+    uint64_t minimum = size > 0 ? UINT64_MAX : 0;
+
+    for (size_t f = 0; f < size; f++)
+    {
+        uint64_t value = history[counter][f].load(std::memory_order_relaxed);
+        minimum = value < minimum ? value : minimum;
+    }
+
+    return minimum;
+}
+
+uint64_t RenderStats::getMax(RenderCounter counter)
+{
+    size_t size = windowSize();
+    uint64_t maximum = 0;
+
+    for (size_t f = 0; f < size; f++)
+    {
+        uint64_t value = history[counter][f].load(std::memory_order_relaxed);
+        maximum = value > maximum ? value : maximum;
+    }
+
+    return maximum;
+}
+
+double RenderStats::getAverage(RenderCounter counter)
+{
+    size_t size = windowSize();
+
+    if (size == 0)
+        return 0.0;
+
+    uint64_t total = 0;
+
+    for (size_t f = 0; f < size; f++)
+        total += history[counter][f].load(std::memory_order_relaxed);
+
+    return (double)total / size;
+}
+
+const char* RenderStats::getName(RenderCounter counter)
+{
+    return counterNames[counter];
+}
+
+void RenderStats::formatSummary(char *buffer, size_t size)
+{
+    snprintf(buffer, size, "draws %.0f | triangles %.0f | programs %.0f | vaos %.0f | uniforms %.0f | uploaded %.1f KB",
+        getAverage(COUNTER_DRAW_CALLS), getAverage(COUNTER_INDICES) / 3.0, getAverage(COUNTER_PROGRAM_BINDS),
+        getAverage(COUNTER_VAO_BINDS), getAverage(COUNTER_UNIFORM_UPLOADS), getAverage(COUNTER_UPLOAD_BYTES) / 1024.0);
+}
+
+void RenderStats::printStatistics()
+{
+    if (getFrameCount() == 0)
+        return;
+
+    printf("render stats over the last %zu frames \n", windowSize());
+
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        RenderCounter counter = (RenderCounter)c;
+
+        printf("  %-18s min %10llu | avg %12.1f | max %10llu \n", getName(counter),
+            (unsigned long long)getMin(counter), getAverage(counter), (unsigned long long)getMax(counter));
+    }
+}
+
+RenderStats::~RenderStats()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "../headers/RenderThread.h"
+
+RenderThread::RenderThread()
+{
+    window = NULL;
+
+    writeSlot = 0;
+    readySlot = 1;
+    readSlot = 2;
+    readyIsNew = false;
+    stopping = false;
+
+    startTime = 0.0;
+    mainWaitTime = 0.0;
+    renderBusyTime = 0.0;
+    latencyTotal = 0.0;
+    latencyMax = 0.0;
+    renderedFrames = 0;
+}
+
+void RenderThread::start(Window *window, std::function<void()> setup, std::function<void(const FrameSnapshot&)> renderFrame)
+{
+    this->window = window;
+    this->setup = setup;
+    this->renderFrame = renderFrame;
+
+    stopping = false;
+    startTime = window->getTime();
+
+    // a context can only be current on one thread at a time
+    window->makeContextCurrent(false);
+
+    thread = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::publish()
+{
+    PROFILE_SCOPE("publish");
+
+    double waitStart = window->getTime();
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // stay at most one frame ahead of the renderer instead of dropping snapshots
+    snapshotTaken.wait(lock, [this] { return !readyIsNew || stopping; });
+
+    std::swap(writeSlot, readySlot);
+    readyIsNew = true;
+
+    lock.unlock();
+    snapshotReady.notify_one();
+
+    mainWaitTime += window->getTime() - waitStart;
+}
+
+void RenderThread::run()
+{
+    window->makeContextCurrent(true);
+
+    setup();
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            snapshotReady.wait(lock, [this] { return readyIsNew || stopping; });
+
+            if (stopping && !readyIsNew)
+                break;
+
+            std::swap(readySlot, readSlot);
+            readyIsNew = false;
+        }
+
+        snapshotTaken.notify_one();
+
+        double frameStart = window->getTime();
+
+        const FrameSnapshot &snapshot = slots[readSlot];
+        renderFrame(snapshot);
+
+        double frameEnd = window->getTime();
+        double latency = frameEnd - snapshot.inputTime;
+
+        renderBusyTime += frameEnd - frameStart;
+        latencyTotal += latency;
+        latencyMax = latency > latencyMax ? latency : latencyMax;
+        renderedFrames++;
+    }
+
+    // wait for outstanding work before handing the context back
+    glFinish();
+    window->makeContextCurrent(false);
+}
+
+void RenderThread::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    snapshotReady.notify_one();
+    snapshotTaken.notify_one();
+
+    thread.join();
+
+    window->makeContextCurrent(true);
+}
+
+void RenderThread::printStatistics()
+{
+    if (renderedFrames == 0)
+        return;
+
+    double wall = window->getTime() - startTime;
+
+    printf("render thread | main busy %.1f%% | render busy %.1f%% | input to swap latency mean %.3f ms | max %.3f ms \n",
+        100.0 * (wall - mainWaitTime) / wall, 100.0 * renderBusyTime / wall,
+        1000.0 * latencyTotal / renderedFrames, 1000.0 * latencyMax);
+}
+
+RenderThread::~RenderThread()
+{
+    stop();
+}
\ No newline at end of file
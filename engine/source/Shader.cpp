@@ -74,6 +74,8 @@ void Shader::CompileShader(const char *vertexCode, const char *fragmentCode)
         return;
     }
 
+    renderStats.add(COUNTER_PROGRAMS_COMPILED, 1);
+
     glValidateProgram(shaderId); // validating the shader program
     glGetProgramiv(shaderId, GL_VALIDATE_STATUS, &result); // getting the result of the validation
     
@@ -105,8 +107,17 @@ GLuint Shader::GetViewLocation()
     return uniformView;
 }
 
+GLuint Shader::GetUniformLocation(const char *name)
+{
+    return glGetUniformLocation(shaderId, name);
+}
+
 void Shader::UseShader()
 {
+    PROFILE_GPU_SCOPE("UseShader");
+
+    renderStats.add(COUNTER_PROGRAM_BINDS, 1);
+
     glUseProgram(shaderId);
 }
 
@@ -0,0 +1,550 @@
+#include "../headers/Terrain.h"
+
+Terrain::Terrain()
+{
+    size = 0;
+    tilesAcross = 0;
+    levelCount = 0;
+    spacing = 1.0f;
+    heightScale = 1.0f;
+    baseHeight = 0.0f;
+    halfExtent = 0.0f;
+
+    pendingTiles.store(0, std::memory_order_relaxed);
+    nextTile = 0;
+
+    for (int i = 0; i < MAX_LEVELS; i++)
+    {
+        ranges[i] = 0.0f;
+        morphRanges[i * 2] = 0.0f;
+        morphRanges[i * 2 + 1] = 0.0f;
+    }
+
+    cameraPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+
+    shader = NULL;
+    heightmap = 0;
+    uploadBudget = 0;
+
+    uniformNodes = 0;
+    uniformPatchQuads = 0;
+    uniformCameraPosition = 0;
+    uniformView = 0;
+    uniformProjection = 0;
+
+    lastSelectionTime = 0.0;
+    selectionTotal = 0.0;
+    selectionCount = 0;
+    vertexTotal = 0;
+    tilesUploaded = 0;
+}
+
+bool Terrain::createHeightmap(int size, GLfloat spacing, GLfloat heightScale, GLfloat baseHeight, GLfloat lodDistance, const uint16_t *initialHeights)
+{
+    if (size < TILE_SIZE || (size & (size - 1)) != 0)
+    {
+        printf("Terrain size %d is not a power of two of at least %d samples \n", size, TILE_SIZE);
+        return false;
+    }
+
+    // one level 0 node per PATCH_RESOLUTION samples, each level above halves the nodes across
+    int levels = 1;
+
+    while ((PATCH_RESOLUTION << (levels - 1)) < size)
+        levels++;
+
+    if (levels > MAX_LEVELS)
+    {
+        printf("Terrain size %d needs %d LOD levels, at most %d are supported \n", size, levels, MAX_LEVELS);
+        return false;
+    }
+
+    this->size = size;
+    this->spacing = spacing;
+    this->heightScale = heightScale;
+    this->baseHeight = baseHeight;
+    halfExtent = size * spacing * 0.5f;
+    tilesAcross = size / TILE_SIZE;
+    levelCount = levels;
+
+    if (initialHeights != NULL)
+        heights.assign(initialHeights, initialHeights + (size_t)size * size);
+    else
+        heights.assign((size_t)size * size, 0);
+
+    dirtyTiles.assign(tilesAcross * tilesAcross, 0);
+    pendingTiles.store(0, std::memory_order_relaxed);
+    nextTile = 0;
+
+    for (int level = 0; level < MAX_LEVELS; level++)
+    {
+        int across = level < levelCount ? size / (PATCH_RESOLUTION << level) : 0;
+
+        minimums[level].assign(across * across, 0);
+        maximums[level].assign(across * across, 0);
+    }
+
+    int leavesAcross = size / PATCH_RESOLUTION;
+    refreshBounds(0, leavesAcross - 1, 0, leavesAcross - 1);
+
+    // a node within range of the level below is at most a node's diagonal closer than its neighbours, so with ranges
+    // of at least three node widths neighbours never end up more than one level apart, which the blending needs
+    lodDistance = std::max(lodDistance, 3.0f * PATCH_RESOLUTION * spacing);
+
+    // a level blends into the grid above over the last third of its range, done before the next level takes over;
+    // nothing takes over from the top level, so it never blends
+    for (int level = 0; level < levelCount; level++)
+    {
+        ranges[level] = lodDistance * (GLfloat)(1 << level);
+
+        GLfloat previous = level > 0 ? ranges[level - 1] : 0.0f;
+        bool top = level == levelCount - 1;
+
+        morphRanges[level * 2] = top ? 1e30f : previous + (ranges[level] - previous) * 0.66f;
+        morphRanges[level * 2 + 1] = top ? 2e30f : ranges[level];
+    }
+
+    // every level 0 node may be drawn at once, so selection never grows the lists mid-run
+    selected[0].clear();
+    selected[1].clear();
+    selected[0].reserve(leavesAcross * leavesAcross);
+    selected[1].reserve(leavesAcross * leavesAcross);
+
+    return true;
+}
+
+bool Terrain::Initialise(Shader *shader, size_t uploadBudgetPerFrame)
+{
+    if (heights.empty())
+    {
+        printf("Terrain needs a heightmap before Initialise \n");
+        return false;
+    }
+
+    this->shader = shader;
+    uploadBudget = uploadBudgetPerFrame;
+
+    buildPatch(patches[0], PATCH_RESOLUTION);
+    buildPatch(patches[1], PATCH_RESOLUTION / 2);
+
+    // tiles written before now go up with the rest
+    if (pendingTiles.load(std::memory_order_relaxed) > 0)
+    {
+        int leavesAcross = size / PATCH_RESOLUTION;
+        refreshBounds(0, leavesAcross - 1, 0, leavesAcross - 1);
+
+        std::fill(dirtyTiles.begin(), dirtyTiles.end(), 0);
+        pendingTiles.store(0, std::memory_order_relaxed);
+    }
+
+    // rows of 16 bit heights are only 2 byte aligned
+    glGenTextures(1, &heightmap);
+    glBindTexture(GL_TEXTURE_2D, heightmap);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, size, size, 0, GL_RED, GL_UNSIGNED_SHORT, heights.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // linear between samples, vertices past the last sample take its height
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        printf("Failed to create the %dx%d terrain heightmap \n", size, size);
+        glDeleteTextures(1, &heightmap);
+        heightmap = 0;
+        return false;
+    }
+
+    renderStats.add(COUNTER_UPLOAD_BYTES, heights.size() * sizeof(uint16_t));
+
+    // everything but the nodes, the patch & the camera stays put, so it is set once
+    shader->UseShader();
+    glUniform1i(shader->GetUniformLocation("heightmap"), HEIGHTMAP_UNIT);
+    glUniform4f(shader->GetUniformLocation("terrainMap"), -halfExtent, -halfExtent, 1.0f / (spacing * size), 0.5f / size);
+    glUniform2f(shader->GetUniformLocation("heightRange"), heightScale, baseHeight);
+    glUniform2fv(shader->GetUniformLocation("morphRanges"), levelCount, morphRanges);
+
+    uniformNodes = shader->GetUniformLocation("nodes");
+    uniformPatchQuads = shader->GetUniformLocation("patchQuads");
+    uniformCameraPosition = shader->GetUniformLocation("cameraPosition");
+    uniformView = shader->GetViewLocation();
+    uniformProjection = shader->GetProjectionLocation();
+    glUseProgram(0);
+
+    return true;
+}
+
+void Terrain::buildPatch(Mesh &patch, int quads)
+{
+    // a unit grid on XZ, terrain.vert scales it over a node & displaces it
+    const int side = quads + 1;
+
+    std::vector<GLfloat> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve(side * side * 3);
+    indices.reserve(quads * quads * 6);
+
+    for (int z = 0; z < side; z++)
+    {
+        for (int x = 0; x < side; x++)
+        {
+            vertices.push_back((GLfloat)x / quads);
+            vertices.push_back(0.0f);
+            vertices.push_back((GLfloat)z / quads);
+        }
+    }
+
+    for (int z = 0; z < quads; z++)
+    {
+        for (int x = 0; x < quads; x++)
+        {
+            unsigned int corner = z * side + x;
+            unsigned int quad[6] = { corner, corner + side, corner + 1, corner + 1, corner + side, corner + side + 1 };
+
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    patch.CreateMesh(vertices.data(), indices.data(), vertices.size(), indices.size());
+}
+
+void Terrain::updateTile(int tileX, int tileZ, const uint16_t *tileHeights)
+{
+    if (tileX < 0 || tileZ < 0 || tileX >= tilesAcross || tileZ >= tilesAcross)
+        return;
+
+    uint16_t *destination = &heights[(size_t)tileZ * TILE_SIZE * size + (size_t)tileX * TILE_SIZE];
+
+    for (int row = 0; row < TILE_SIZE; row++)
+        memcpy(destination + (size_t)row * size, tileHeights + (size_t)row * TILE_SIZE, TILE_SIZE * sizeof(uint16_t));
+
+    // only this thread writes this tile's flag
+    uint8_t &dirty = dirtyTiles[tileZ * tilesAcross + tileX];
+
+    if (!dirty)
+    {
+        dirty = 1;
+        pendingTiles.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Terrain::update()
+{
+    if (heightmap == 0 || pendingTiles.load(std::memory_order_relaxed) == 0)
+        return;
+
+    PROFILE_SCOPE("Terrain::update");
+
+    const size_t tileBytes = (size_t)TILE_SIZE * TILE_SIZE * sizeof(uint16_t);
+    const int tileCount = tilesAcross * tilesAcross;
+    const int leavesPerTile = TILE_SIZE / PATCH_RESOLUTION;
+    const int leavesAcross = size / PATCH_RESOLUTION;
+
+    // at least one tile a frame, however small the budget
+    size_t budget = uploadBudget > tileBytes ? uploadBudget : tileBytes;
+    size_t sent = 0;
+
+    glBindTexture(GL_TEXTURE_2D, heightmap);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, size);
+
+    for (int checked = 0; checked < tileCount && sent + tileBytes <= budget; checked++)
+    {
+        int tile = nextTile;
+        nextTile = (nextTile + 1) % tileCount;
+
+        if (!dirtyTiles[tile])
+            continue;
+
+        dirtyTiles[tile] = 0;
+        pendingTiles.fetch_sub(1, std::memory_order_relaxed);
+
+        int tileX = tile % tilesAcross;
+        int tileZ = tile / tilesAcross;
+
+        // straight out of the CPU copy, the row length skips the rest of the map
+        glTexSubImage2D(GL_TEXTURE_2D, 0, tileX * TILE_SIZE, tileZ * TILE_SIZE, TILE_SIZE, TILE_SIZE, GL_RED, GL_UNSIGNED_SHORT,
+            &heights[(size_t)tileZ * TILE_SIZE * size + (size_t)tileX * TILE_SIZE]);
+
+        sent += tileBytes;
+        tilesUploaded++;
+
+        // the nodes before the tile share their last row or column with it
+        int firstColumn = std::max(tileX * leavesPerTile - 1, 0);
+        int firstRow = std::max(tileZ * leavesPerTile - 1, 0);
+        int lastColumn = std::min(tileX * leavesPerTile + leavesPerTile - 1, leavesAcross - 1);
+        int lastRow = std::min(tileZ * leavesPerTile + leavesPerTile - 1, leavesAcross - 1);
+
+        refreshBounds(firstColumn, lastColumn, firstRow, lastRow);
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    renderStats.add(COUNTER_UPLOAD_BYTES, sent);
+}
+
+void Terrain::refreshBounds(int firstColumn, int lastColumn, int firstRow, int lastRow)
+{
+    // level 0 from the samples, each one's patch reaching the first sample of the next
+    int leavesAcross = size / PATCH_RESOLUTION;
+
+    for (int z = firstRow; z <= lastRow; z++)
+    {
+        for (int x = firstColumn; x <= lastColumn; x++)
+        {
+            int rowEnd = std::min((z + 1) * PATCH_RESOLUTION, size - 1);
+            int columnEnd = std::min((x + 1) * PATCH_RESOLUTION, size - 1);
+
+            uint16_t low = UINT16_MAX, high = 0;
+
+            for (int row = z * PATCH_RESOLUTION; row <= rowEnd; row++)
+            {
+                const uint16_t *sample = &heights[(size_t)row * size];
+
+                for (int column = x * PATCH_RESOLUTION; column <= columnEnd; column++)
+                {
+                    low = std::min(low, sample[column]);
+                    high = std::max(high, sample[column]);
+                }
+            }
+
+            minimums[0][z * leavesAcross + x] = low;
+            maximums[0][z * leavesAcross + x] = high;
+        }
+    }
+
+    // then each level above from its four children
+    for (int level = 1; level < levelCount; level++)
+    {
+        int across = leavesAcross >> level;
+        int childAcross = across * 2;
+
+        firstColumn >>= 1;
+        lastColumn >>= 1;
+        firstRow >>= 1;
+        lastRow >>= 1;
+
+        for (int z = firstRow; z <= lastRow; z++)
+        {
+            for (int x = firstColumn; x <= lastColumn; x++)
+            {
+                size_t child = (size_t)z * 2 * childAcross + x * 2;
+                const uint16_t *childMinimums = minimums[level - 1].data();
+                const uint16_t *childMaximums = maximums[level - 1].data();
+
+                minimums[level][z * across + x] = std::min(std::min(childMinimums[child], childMinimums[child + 1]),
+                    std::min(childMinimums[child + childAcross], childMinimums[child + childAcross + 1]));
+                maximums[level][z * across + x] = std::max(std::max(childMaximums[child], childMaximums[child + 1]),
+                    std::max(childMaximums[child + childAcross], childMaximums[child + childAcross + 1]));
+            }
+        }
+    }
+}
+
+void Terrain::nodeBounds(int level, int x, int z, glm::vec3 &minimum, glm::vec3 &maximum)
+{
+    int across = size / (PATCH_RESOLUTION << level);
+    GLfloat nodeSize = (GLfloat)(PATCH_RESOLUTION << level) * spacing;
+    GLfloat scale = heightScale / 65535.0f;
+
+    minimum = glm::vec3(x * nodeSize - halfExtent, baseHeight + minimums[level][z * across + x] * scale, z * nodeSize - halfExtent);
+    maximum = glm::vec3(minimum.x + nodeSize, baseHeight + maximums[level][z * across + x] * scale, minimum.z + nodeSize);
+}
+
+bool Terrain::visible(const glm::vec3 &minimum, const glm::vec3 &maximum)
+{
+    // outside when even the corner furthest along a plane's normal is behind it
+    for (int p = 0; p < 6; p++)
+    {
+        const glm::vec4 &plane = planes[p];
+
+        GLfloat x = plane.x >= 0.0f ? maximum.x : minimum.x;
+        GLfloat y = plane.y >= 0.0f ? maximum.y : minimum.y;
+        GLfloat z = plane.z >= 0.0f ? maximum.z : minimum.z;
+
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+            return false;
+    }
+
+    return true;
+}
+
+bool Terrain::withinRange(const glm::vec3 &minimum, const glm::vec3 &maximum, GLfloat range)
+{
+    // distance from the camera to the closest point of the box
+    glm::vec3 closest(std::min(std::max(cameraPosition.x, minimum.x), maximum.x),
+        std::min(std::max(cameraPosition.y, minimum.y), maximum.y),
+        std::min(std::max(cameraPosition.z, minimum.z), maximum.z));
+
+    glm::vec3 offset = closest - cameraPosition;
+
+    return glm::dot(offset, offset) <= range * range;
+}
+
+void Terrain::select(const glm::mat4 &view, const glm::mat4 &projection)
+{
+    PROFILE_SCOPE("Terrain::select");
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // planes straight from the rows of the view-projection matrix (Gribb & Hartmann)
+    glm::mat4 m = projection * view;
+
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    planes[4] = row3 + row2;
+    planes[5] = row3 - row2;
+
+    for (int p = 0; p < 6; p++)
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+
+    // the camera sits at the inverse view's translation
+    cameraPosition = glm::vec3(glm::inverse(view)[3]);
+
+    selected[0].clear();
+    selected[1].clear();
+
+    if (!heights.empty())
+        selectNode(levelCount - 1, 0, 0);
+
+    lastSelectionTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    selectionTotal += lastSelectionTime;
+    selectionCount++;
+    vertexTotal += getVertexCount();
+}
+
+void Terrain::selectNode(int level, int x, int z)
+{
+    glm::vec3 minimum, maximum;
+    nodeBounds(level, x, z, minimum, maximum);
+
+    if (!visible(minimum, maximum))
+        return;
+
+    GLfloat nodeSize = maximum.x - minimum.x;
+
+    // nothing of the node is close enough for the level below
+    if (level == 0 || !withinRange(minimum, maximum, ranges[level - 1]))
+    {
+        selected[0].push_back(glm::vec4(minimum.x, minimum.z, nodeSize, (GLfloat)level));
+        return;
+    }
+
+    // children reaching into the range below are refined, the rest stay at this level's density as quarters
+    for (int child = 0; child < 4; child++)
+    {
+        int childX = x * 2 + (child & 1);
+        int childZ = z * 2 + (child >> 1);
+
+        glm::vec3 childMinimum, childMaximum;
+        nodeBounds(level - 1, childX, childZ, childMinimum, childMaximum);
+
+        if (withinRange(childMinimum, childMaximum, ranges[level - 1]))
+            selectNode(level - 1, childX, childZ);
+        else if (visible(childMinimum, childMaximum))
+            selected[1].push_back(glm::vec4(childMinimum.x, childMinimum.z, nodeSize * 0.5f, (GLfloat)level));
+    }
+}
+
+size_t Terrain::getVertexCount()
+{
+    const size_t wholeSide = PATCH_RESOLUTION + 1;
+    const size_t quarterSide = PATCH_RESOLUTION / 2 + 1;
+
+    return selected[0].size() * wholeSide * wholeSide + selected[1].size() * quarterSide * quarterSide;
+}
+
+void Terrain::render(const glm::mat4 &view, const glm::mat4 &projection)
+{
+    if (heightmap == 0)
+        return;
+
+    select(view, projection);
+
+    if (getSelectedCount() == 0)
+        return;
+
+    PROFILE_GPU_SCOPE("terrain");
+
+    shader->UseShader();
+    glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform3f(uniformCameraPosition, cameraPosition.x, cameraPosition.y, cameraPosition.z);
+
+    glActiveTexture(GL_TEXTURE0 + HEIGHTMAP_UNIT);
+    glBindTexture(GL_TEXTURE_2D, heightmap);
+
+    size_t uniformUploads = 3;
+
+    // one instance per node, in batches the size of the shader's array
+    for (int p = 0; p < 2; p++)
+    {
+        const std::vector<glm::vec4> &nodes = selected[p];
+
+        if (nodes.empty())
+            continue;
+
+        glUniform1f(uniformPatchQuads, p == 0 ? PATCH_RESOLUTION : PATCH_RESOLUTION / 2);
+        uniformUploads++;
+
+        for (size_t first = 0; first < nodes.size(); first += MAX_NODES_PER_DRAW)
+        {
+            size_t remaining = nodes.size() - first;
+            GLsizei count = remaining < (size_t)MAX_NODES_PER_DRAW ? (GLsizei)remaining : MAX_NODES_PER_DRAW;
+
+            glUniform4fv(uniformNodes, count, glm::value_ptr(nodes[first]));
+            patches[p].RenderMeshInstanced(count);
+            uniformUploads++;
+        }
+    }
+
+    renderStats.add(COUNTER_UNIFORM_UPLOADS, uniformUploads);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glUseProgram(0);
+}
+
+void Terrain::printStatistics()
+{
+    if (heights.empty())
+        return;
+
+    printf("terrain %dx%d samples | %d levels | nodes %zu | vertices %.0f per view | selection mean %.3f ms | tiles uploaded %zu, pending %zu \n",
+        size, size, levelCount, getSelectedCount(), getMeanVertexCount(), 1000.0 * getMeanSelectionTime(), tilesUploaded,
+        getPendingTiles());
+}
+
+void Terrain::Shutdown()
+{
+    if (heightmap != 0)
+    {
+        glDeleteTextures(1, &heightmap);
+        heightmap = 0;
+
+        patches[0].ClearMesh();
+        patches[1].ClearMesh();
+    }
+
+    heights.clear();
+    heights.shrink_to_fit();
+}
+
+Terrain::~Terrain()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,694 @@
+#include "../headers/TextureManager.h"
+
+TextureManager::TextureManager()
+{
+    jobs = NULL;
+
+    textureCount.store(0, std::memory_order_relaxed);
+
+    placeholder = 0;
+
+    for (int i = 0; i < STAGING_BUFFERS; i++)
+    {
+        stagingBuffers[i] = 0;
+        stagingFences[i] = 0;
+    }
+
+    stagingIndex = 0;
+
+    budget = 0;
+    uploadBudget = 0;
+    residentBytes = 0;
+    frame = 0;
+
+    for (size_t i = 0; i < BANDWIDTH_WINDOW; i++)
+        windowBytes[i] = 0;
+
+    windowIndex = 0;
+    windowCount = 0;
+    totalUploadBytes = 0;
+
+    firstMipTotal = 0.0;
+    firstMipMax = 0.0;
+    firstMipCount = 0;
+
+    evictionCount = 0;
+}
+
+bool TextureManager::Initialise(JobSystem *jobSystem, size_t residencyBudget, size_t uploadBudgetPerFrame)
+{
+    jobs = jobSystem;
+    budget = residencyBudget;
+    uploadBudget = uploadBudgetPerFrame > 0 ? uploadBudgetPerFrame : STAGING_SIZE;
+
+    // sampled until a texture's first level is resident
+    const uint8_t white[4] = { 255, 255, 255, 255 };
+
+    glGenTextures(1, &placeholder);
+    glBindTexture(GL_TEXTURE_2D, placeholder);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // a ring of staging buffers, so writing the next band never waits on the copy of the last one
+    glGenBuffers(STAGING_BUFFERS, stagingBuffers);
+
+    for (int i = 0; i < STAGING_BUFFERS; i++)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffers[i]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, STAGING_SIZE, NULL, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        printf("Failed to create texture staging buffers \n");
+        return false;
+    }
+
+    return true;
+}
+
+TextureHandle TextureManager::load(const char *fileLocation)
+{
+    std::lock_guard<std::mutex> lock(loadMutex);
+
+    uint32_t index = textureCount.load(std::memory_order_relaxed);
+
+    if (index >= MAX_TEXTURES)
+    {
+        printf("Texture manager holds at most %zu textures \n", MAX_TEXTURES);
+        return INVALID_TEXTURE;
+    }
+
+    Texture &texture = textures[index];
+    texture.state.store(TEXTURE_DECODING, std::memory_order_relaxed);
+    texture.location = fileLocation;
+    texture.pixelsOffset = 0;
+    texture.channels = 0;
+    texture.levelCount = 0;
+    texture.textureId = 0;
+    texture.residentBase = 0;
+    texture.uploadLevel = -1;
+    texture.uploadRow = 0;
+    texture.wantedLevel = MAX_MIP_LEVELS;
+    texture.demandedLevel = MAX_MIP_LEVELS;
+    texture.lastUsedFrame = 0;
+    texture.loadTime = Clock::now();
+    texture.firstMipRecorded = false;
+
+    for (int level = 0; level < MAX_MIP_LEVELS; level++)
+    {
+        texture.decodeJobs[level].manager = this;
+        texture.decodeJobs[level].texture = &texture;
+        texture.decodeJobs[level].level = level;
+    }
+
+    // published before decoding starts, update() only looks at textures below the count
+    textureCount.store(index + 1, std::memory_order_release);
+
+    // with a single worker nothing else would ever pick the job up
+    if (jobs == NULL || jobs->getThreadCount() <= 1)
+        decode(texture);
+    else
+        jobs->run(decodeJob, &texture.decodeJobs[0], &pendingDecodes);
+
+    return index;
+}
+
+void TextureManager::decodeJob(void *data, size_t begin, size_t end)
+{
+    DecodeJob *job = (DecodeJob*)data;
+
+    job->manager->decode(*job->texture);
+}
+
+void TextureManager::decode(Texture &texture)
+{
+    if (!readFile(texture))
+    {
+        std::vector<uint8_t>().swap(texture.fileData);
+        texture.state.store(TEXTURE_FAILED, std::memory_order_release);
+        return;
+    }
+
+    // the bands of a level go out across the workers, each level waits for the one above it
+    forEachBand(texture, 0, convertRows);
+
+    for (int level = 1; level < texture.levelCount; level++)
+        forEachBand(texture, level, downsampleRows);
+
+    std::vector<uint8_t>().swap(texture.fileData);
+
+    texture.state.store(TEXTURE_DECODED, std::memory_order_release);
+}
+
+void TextureManager::forEachBand(Texture &texture, int level, JobFunction function)
+{
+    size_t bands = (texture.levelHeight[level] + DECODE_ROWS - 1) / DECODE_ROWS;
+    DecodeJob *job = &texture.decodeJobs[level];
+
+    // waiting inside a job runs other jobs meanwhile, so this never blocks a worker
+    if (jobs != NULL)
+        jobs->parallelFor(bands, 1, [&](size_t begin, size_t end) { function(job, begin, end); });
+    else
+        function(job, 0, bands);
+}
+
+bool TextureManager::readFile(Texture &texture)
+{
+    PROFILE_SCOPE("texture read");
+
+    FILE *file = fopen(texture.location.c_str(), "rb");
+
+    if (!file)
+    {
+        printf("Failed to read %s \n", texture.location.c_str());
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    texture.fileData.resize(size > 0 ? size : 0);
+    size_t read = fread(texture.fileData.data(), 1, texture.fileData.size(), file);
+    fclose(file);
+
+    if (read != texture.fileData.size() || !parseHeader(texture))
+    {
+        printf("Failed to decode %s, expected a binary PPM or PGM with 8 bits per channel \n", texture.location.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool TextureManager::parseHeader(Texture &texture)
+{
+    const std::vector<uint8_t> &file = texture.fileData;
+    size_t position = 0;
+
+    // magic, width, height & maximum value, separated by whitespace and # comments
+    long fields[4] = { 0, 0, 0, 0 };
+
+    if (file.size() < 2 || file[0] != 'P' || (file[1] != '5' && file[1] != '6'))
+        return false;
+
+    texture.channels = file[1] == '6' ? 3 : 1;
+    position = 2;
+
+    for (int field = 1; field < 4; field++)
+    {
+        while (position < file.size() && (isspace(file[position]) || file[position] == '#'))
+        {
+            if (file[position] == '#')
+                while (position < file.size() && file[position] != '\n')
+                    position++;
+            else
+                position++;
+        }
+
+        if (position >= file.size() || !isdigit(file[position]))
+            return false;
+
+        while (position < file.size() && isdigit(file[position]) && fields[field] < 1000000)
+            fields[field] = fields[field] * 10 + (file[position++] - '0');
+    }
+
+    // exactly one whitespace character before the raster
+    position++;
+
+    long width = fields[1], height = fields[2], maxValue = fields[3];
+
+    if (width <= 0 || height <= 0 || maxValue <= 0 || maxValue > 255)
+        return false;
+
+    if (width > (1 << (MAX_MIP_LEVELS - 1)) || height > (1 << (MAX_MIP_LEVELS - 1)))
+        return false;
+
+    if (position + (size_t)width * height * texture.channels > file.size())
+        return false;
+
+    texture.pixelsOffset = position;
+
+    // a full chain down to 1x1, each level half the size of the one above rounded down
+    size_t offset = 0;
+    int level = 0;
+
+    do
+    {
+        texture.levelWidth[level] = width >> level > 0 ? width >> level : 1;
+        texture.levelHeight[level] = height >> level > 0 ? height >> level : 1;
+        texture.levelOffset[level] = offset;
+
+        offset += levelBytes(texture, level);
+        level++;
+    } while (texture.levelWidth[level - 1] > 1 || texture.levelHeight[level - 1] > 1);
+
+    texture.levelCount = level;
+    texture.residentBase = level;
+    texture.pixels.resize(offset);
+
+    return true;
+}
+
+void TextureManager::convertRows(void *data, size_t begin, size_t end)
+{
+    PROFILE_SCOPE("texture decode");
+
+    Texture &texture = *((DecodeJob*)data)->texture;
+
+    GLsizei width = texture.levelWidth[0];
+    size_t lastRow = end * DECODE_ROWS < (size_t)texture.levelHeight[0] ? end * DECODE_ROWS : texture.levelHeight[0];
+
+    const uint8_t *source = &texture.fileData[texture.pixelsOffset];
+    uint8_t *destination = &texture.pixels[0];
+
+    // expanded to RGBA so every level uploads with the same format & 4 byte row alignment
+    for (size_t row = begin * DECODE_ROWS; row < lastRow; row++)
+    {
+        const uint8_t *in = source + row * width * texture.channels;
+        uint8_t *out = destination + row * width * 4;
+
+        for (GLsizei x = 0; x < width; x++)
+        {
+            if (texture.channels == 3)
+            {
+                out[x * 4 + 0] = in[x * 3 + 0];
+                out[x * 4 + 1] = in[x * 3 + 1];
+                out[x * 4 + 2] = in[x * 3 + 2];
+            }
+            else
+            {
+                out[x * 4 + 0] = in[x];
+                out[x * 4 + 1] = in[x];
+                out[x * 4 + 2] = in[x];
+            }
+
+            out[x * 4 + 3] = 255;
+        }
+    }
+}
+
+void TextureManager::downsampleRows(void *data, size_t begin, size_t end)
+{
+    PROFILE_SCOPE("texture downsample");
+
+    DecodeJob *job = (DecodeJob*)data;
+    Texture &texture = *job->texture;
+    int level = job->level;
+
+    GLsizei sourceWidth = texture.levelWidth[level - 1], sourceHeight = texture.levelHeight[level - 1];
+    GLsizei width = texture.levelWidth[level];
+    size_t lastRow = end * DECODE_ROWS < (size_t)texture.levelHeight[level] ? end * DECODE_ROWS : texture.levelHeight[level];
+
+    const uint8_t *source = &texture.pixels[texture.levelOffset[level - 1]];
+    uint8_t *destination = &texture.pixels[texture.levelOffset[level]];
+
+    // 2x2 box filter, edge texels repeat where a dimension has already reached 1
+    for (size_t row = begin * DECODE_ROWS; row < lastRow; row++)
+    {
+        const uint8_t *row0 = source + (size_t)(2 * row < (size_t)sourceHeight ? 2 * row : sourceHeight - 1) * sourceWidth * 4;
+        const uint8_t *row1 = source + (size_t)(2 * row + 1 < (size_t)sourceHeight ? 2 * row + 1 : sourceHeight - 1) * sourceWidth * 4;
+        uint8_t *out = destination + row * width * 4;
+
+        for (GLsizei x = 0; x < width; x++)
+        {
+            GLsizei x0 = 2 * x < sourceWidth ? 2 * x : sourceWidth - 1;
+            GLsizei x1 = 2 * x + 1 < sourceWidth ? 2 * x + 1 : sourceWidth - 1;
+
+            for (int c = 0; c < 4; c++)
+                out[x * 4 + c] = (row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c] + 2) >> 2;
+        }
+    }
+}
+
+void TextureManager::requestScreenSize(TextureHandle handle, GLfloat pixels)
+{
+    if (handle >= textureCount.load(std::memory_order_acquire))
+        return;
+
+    Texture &texture = textures[handle];
+    texture.lastUsedFrame = frame;
+
+    if (texture.state.load(std::memory_order_acquire) != TEXTURE_DECODED)
+        return;
+
+    // the level whose size is closest to, but not below, the footprint on screen
+    GLsizei size = texture.levelWidth[0] > texture.levelHeight[0] ? texture.levelWidth[0] : texture.levelHeight[0];
+    int level = pixels >= 1.0f ? (int)floorf(log2f(size / pixels)) : texture.levelCount - 1;
+
+    level = level < 0 ? 0 : (level >= texture.levelCount ? texture.levelCount - 1 : level);
+
+    if (level < texture.wantedLevel)
+        texture.wantedLevel = level;
+}
+
+void TextureManager::update()
+{
+    PROFILE_SCOPE("texture update");
+
+    uint32_t count = textureCount.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Texture &texture = textures[i];
+
+        if (texture.state.load(std::memory_order_acquire) != TEXTURE_DECODED)
+            continue;
+
+        if (texture.textureId == 0)
+            createTexture(texture);
+
+        // this frame's requests become the demand, textures nobody asked for only want their coarsest level
+        texture.demandedLevel = texture.wantedLevel < texture.levelCount ? texture.wantedLevel : texture.levelCount - 1;
+        texture.wantedLevel = MAX_MIP_LEVELS;
+    }
+
+    size_t uploaded = 0;
+
+    while (uploaded < uploadBudget)
+    {
+        Texture *texture = nextUpload();
+
+        if (texture == NULL)
+            break;
+
+        size_t sent = uploadBand(*texture, uploadBudget - uploaded);
+
+        if (sent == 0)
+            break;
+
+        uploaded += sent;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    windowTimes[windowIndex] = Clock::now();
+    windowBytes[windowIndex] = uploaded;
+    windowIndex = (windowIndex + 1) % BANDWIDTH_WINDOW;
+    windowCount = windowCount < BANDWIDTH_WINDOW ? windowCount + 1 : BANDWIDTH_WINDOW;
+
+    frame++;
+}
+
+void TextureManager::createTexture(Texture &texture)
+{
+    glGenTextures(1, &texture.textureId);
+    glBindTexture(GL_TEXTURE_2D, texture.textureId);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // sampling is limited to [residentBase, coarsest], so the texture stays complete as levels come & go
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, texture.levelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.levelCount - 1);
+}
+
+TextureManager::Texture* TextureManager::nextUpload()
+{
+    uint32_t count = textureCount.load(std::memory_order_acquire);
+    Texture *best = NULL;
+    int bestGap = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Texture &texture = textures[i];
+
+        if (texture.textureId == 0)
+            continue;
+
+        // a level that is partly up is always finished first
+        if (texture.uploadLevel >= 0)
+            return &texture;
+
+        // coarse to fine: whoever is furthest from what the screen asks for goes next, recently used first
+        int gap = texture.residentBase - texture.demandedLevel;
+
+        if (gap > bestGap || (gap == bestGap && best != NULL && texture.lastUsedFrame > best->lastUsedFrame))
+        {
+            best = &texture;
+            bestGap = gap;
+        }
+    }
+
+    return best;
+}
+
+size_t TextureManager::uploadBand(Texture &texture, size_t bytesLeft)
+{
+    glBindTexture(GL_TEXTURE_2D, texture.textureId);
+
+    if (texture.uploadLevel < 0)
+    {
+        int level = texture.residentBase - 1;
+        size_t bytes = levelBytes(texture, level);
+
+        if (!makeRoom(bytes))
+            return 0;
+
+        // allocates the level, the rows follow through the staging buffers
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, texture.levelWidth[level], texture.levelHeight[level], 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+        residentBytes += bytes;
+        texture.uploadLevel = level;
+        texture.uploadRow = 0;
+
+        // makeRoom may have rebound another texture to evict from it
+        glBindTexture(GL_TEXTURE_2D, texture.textureId);
+    }
+
+    // the buffer written four bands ago has to have been consumed by the GPU
+    GLsync &fence = stagingFences[stagingIndex];
+
+    if (fence)
+    {
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            return 0;
+
+        glDeleteSync(fence);
+        fence = 0;
+    }
+
+    int level = texture.uploadLevel;
+    size_t rowBytes = (size_t)texture.levelWidth[level] * 4;
+
+    GLsizei rows = texture.levelHeight[level] - texture.uploadRow;
+    GLsizei stagingRows = STAGING_SIZE / rowBytes;
+    GLsizei budgetRows = bytesLeft / rowBytes > 0 ? bytesLeft / rowBytes : 1;
+
+    rows = rows < stagingRows ? rows : stagingRows;
+    rows = rows < budgetRows ? rows : budgetRows;
+
+    size_t bytes = rows * rowBytes;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffers[stagingIndex]);
+
+    // invalidating lets the driver hand out fresh memory instead of syncing with the previous copy
+    void *staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (staging == NULL)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return 0;
+    }
+
+    memcpy(staging, &texture.pixels[texture.levelOffset[level] + texture.uploadRow * rowBytes], bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // sourced from the bound buffer at offset 0, the copy runs asynchronously
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, texture.uploadRow, texture.levelWidth[level], rows, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    stagingIndex = (stagingIndex + 1) % STAGING_BUFFERS;
+
+    totalUploadBytes += bytes;
+    renderStats.add(COUNTER_UPLOAD_BYTES, bytes);
+
+    texture.uploadRow += rows;
+
+    // the whole level is up, later commands sample it
+    if (texture.uploadRow == texture.levelHeight[level])
+    {
+        texture.residentBase = level;
+        texture.uploadLevel = -1;
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+
+        if (!texture.firstMipRecorded)
+        {
+            double seconds = std::chrono::duration<double>(Clock::now() - texture.loadTime).count();
+
+            firstMipTotal += seconds;
+            firstMipMax = seconds > firstMipMax ? seconds : firstMipMax;
+            firstMipCount++;
+
+            texture.firstMipRecorded = true;
+        }
+    }
+
+    return bytes;
+}
+
+bool TextureManager::makeRoom(size_t bytes)
+{
+    uint32_t count = textureCount.load(std::memory_order_acquire);
+
+    while (residentBytes + bytes > budget)
+    {
+        // least recently used first, then whoever holds the most levels beyond its demand
+        Texture *victim = NULL;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Texture &texture = textures[i];
+
+            // the coarsest level always stays, so nothing falls back to the placeholder
+            if (texture.textureId == 0 || texture.uploadLevel >= 0 || texture.residentBase >= texture.levelCount - 1)
+                continue;
+
+            bool overResident = texture.residentBase < texture.demandedLevel;
+
+            if (texture.lastUsedFrame == frame && !overResident)
+                continue;
+
+            if (victim == NULL || texture.lastUsedFrame < victim->lastUsedFrame ||
+                (texture.lastUsedFrame == victim->lastUsedFrame && texture.demandedLevel - texture.residentBase > victim->demandedLevel - victim->residentBase))
+                victim = &texture;
+        }
+
+        if (victim == NULL)
+            return false;
+
+        evictLevel(*victim);
+    }
+
+    return true;
+}
+
+void TextureManager::evictLevel(Texture &texture)
+{
+    int level = texture.residentBase;
+
+    glBindTexture(GL_TEXTURE_2D, texture.textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+
+    // respecifying the level as an empty image releases its storage
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+    residentBytes -= levelBytes(texture, level);
+    texture.residentBase = level + 1;
+
+    evictionCount++;
+}
+
+GLuint TextureManager::getTextureId(TextureHandle handle)
+{
+    if (handle >= textureCount.load(std::memory_order_acquire))
+        return placeholder;
+
+    Texture &texture = textures[handle];
+
+    if (texture.textureId == 0 || texture.residentBase >= texture.levelCount)
+        return placeholder;
+
+    return texture.textureId;
+}
+
+void TextureManager::bind(TextureHandle handle, GLuint unit)
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, getTextureId(handle));
+}
+
+double TextureManager::getUploadBandwidth()
+{
+    if (windowCount < 2)
+        return 0.0;
+
+    size_t newest = (windowIndex + BANDWIDTH_WINDOW - 1) % BANDWIDTH_WINDOW;
+    size_t oldest = (windowIndex + BANDWIDTH_WINDOW - windowCount) % BANDWIDTH_WINDOW;
+
+    // bytes sent after the oldest frame, over the time since it
+    size_t bytes = 0;
+
+    for (size_t i = 1; i < windowCount; i++)
+        bytes += windowBytes[(oldest + i) % BANDWIDTH_WINDOW];
+
+    double seconds = std::chrono::duration<double>(windowTimes[newest] - windowTimes[oldest]).count();
+
+    return seconds > 0.0 ? bytes / seconds : 0.0;
+}
+
+void TextureManager::printStatistics()
+{
+    uint32_t count = textureCount.load(std::memory_order_acquire);
+
+    if (count == 0)
+        return;
+
+    printf("textures %u | resident %.1f / %.1f MB | uploaded %.1f MB, %.1f MB/s recently | first mip mean %.2f ms, max %.2f ms | evictions %zu \n",
+        count, residentBytes / 1048576.0, budget / 1048576.0, totalUploadBytes / 1048576.0, getUploadBandwidth() / 1048576.0,
+        1000.0 * getMeanTimeToFirstMip(), 1000.0 * getMaxTimeToFirstMip(), evictionCount);
+}
+
+void TextureManager::Shutdown()
+{
+    // decode jobs write into the textures, none may still be running
+    if (jobs != NULL)
+        jobs->wait(&pendingDecodes);
+
+    uint32_t count = textureCount.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Texture &texture = textures[i];
+
+        if (texture.textureId != 0)
+        {
+            glDeleteTextures(1, &texture.textureId);
+            texture.textureId = 0;
+        }
+
+        std::vector<uint8_t>().swap(texture.pixels);
+    }
+
+    textureCount.store(0, std::memory_order_release);
+    residentBytes = 0;
+
+    for (int i = 0; i < STAGING_BUFFERS; i++)
+    {
+        if (stagingFences[i])
+        {
+            glDeleteSync(stagingFences[i]);
+            stagingFences[i] = 0;
+        }
+    }
+
+    if (stagingBuffers[0] != 0)
+    {
+        glDeleteBuffers(STAGING_BUFFERS, stagingBuffers);
+
+        for (int i = 0; i < STAGING_BUFFERS; i++)
+            stagingBuffers[i] = 0;
+    }
+
+    if (placeholder != 0)
+    {
+        glDeleteTextures(1, &placeholder);
+        placeholder = 0;
+    }
+}
+
+TextureManager::~TextureManager()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "../headers/TransformHierarchy.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+TransformHierarchy::TransformHierarchy()
+{
+    jobs = NULL;
+    anyDirty = false;
+    levelsStale = false;
+}
+
+void TransformHierarchy::reserve(size_t nodeCount)
+{
+    parents.reserve(nodeCount);
+    depths.reserve(nodeCount);
+
+    tx.reserve(nodeCount);
+    ty.reserve(nodeCount);
+    tz.reserve(nodeCount);
+
+    rx.reserve(nodeCount);
+    ry.reserve(nodeCount);
+    rz.reserve(nodeCount);
+    rw.reserve(nodeCount);
+
+    sx.reserve(nodeCount);
+    sy.reserve(nodeCount);
+    sz.reserve(nodeCount);
+
+    dirty.reserve(nodeCount);
+    worldMatrices.reserve(nodeCount);
+}
+
+uint32_t TransformHierarchy::addNode(uint32_t parent, glm::vec3 translation, glm::quat rotation, glm::vec3 scale)
+{
+    uint32_t node = parents.size();
+
+    // a parent must exist before its children, which keeps the arrays topologically sorted
+    if (parent != NO_PARENT && parent >= node)
+    {
+        printf("Transform node %u cannot be the parent of node %u, it does not exist yet \n", parent, node);
+        return INVALID_NODE;
+    }
+
+    parents.push_back(parent);
+    depths.push_back(parent != NO_PARENT ? depths[parent] + 1 : 0);
+    levelsStale = true;
+
+    tx.push_back(translation.x);
+    ty.push_back(translation.y);
+    tz.push_back(translation.z);
+
+    rotation = glm::normalize(rotation);
+    rx.push_back(rotation.x);
+    ry.push_back(rotation.y);
+    rz.push_back(rotation.z);
+    rw.push_back(rotation.w);
+
+    sx.push_back(scale.x);
+    sy.push_back(scale.y);
+    sz.push_back(scale.z);
+
+    dirty.push_back(1);
+    anyDirty = true;
+
+    worldMatrices.push_back(glm::mat4(1.0f));
+
+    return node;
+}
+
+void TransformHierarchy::setTranslation(uint32_t node, glm::vec3 translation)
+{
+    tx[node] = translation.x;
+    ty[node] = translation.y;
+    tz[node] = translation.z;
+
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+void TransformHierarchy::setRotation(uint32_t node, glm::quat rotation)
+{
+    rotation = glm::normalize(rotation);
+
+    rx[node] = rotation.x;
+    ry[node] = rotation.y;
+    rz[node] = rotation.z;
+    rw[node] = rotation.w;
+
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+void TransformHierarchy::setScale(uint32_t node, glm::vec3 scale)
+{
+    sx[node] = scale.x;
+    sy[node] = scale.y;
+    sz[node] = scale.z;
+
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+size_t TransformHierarchy::update()
+{
+    if (!anyDirty)
+        return 0;
+
+    size_t nodeCount = parents.size();
+    size_t updated = 0;
+
+    // the parent was visited earlier in this pass, so its flag is already final
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        uint32_t parent = parents[i];
+
+        if (parent != NO_PARENT)
+            dirty[i] |= dirty[parent];
+
+        updated += dirty[i];
+    }
+
+    // with enough of the tree dirty it's cheaper to build every local matrix in one
+    // vectorised sweep than to pick the dirty ones out one at a time
+    bool batched = updated * BATCH_DIRTY_RATIO >= nodeCount;
+
+    bool parallel = jobs != NULL && nodeCount >= PARALLEL_UPDATE_THRESHOLD;
+
+    if (batched)
+    {
+        localMatrices.resize(nodeCount);
+
+        if (parallel)
+            jobs->parallelFor(nodeCount, 0, [&](size_t begin, size_t end) { composeBatch(begin, end); });
+        else
+            composeBatch(0, nodeCount);
+    }
+
+    if (!parallel)
+    {
+        for (size_t i = 0; i < nodeCount; i++)
+            updateWorld(i, batched);
+    }
+    else
+    {
+        if (levelsStale)
+            buildLevels();
+
+        // level by level, every parent is final before its children are read
+        for (size_t level = 0; level + 1 < levelStarts.size(); level++)
+        {
+            size_t first = levelStarts[level], count = levelStarts[level + 1] - first;
+
+            if (count < PARALLEL_UPDATE_THRESHOLD)
+            {
+                for (size_t n = first; n < first + count; n++)
+                    updateWorld(levelNodes[n], batched);
+            }
+            else
+            {
+                jobs->parallelFor(count, 0, [&](size_t begin, size_t end) {
+                    for (size_t n = first + begin; n < first + end; n++)
+                        updateWorld(levelNodes[n], batched);
+                });
+            }
+        }
+    }
+
+    memset(dirty.data(), 0, nodeCount);
+    anyDirty = false;
+
+    return updated;
+}
+
+void TransformHierarchy::composeBatch(size_t begin, size_t end)
+{
+    TransformStreams streams = {
+        tx.data() + begin, ty.data() + begin, tz.data() + begin,
+        rx.data() + begin, ry.data() + begin, rz.data() + begin, rw.data() + begin,
+        sx.data() + begin, sy.data() + begin, sz.data() + begin
+    };
+
+    ComposeTransforms(streams, end - begin, glm::value_ptr(localMatrices[begin]), NULL);
+}
+
+void TransformHierarchy::updateWorld(size_t i, bool batched)
+{
+    if (!dirty[i])
+        return;
+
+    glm::mat4 local = batched ? localMatrices[i] : composeLocal(i);
+    uint32_t parent = parents[i];
+
+    worldMatrices[i] = parent != NO_PARENT ? worldMatrices[parent] * local : local;
+}
+
+void TransformHierarchy::buildLevels()
+{
+    // counting sort by depth, nodes keep their order within a level
+    size_t nodeCount = parents.size();
+    uint32_t deepest = 0;
+
+    for (size_t i = 0; i < nodeCount; i++)
+        deepest = depths[i] > deepest ? depths[i] : deepest;
+
+    levelStarts.assign(deepest + 2, 0);
+
+    for (size_t i = 0; i < nodeCount; i++)
+        levelStarts[depths[i] + 1]++;
+
+    for (size_t level = 1; level < levelStarts.size(); level++)
+        levelStarts[level] += levelStarts[level - 1];
+
+    std::vector<size_t> next(levelStarts.begin(), levelStarts.end() - 1);
+    levelNodes.resize(nodeCount);
+
+    for (size_t i = 0; i < nodeCount; i++)
+        levelNodes[next[depths[i]]++] = i;
+
+    levelsStale = false;
+}
+
+glm::mat4 TransformHierarchy::composeLocal(size_t i)
+{
+    // T * R * S written out directly instead of three chained 4x4 multiplies
+    float x = rx[i], y = ry[i], z = rz[i], w = rw[i];
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    glm::mat4 local;
+    local[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * sx[i], 2.0f * (xy + wz) * sx[i], 2.0f * (xz - wy) * sx[i], 0.0f);
+    local[1] = glm::vec4(2.0f * (xy - wz) * sy[i], (1.0f - 2.0f * (xx + zz)) * sy[i], 2.0f * (yz + wx) * sy[i], 0.0f);
+    local[2] = glm::vec4(2.0f * (xz + wy) * sz[i], 2.0f * (yz - wx) * sz[i], (1.0f - 2.0f * (xx + yy)) * sz[i], 0.0f);
+    local[3] = glm::vec4(tx[i], ty[i], tz[i], 1.0f);
+
+    return local;
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "../headers/TransformKernels.h"
+
+#include <string.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+typedef void (*ComposeFunction)(const TransformStreams &in, size_t begin, size_t count, float *out, const float *viewProjection);
+
+static void composeScalar(const TransformStreams &in, size_t begin, size_t count, float *out, const float *vp)
+{
+    for (size_t i = begin; i < count; i++)
+    {
+        float x = in.rx[i], y = in.ry[i], z = in.rz[i], w = in.rw[i];
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+
+        float m[16] = {
+            (1.0f - 2.0f * (yy + zz)) * in.sx[i], 2.0f * (xy + wz) * in.sx[i], 2.0f * (xz - wy) * in.sx[i], 0.0f,
+            2.0f * (xy - wz) * in.sy[i], (1.0f - 2.0f * (xx + zz)) * in.sy[i], 2.0f * (yz + wx) * in.sy[i], 0.0f,
+            2.0f * (xz + wy) * in.sz[i], 2.0f * (yz - wx) * in.sz[i], (1.0f - 2.0f * (xx + yy)) * in.sz[i], 0.0f,
+            in.tx[i], in.ty[i], in.tz[i], 1.0f
+        };
+
+        float *target = out + i * 16;
+
+        if (!vp)
+        {
+            for (int e = 0; e < 16; e++)
+                target[e] = m[e];
+
+            continue;
+        }
+
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                target[column * 4 + row] = vp[row] * m[column * 4] + vp[4 + row] * m[column * 4 + 1] +
+                    vp[8 + row] * m[column * 4 + 2] + vp[12 + row] * m[column * 4 + 3];
+            }
+        }
+    }
+}
+
+#ifdef TRANSFORM_KERNELS_X86
+
+// vp * column, columns of vp in registers
+static inline __m128 transformColumn(const __m128 vp[4], __m128 column)
+{
+    __m128 result = _mm_mul_ps(vp[0], _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)));
+    result = _mm_add_ps(result, _mm_mul_ps(vp[1], _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1))));
+    result = _mm_add_ps(result, _mm_mul_ps(vp[2], _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2))));
+    result = _mm_add_ps(result, _mm_mul_ps(vp[3], _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    return result;
+}
+
+// turns four lanes of matrix elements (one matrix per lane) into four whole matrices
+static inline void storeMatrices4(__m128 c0x, __m128 c0y, __m128 c0z, __m128 c1x, __m128 c1y, __m128 c1z,
+    __m128 c2x, __m128 c2y, __m128 c2z, __m128 px, __m128 py, __m128 pz, float *out, const __m128 *vp)
+{
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 c0w = zero, c1w = zero, c2w = zero, pw = one;
+
+    _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+    _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+    _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+    _MM_TRANSPOSE4_PS(px, py, pz, pw);
+
+    // after the transposes register n of each group is column k of matrix n
+    __m128 columns[4][4] = {
+        { c0x, c1x, c2x, px },
+        { c0y, c1y, c2y, py },
+        { c0z, c1z, c2z, pz },
+        { c0w, c1w, c2w, pw }
+    };
+
+    for (int m = 0; m < 4; m++)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            __m128 column = vp ? transformColumn(vp, columns[m][k]) : columns[m][k];
+            _mm_storeu_ps(out + m * 16 + k * 4, column);
+        }
+    }
+}
+
+static void composeSSE(const TransformStreams &in, size_t begin, size_t count, float *out, const float *viewProjection)
+{
+    __m128 vpColumns[4];
+    const __m128 *vp = NULL;
+
+    if (viewProjection)
+    {
+        for (int c = 0; c < 4; c++)
+            vpColumns[c] = _mm_loadu_ps(viewProjection + c * 4);
+
+        vp = vpColumns;
+    }
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 two = _mm_set1_ps(2.0f);
+
+    size_t i = begin;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(in.rx + i), y = _mm_loadu_ps(in.ry + i), z = _mm_loadu_ps(in.rz + i), w = _mm_loadu_ps(in.rw + i);
+        __m128 sx = _mm_loadu_ps(in.sx + i), sy = _mm_loadu_ps(in.sy + i), sz = _mm_loadu_ps(in.sz + i);
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+
+        __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+
+        __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+        storeMatrices4(c0x, c0y, c0z, c1x, c1y, c1z, c2x, c2y, c2z,
+            _mm_loadu_ps(in.tx + i), _mm_loadu_ps(in.ty + i), _mm_loadu_ps(in.tz + i), out + i * 16, vp);
+    }
+
+    composeScalar(in, i, count, out, viewProjection);
+}
+
+__attribute__((target("avx2,fma")))
+static void composeAVX2(const TransformStreams &in, size_t begin, size_t count, float *out, const float *viewProjection)
+{
+    __m128 vpColumns[4];
+    const __m128 *vp = NULL;
+
+    if (viewProjection)
+    {
+        for (int c = 0; c < 4; c++)
+            vpColumns[c] = _mm_loadu_ps(viewProjection + c * 4);
+
+        vp = vpColumns;
+    }
+
+    __m256 two = _mm256_set1_ps(2.0f);
+
+    size_t i = begin;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(in.rx + i), y = _mm256_loadu_ps(in.ry + i), z = _mm256_loadu_ps(in.rz + i), w = _mm256_loadu_ps(in.rw + i);
+        __m256 sx = _mm256_loadu_ps(in.sx + i), sy = _mm256_loadu_ps(in.sy + i), sz = _mm256_loadu_ps(in.sz + i);
+
+        // doubled coordinates up front so every sum of products below is one fused multiply-add;
+        // the view projection product stays on the shared SSE path
+        __m256 x2 = _mm256_mul_ps(x, two), y2 = _mm256_mul_ps(y, two), z2 = _mm256_mul_ps(z, two);
+        __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+        __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+
+        // the diagonal is s - (a + b) * s
+        __m256 c[9] = {
+            _mm256_fnmadd_ps(_mm256_add_ps(yy, zz), sx, sx),
+            _mm256_mul_ps(_mm256_fmadd_ps(x, y2, wz), sx),
+            _mm256_mul_ps(_mm256_fmsub_ps(x, z2, wy), sx),
+            _mm256_mul_ps(_mm256_fmsub_ps(x, y2, wz), sy),
+            _mm256_fnmadd_ps(_mm256_add_ps(xx, zz), sy, sy),
+            _mm256_mul_ps(_mm256_fmadd_ps(y, z2, wx), sy),
+            _mm256_mul_ps(_mm256_fmadd_ps(x, z2, wy), sz),
+            _mm256_mul_ps(_mm256_fmsub_ps(y, z2, wx), sz),
+            _mm256_fnmadd_ps(_mm256_add_ps(xx, yy), sz, sz)
+        };
+
+        __m256 tx = _mm256_loadu_ps(in.tx + i), ty = _mm256_loadu_ps(in.ty + i), tz = _mm256_loadu_ps(in.tz + i);
+
+        // each 128-bit half holds four matrices
+        for (int half = 0; half < 2; half++)
+        {
+            __m128 h[9];
+
+            for (int e = 0; e < 9; e++)
+                h[e] = half ? _mm256_extractf128_ps(c[e], 1) : _mm256_castps256_ps128(c[e]);
+
+            __m128 px = half ? _mm256_extractf128_ps(tx, 1) : _mm256_castps256_ps128(tx);
+            __m128 py = half ? _mm256_extractf128_ps(ty, 1) : _mm256_castps256_ps128(ty);
+            __m128 pz = half ? _mm256_extractf128_ps(tz, 1) : _mm256_castps256_ps128(tz);
+
+            storeMatrices4(h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7], h[8], px, py, pz, out + (i + half * 4) * 16, vp);
+        }
+    }
+
+    composeSSE(in, i, count, out, viewProjection);
+}
+
+__attribute__((target("avx512f")))
+static void composeAVX512(const TransformStreams &in, size_t begin, size_t count, float *out, const float *viewProjection)
+{
+    __m128 vpColumns[4];
+    const __m128 *vp = NULL;
+
+    if (viewProjection)
+    {
+        for (int c = 0; c < 4; c++)
+            vpColumns[c] = _mm_loadu_ps(viewProjection + c * 4);
+
+        vp = vpColumns;
+    }
+
+    __m512 two = _mm512_set1_ps(2.0f);
+
+    size_t i = begin;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 x = _mm512_loadu_ps(in.rx + i), y = _mm512_loadu_ps(in.ry + i), z = _mm512_loadu_ps(in.rz + i), w = _mm512_loadu_ps(in.rw + i);
+        __m512 sx = _mm512_loadu_ps(in.sx + i), sy = _mm512_loadu_ps(in.sy + i), sz = _mm512_loadu_ps(in.sz + i);
+
+        // the same fused multiply-adds as the AVX2 path, AVX-512F has them built in
+        __m512 x2 = _mm512_mul_ps(x, two), y2 = _mm512_mul_ps(y, two), z2 = _mm512_mul_ps(z, two);
+        __m512 xx = _mm512_mul_ps(x, x2), yy = _mm512_mul_ps(y, y2), zz = _mm512_mul_ps(z, z2);
+        __m512 wx = _mm512_mul_ps(w, x2), wy = _mm512_mul_ps(w, y2), wz = _mm512_mul_ps(w, z2);
+
+        __m512 c[12] = {
+            _mm512_fnmadd_ps(_mm512_add_ps(yy, zz), sx, sx),
+            _mm512_mul_ps(_mm512_fmadd_ps(x, y2, wz), sx),
+            _mm512_mul_ps(_mm512_fmsub_ps(x, z2, wy), sx),
+            _mm512_mul_ps(_mm512_fmsub_ps(x, y2, wz), sy),
+            _mm512_fnmadd_ps(_mm512_add_ps(xx, zz), sy, sy),
+            _mm512_mul_ps(_mm512_fmadd_ps(y, z2, wx), sy),
+            _mm512_mul_ps(_mm512_fmadd_ps(x, z2, wy), sz),
+            _mm512_mul_ps(_mm512_fmsub_ps(y, z2, wx), sz),
+            _mm512_fnmadd_ps(_mm512_add_ps(xx, yy), sz, sz),
+            _mm512_loadu_ps(in.tx + i),
+            _mm512_loadu_ps(in.ty + i),
+            _mm512_loadu_ps(in.tz + i)
+        };
+
+        // spill the lanes once and transpose them four matrices at a time
+        alignas(64) float lanes[12][16];
+
+        for (int e = 0; e < 12; e++)
+            _mm512_store_ps(lanes[e], c[e]);
+
+        for (int quarter = 0; quarter < 4; quarter++)
+        {
+            __m128 q[12];
+
+            for (int e = 0; e < 12; e++)
+                q[e] = _mm_load_ps(lanes[e] + quarter * 4);
+
+            storeMatrices4(q[0], q[1], q[2], q[3], q[4], q[5], q[6], q[7], q[8], q[9], q[10], q[11], out + (i + quarter * 4) * 16, vp);
+        }
+    }
+
+    composeSSE(in, i, count, out, viewProjection);
+}
+
+static ComposeFunction selectKernel(const char **name)
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        *name = "avx512";
+        return composeAVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        *name = "avx2";
+        return composeAVX2;
+    }
+
+    *name = "sse";
+    return composeSSE;
+}
+
+// the kernel called name if the CPU runs it, the name stored is our own copy
+static ComposeFunction findKernel(const char *name, const char **found)
+{
+    __builtin_cpu_init();
+
+    if (strcmp(name, "avx512") == 0 && __builtin_cpu_supports("avx512f"))
+    {
+        *found = "avx512";
+        return composeAVX512;
+    }
+
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        *found = "avx2";
+        return composeAVX2;
+    }
+
+    if (strcmp(name, "sse") == 0)
+    {
+        *found = "sse";
+        return composeSSE;
+    }
+
+    if (strcmp(name, "scalar") == 0)
+    {
+        *found = "scalar";
+        return composeScalar;
+    }
+
+    return NULL;
+}
+
+#else
+
+static ComposeFunction selectKernel(const char **name)
+{
+    *name = "scalar";
+    return composeScalar;
+}
+
+static ComposeFunction findKernel(const char *name, const char **found)
+{
+    if (strcmp(name, "scalar") != 0)
+        return NULL;
+
+    *found = "scalar";
+    return composeScalar;
+}
+
+#endif
+
+static const char *kernelName = "";
+static ComposeFunction kernel = selectKernel(&kernelName);
+
+void ComposeTransforms(const TransformStreams &in, size_t count, float *out, const glm::mat4 *viewProjection)
+{
+    kernel(in, 0, count, out, viewProjection ? glm::value_ptr(*viewProjection) : NULL);
+}
+
+bool SetTransformKernel(const char *name)
+{
+    if (!name)
+    {
+        kernel = selectKernel(&kernelName);
+        return true;
+    }
+
+    const char *found = NULL;
+    ComposeFunction chosen = findKernel(name, &found);
+
+    if (!chosen)
+        return false;
+
+    kernel = chosen;
+    kernelName = found;
+
+    return true;
+}
+
+const char* GetTransformKernelName()
+{
+    return kernelName;
+}
\ No newline at end of file
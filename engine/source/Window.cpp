@@ -0,0 +1,429 @@
+#include "../headers/Window.h"
+
+Window::Window()
+{
+    width = 800;
+    height = 600;
+
+    backend = WINDOW_GLFW;
+    mainWindow = NULL;
+
+    eglDisplay = EGL_NO_DISPLAY;
+    eglSurface = EGL_NO_SURFACE;
+    eglContext = EGL_NO_CONTEXT;
+
+    framebuffer = 0;
+    colourBuffer = 0;
+    depthBuffer = 0;
+    closeRequested = false;
+
+    mouseFirstMoved = true;
+}
+
+Window::Window(GLint windowWidth, GLint windowHeight)
+{
+    width = windowWidth;
+    height = windowHeight;
+
+    backend = WINDOW_GLFW;
+    mainWindow = NULL;
+
+    eglDisplay = EGL_NO_DISPLAY;
+    eglSurface = EGL_NO_SURFACE;
+    eglContext = EGL_NO_CONTEXT;
+
+    framebuffer = 0;
+    colourBuffer = 0;
+    depthBuffer = 0;
+    closeRequested = false;
+
+    mouseFirstMoved = true;
+}
+
+int Window::Initialise(WindowBackend windowBackend)
+{
+    backend = windowBackend;
+    startTime = std::chrono::steady_clock::now();
+
+    if (isHeadless())
+        return initialiseHeadless();
+
+    if (!glfwInit())
+    {
+        printf("Error initialising GLFW \n");
+
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    // setup GLFW window properties
+    // OpenGL version
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // core profile
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // allow forward compatibility
+
+    mainWindow = glfwCreateWindow(width, height, "Test Window", NULL, NULL);
+
+    if (!mainWindow)
+    {
+        printf("GLFW window creation failed \n");
+
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    // get buffer size information
+    glfwGetFramebufferSize(mainWindow, &bufferWidth, &bufferHeight);
+
+    // set context for GLEW to use
+    glfwMakeContextCurrent(mainWindow);
+
+    // handle key & mouse input
+    createCallbacks();
+    glfwSetInputMode(mainWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED); // lock cursor to window
+
+    // unaccelerated motion straight from high polling rate mice, when the platform has it
+    if (glfwRawMouseMotionSupported())
+        glfwSetInputMode(mainWindow, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+
+    // allow modern extension features
+    glewExperimental = GL_TRUE;
+
+    GLenum error = glewInit();
+
+	if (error != GLEW_OK)
+    {
+        printf("GLEW initialisation failed : %s \n", glewGetErrorString(glewInit()));
+
+        glfwDestroyWindow(mainWindow);
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glEnable(GL_DEPTH_TEST);
+
+    // create viewport
+    glViewport(0, 0, bufferWidth, bufferHeight);
+
+    glfwSetWindowUserPointer(mainWindow, this);
+
+    return 0;
+}
+
+int Window::initialiseHeadless()
+{
+    // surfaceless needs no display connection at all, pbuffer goes through the default display
+    if (backend == WINDOW_EGL_SURFACELESS)
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+        if (getPlatformDisplay)
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    else
+    {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, NULL, NULL))
+    {
+        printf("Error initialising EGL display \n");
+        return 1;
+    }
+
+    EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, backend == WINDOW_EGL_PBUFFER ? EGL_PBUFFER_BIT : 0,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint configCount = 0;
+
+    if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        printf("No EGL config for desktop OpenGL \n");
+        clearHeadless();
+        return 1;
+    }
+
+    // same context the GLFW window asks for
+    EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE,
+        EGL_NONE
+    };
+
+    eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (eglContext == EGL_NO_CONTEXT)
+    {
+        printf("EGL context creation failed \n");
+        clearHeadless();
+        return 1;
+    }
+
+    if (backend == WINDOW_EGL_PBUFFER)
+    {
+        // rendering goes to the framebuffer object, the pbuffer only has to exist
+        EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttributes);
+    }
+
+    if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext))
+    {
+        printf("EGL make current failed \n");
+        clearHeadless();
+        return 1;
+    }
+
+    // allow modern extension features
+    glewExperimental = GL_TRUE;
+
+    GLenum error = glewInit();
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLX builds of GLEW complain about the missing X display but load the GL entry points fine
+    if (error == GLEW_ERROR_NO_GLX_DISPLAY)
+        error = GLEW_OK;
+#endif
+
+    if (error != GLEW_OK)
+    {
+        printf("GLEW initialisation failed : %s \n", glewGetErrorString(error));
+        clearHeadless();
+        return 1;
+    }
+
+    bufferWidth = width;
+    bufferHeight = height;
+
+    // offscreen colour & depth targets standing in for the window's back buffer
+    glGenRenderbuffers(1, &colourBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colourBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, bufferWidth, bufferHeight);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, bufferWidth, bufferHeight);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colourBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        printf("Offscreen framebuffer is incomplete \n");
+        clearHeadless();
+        return 1;
+    }
+
+    printf("Headless renderer : %s \n", glGetString(GL_RENDERER));
+
+    glEnable(GL_DEPTH_TEST);
+
+    // create viewport
+    glViewport(0, 0, bufferWidth, bufferHeight);
+
+    return 0;
+}
+
+void Window::clearHeadless()
+{
+    if (eglContext != EGL_NO_CONTEXT && eglGetCurrentContext() == eglContext)
+    {
+        if (framebuffer != 0)
+            glDeleteFramebuffers(1, &framebuffer);
+
+        if (colourBuffer != 0)
+            glDeleteRenderbuffers(1, &colourBuffer);
+
+        if (depthBuffer != 0)
+            glDeleteRenderbuffers(1, &depthBuffer);
+    }
+
+    framebuffer = 0;
+    colourBuffer = 0;
+    depthBuffer = 0;
+
+    if (eglDisplay != EGL_NO_DISPLAY)
+    {
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        if (eglSurface != EGL_NO_SURFACE)
+            eglDestroySurface(eglDisplay, eglSurface);
+
+        if (eglContext != EGL_NO_CONTEXT)
+            eglDestroyContext(eglDisplay, eglContext);
+
+        eglTerminate(eglDisplay);
+    }
+
+    eglDisplay = EGL_NO_DISPLAY;
+    eglSurface = EGL_NO_SURFACE;
+    eglContext = EGL_NO_CONTEXT;
+}
+
+bool Window::getShouldClose()
+{
+    if (isHeadless())
+        return closeRequested;
+
+    return glfwWindowShouldClose(mainWindow);
+}
+
+void Window::setShouldClose(bool shouldClose)
+{
+    closeRequested = shouldClose;
+
+    if (mainWindow)
+        glfwSetWindowShouldClose(mainWindow, shouldClose);
+}
+
+void Window::pollEvents()
+{
+    // offscreen backends have no event source
+    if (!isHeadless())
+        glfwPollEvents();
+
+    // motion held back while the queue was full goes in as soon as the camera has made room
+    inputQueue.flush();
+}
+
+double Window::getTime()
+{
+    if (!isHeadless())
+        return glfwGetTime();
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Window::makeContextCurrent(bool current)
+{
+    if (isHeadless())
+    {
+        if (current)
+            eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext);
+        else
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+    else
+    {
+        glfwMakeContextCurrent(current ? mainWindow : NULL);
+    }
+}
+
+void Window::setTitle(const char *title)
+{
+    // glfw only allows this from the main thread
+    if (!isHeadless())
+        glfwSetWindowTitle(mainWindow, title);
+}
+
+void Window::setSwapInterval(int interval)
+{
+    // an offscreen framebuffer is never presented, so there is nothing to sync to
+    if (!isHeadless())
+        glfwSwapInterval(interval);
+}
+
+void Window::swapBuffers()
+{
+    PROFILE_GPU_SCOPE("swap");
+
+    if (isHeadless())
+        glFlush(); // nothing to present, just hand the frame to the driver
+    else
+        glfwSwapBuffers(mainWindow);
+}
+
+void Window::createCallbacks()
+{
+    glfwSetKeyCallback(mainWindow, handleKeys);
+    glfwSetCursorPosCallback(mainWindow, handleMouse);
+    glfwSetMouseButtonCallback(mainWindow, handleButtons);
+}
+
+// callbacks run inside glfwPollEvents, so events are stamped with the time they are delivered
+void Window::handleKeys(GLFWwindow *window, int key, int code, int action, int mode)
+{
+    Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, GL_TRUE);
+
+    if (key >= 0 && key < 1024 && action != GLFW_REPEAT)
+    {
+        InputEvent event;
+        event.time = glfwGetTime();
+        event.xChange = 0.0f;
+        event.yChange = 0.0f;
+        event.code = key;
+        event.type = INPUT_KEY;
+        event.action = action;
+
+        theWindow->inputQueue.push(event);
+    }
+}
+
+void Window::handleMouse(GLFWwindow *window, double xPos, double yPos)
+{
+    Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    
+    if (theWindow->mouseFirstMoved)
+    {
+        theWindow->lastX = xPos;
+        theWindow->lastY = yPos;
+        theWindow->mouseFirstMoved = false;
+    }
+
+    // every cursor event keeps its own delta, the consumer sums them
+    InputEvent event;
+    event.time = glfwGetTime();
+    event.xChange = xPos - theWindow->lastX;
+    event.yChange = theWindow->lastY - yPos; // avoid inverted vertical axis
+    event.code = 0;
+    event.type = INPUT_MOTION;
+    event.action = 0;
+
+    theWindow->inputQueue.push(event);
+    
+    theWindow->lastX = xPos;
+    theWindow->lastY = yPos;
+}
+
+void Window::handleButtons(GLFWwindow *window, int button, int action, int mode)
+{
+    Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+
+    InputEvent event;
+    event.time = glfwGetTime();
+    event.xChange = 0.0f;
+    event.yChange = 0.0f;
+    event.code = button;
+    event.type = INPUT_BUTTON;
+    event.action = action;
+
+    theWindow->inputQueue.push(event);
+}
+
+Window::~Window()
+{
+    if (isHeadless())
+    {
+        clearHeadless();
+        return;
+    }
+
+    if (mainWindow)
+        glfwDestroyWindow(mainWindow);
+
+    glfwTerminate();
+}
\ No newline at end of file
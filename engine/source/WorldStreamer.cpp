@@ -0,0 +1,465 @@
+#include "../headers/WorldStreamer.h"
+
+WorldStreamer::WorldStreamer()
+{
+    jobs = NULL;
+
+    chunks = NULL;
+    chunksAcross = 0;
+    chunkSize = 0.0f;
+    loadRadius = 0.0f;
+    chunkBytes = 0;
+
+    loadsInFlight = 0;
+
+    budget = 0;
+    uploadBudget = 0;
+    residentBytes = 0;
+    residentCount = 0;
+    frame = 0;
+    streamedLastUpdate.store(false, std::memory_order_relaxed);
+
+    lastPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+    velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+    hasLastPosition = false;
+
+    hits = 0;
+    misses = 0;
+
+    latencyTotal = 0.0;
+    latencyMax = 0.0;
+    latencyCount = 0;
+
+    for (size_t i = 0; i < LATENCY_HISTOGRAM_SIZE; i++)
+        latencyHistogram[i] = 0;
+
+    loadCount = 0;
+    evictionCount = 0;
+    discardCount = 0;
+}
+
+bool WorldStreamer::Initialise(JobSystem *jobSystem, int chunksAcross, GLfloat chunkSize, GLfloat loadRadius, size_t cacheBudget, size_t uploadBudgetPerFrame)
+{
+    if (chunksAcross <= 0 || chunkSize <= 0.0f)
+    {
+        printf("World needs at least one chunk of positive size \n");
+        return false;
+    }
+
+    jobs = jobSystem;
+    this->chunksAcross = chunksAcross;
+    this->chunkSize = chunkSize;
+    this->loadRadius = loadRadius;
+    budget = cacheBudget;
+    uploadBudget = uploadBudgetPerFrame;
+
+    // two triangles per quad, the same for every chunk
+    const int side = CHUNK_RESOLUTION + 1;
+
+    indices.clear();
+    indices.reserve(CHUNK_RESOLUTION * CHUNK_RESOLUTION * 6);
+
+    for (int z = 0; z < CHUNK_RESOLUTION; z++)
+    {
+        for (int x = 0; x < CHUNK_RESOLUTION; x++)
+        {
+            unsigned int corner = z * side + x;
+            unsigned int quad[6] = { corner, corner + side, corner + 1, corner + 1, corner + side, corner + side + 1 };
+
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    chunkBytes = (size_t)side * side * 3 * sizeof(GLfloat) + indices.size() * sizeof(unsigned int);
+
+    // the heightfield stays within this of its base, see height()
+    const GLfloat baseHeight = -3.0f, heightRange = 2.5f;
+    GLfloat halfExtent = chunksAcross * chunkSize * 0.5f;
+
+    chunks = new Chunk[chunksAcross * chunksAcross];
+
+    for (int z = 0; z < chunksAcross; z++)
+    {
+        for (int x = 0; x < chunksAcross; x++)
+        {
+            Chunk &chunk = chunks[z * chunksAcross + x];
+
+            chunk.state.store(CHUNK_UNLOADED, std::memory_order_relaxed);
+            chunk.origin = glm::vec3(x * chunkSize - halfExtent, 0.0f, z * chunkSize - halfExtent);
+            chunk.centre = chunk.origin + glm::vec3(chunkSize * 0.5f, baseHeight, chunkSize * 0.5f);
+            chunk.radius = chunkSize * 0.7072f + heightRange;
+            chunk.priority = 0.0f;
+            chunk.lastUsedFrame = 0;
+            chunk.needed = false;
+            chunk.loadJob.streamer = this;
+            chunk.loadJob.chunk = &chunk;
+        }
+    }
+
+    // every chunk could be ranked at once, so ranking never grows the list mid-run
+    candidates.reserve(chunksAcross * chunksAcross);
+
+    return true;
+}
+
+// rolling hills, a few octaves of sines so neighbouring chunks meet without seams
+GLfloat WorldStreamer::height(GLfloat x, GLfloat z)
+{
+    return -3.0f + 1.5f * sin(x * 0.05f) * cos(z * 0.04f) + 0.6f * sin(x * 0.17f + z * 0.11f) + 0.25f * sin(x * 0.5f) * sin(z * 0.45f);
+}
+
+void WorldStreamer::loadJob(void *data, size_t begin, size_t end)
+{
+    LoadJob *job = (LoadJob*)data;
+
+    job->streamer->generate(*job->chunk);
+}
+
+void WorldStreamer::generate(Chunk &chunk)
+{
+    PROFILE_SCOPE("chunk load");
+
+    const int side = CHUNK_RESOLUTION + 1;
+    GLfloat step = chunkSize / CHUNK_RESOLUTION;
+
+    chunk.vertices.resize(side * side * 3);
+
+    // relative to the chunk's corner, the model matrix puts it in place
+    for (int z = 0; z < side; z++)
+    {
+        for (int x = 0; x < side; x++)
+        {
+            GLfloat *vertex = &chunk.vertices[(z * side + x) * 3];
+
+            vertex[0] = x * step;
+            vertex[1] = height(chunk.origin.x + x * step, chunk.origin.z + z * step);
+            vertex[2] = z * step;
+        }
+    }
+
+    chunk.state.store(CHUNK_LOADED, std::memory_order_release);
+}
+
+void WorldStreamer::update(const glm::mat4 &view)
+{
+    PROFILE_SCOPE("world update");
+
+    if (chunks == NULL)
+        return;
+
+    size_t evictionsBefore = evictionCount, loadsBefore = loadCount, discardsBefore = discardCount;
+
+    // the camera sits at the inverse view's translation, looking down its -Z
+    glm::mat4 cameraWorld = glm::inverse(view);
+    glm::vec3 position(cameraWorld[3]);
+    glm::vec3 front = -glm::vec3(cameraWorld[2]);
+
+    Clock::time_point now = Clock::now();
+
+    if (hasLastPosition)
+    {
+        double seconds = std::chrono::duration<double>(now - lastUpdate).count();
+
+        // smoothed, so one uneven frame doesn't swing the prefetch around
+        if (seconds > 0.0)
+            velocity = glm::mix(velocity, (position - lastPosition) / (GLfloat)seconds, 0.25f);
+    }
+
+    lastPosition = position;
+    lastUpdate = now;
+    hasLastPosition = true;
+
+    glm::vec3 predicted = position + velocity * (PREFETCH_MS / 1000.0f);
+
+    rank(position, front, predicted);
+    startLoads();
+    uploadChunks();
+
+    // the cache as this frame draws it
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        Chunk &chunk = chunks[candidates[i]];
+
+        if (!chunk.needed)
+            continue;
+
+        if (chunk.state.load(std::memory_order_acquire) == CHUNK_RESIDENT)
+            hits++;
+        else
+            misses++;
+    }
+
+    streamedLastUpdate.store(evictionCount != evictionsBefore || loadCount != loadsBefore || discardCount != discardsBefore, std::memory_order_relaxed);
+
+    frame++;
+}
+
+void WorldStreamer::rank(glm::vec3 position, glm::vec3 front, glm::vec3 predicted)
+{
+    candidates.clear();
+    loadsInFlight = 0;
+
+    // chunks nobody ranks any more give their memory back, resident ones wait for eviction
+    for (int i = 0; i < chunksAcross * chunksAcross; i++)
+    {
+        Chunk &chunk = chunks[i];
+        int state = chunk.state.load(std::memory_order_acquire);
+
+        chunk.needed = false;
+
+        if (state == CHUNK_LOADING)
+            loadsInFlight++;
+        else if (state == CHUNK_LOADED && chunk.lastUsedFrame + 1 < frame)
+        {
+            std::vector<GLfloat>().swap(chunk.vertices);
+            chunk.state.store(CHUNK_UNLOADED, std::memory_order_relaxed);
+            discardCount++;
+        }
+    }
+
+    // only the grid cells under the two circles are looked at
+    GLfloat halfExtent = chunksAcross * chunkSize * 0.5f;
+    GLfloat reach = loadRadius + chunkSize;
+
+    int minimumX = (int)floor((std::min(position.x, predicted.x) - reach + halfExtent) / chunkSize);
+    int maximumX = (int)floor((std::max(position.x, predicted.x) + reach + halfExtent) / chunkSize);
+    int minimumZ = (int)floor((std::min(position.z, predicted.z) - reach + halfExtent) / chunkSize);
+    int maximumZ = (int)floor((std::max(position.z, predicted.z) + reach + halfExtent) / chunkSize);
+
+    minimumX = std::max(minimumX, 0);
+    minimumZ = std::max(minimumZ, 0);
+    maximumX = std::min(maximumX, chunksAcross - 1);
+    maximumZ = std::min(maximumZ, chunksAcross - 1);
+
+    glm::vec2 flatFront(front.x, front.z);
+    GLfloat flatLength = glm::length(flatFront);
+    flatFront = flatLength > 0.0f ? flatFront / flatLength : glm::vec2(0.0f, 0.0f);
+
+    for (int z = minimumZ; z <= maximumZ; z++)
+    {
+        for (int x = minimumX; x <= maximumX; x++)
+        {
+            uint32_t index = z * chunksAcross + x;
+            Chunk &chunk = chunks[index];
+
+            glm::vec2 offset(chunk.centre.x - position.x, chunk.centre.z - position.z);
+            glm::vec2 ahead(chunk.centre.x - predicted.x, chunk.centre.z - predicted.z);
+
+            GLfloat distance = glm::length(offset);
+            GLfloat aheadDistance = glm::length(ahead);
+            GLfloat halfDiagonal = chunkSize * 0.7072f;
+
+            bool needed = distance - halfDiagonal <= loadRadius;
+            bool prefetched = aheadDistance - halfDiagonal <= loadRadius;
+
+            if (!needed && !prefetched)
+                continue;
+
+            GLfloat priority = FLT_MAX;
+
+            // what is in front counts as up to twice as close as what is behind
+            if (needed)
+            {
+                GLfloat facing = distance > 0.0f ? glm::dot(offset / distance, flatFront) : 1.0f;
+                priority = distance * (1.5f - 0.5f * facing);
+            }
+
+            // somewhere the camera is heading, slightly behind what it can already see
+            if (prefetched)
+                priority = std::min(priority, aheadDistance * 1.25f + chunkSize);
+
+            chunk.priority = priority;
+            chunk.needed = needed;
+
+            candidates.push_back(index);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) { return chunks[a].priority < chunks[b].priority; });
+
+    // no more than the cache holds, what doesn't fit is neither loaded nor kept from eviction
+    size_t capacity = budget / chunkBytes;
+
+    for (size_t i = capacity; i < candidates.size(); i++)
+    {
+        if (chunks[candidates[i]].needed)
+            misses++;
+
+        chunks[candidates[i]].needed = false;
+    }
+
+    if (candidates.size() > capacity)
+        candidates.resize(capacity);
+
+    for (size_t i = 0; i < candidates.size(); i++)
+        chunks[candidates[i]].lastUsedFrame = frame;
+}
+
+void WorldStreamer::startLoads()
+{
+    // with a single worker nothing else would ever run a job, so one chunk a frame loads inline
+    bool loadInline = jobs == NULL || jobs->getThreadCount() <= 1;
+    int limit = loadInline ? 1 : MAX_LOADS_IN_FLIGHT;
+
+    for (size_t i = 0; i < candidates.size() && loadsInFlight < limit; i++)
+    {
+        Chunk &chunk = chunks[candidates[i]];
+
+        if (chunk.state.load(std::memory_order_acquire) != CHUNK_UNLOADED)
+            continue;
+
+        chunk.state.store(CHUNK_LOADING, std::memory_order_relaxed);
+        chunk.requestTime = Clock::now();
+        loadsInFlight++;
+
+        if (loadInline)
+            generate(chunk);
+        else
+            jobs->run(loadJob, &chunk.loadJob, &pendingLoads);
+    }
+}
+
+void WorldStreamer::uploadChunks()
+{
+    size_t uploaded = 0;
+
+    // best ranked first; one chunk always goes up, even if it alone is over the frame's budget
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        Chunk &chunk = chunks[candidates[i]];
+
+        if (chunk.state.load(std::memory_order_acquire) != CHUNK_LOADED)
+            continue;
+
+        if (uploaded > 0 && uploaded + chunkBytes > uploadBudget)
+            break;
+
+        if (!makeRoom(chunkBytes))
+            break;
+
+        chunk.mesh.CreateMesh(chunk.vertices.data(), indices.data(), chunk.vertices.size(), indices.size());
+        std::vector<GLfloat>().swap(chunk.vertices);
+
+        chunk.state.store(CHUNK_RESIDENT, std::memory_order_relaxed);
+
+        residentBytes += chunkBytes;
+        residentCount++;
+        uploaded += chunkBytes;
+        loadCount++;
+
+        double seconds = std::chrono::duration<double>(Clock::now() - chunk.requestTime).count();
+        size_t bucket = (size_t)(seconds * 1000.0 / LATENCY_BUCKET_MS);
+
+        latencyTotal += seconds;
+        latencyMax = std::max(latencyMax, seconds);
+        latencyCount++;
+        latencyHistogram[std::min(bucket, LATENCY_HISTOGRAM_SIZE - 1)]++;
+    }
+}
+
+bool WorldStreamer::makeRoom(size_t bytes)
+{
+    while (residentBytes + bytes > budget)
+    {
+        // least recently ranked first, nothing ranked this frame is given up for another chunk
+        Chunk *victim = NULL;
+
+        for (int i = 0; i < chunksAcross * chunksAcross; i++)
+        {
+            Chunk &chunk = chunks[i];
+
+            if (chunk.state.load(std::memory_order_relaxed) != CHUNK_RESIDENT || chunk.lastUsedFrame == frame)
+                continue;
+
+            if (victim == NULL || chunk.lastUsedFrame < victim->lastUsedFrame)
+                victim = &chunk;
+        }
+
+        if (victim == NULL)
+            return false;
+
+        evict(*victim);
+    }
+
+    return true;
+}
+
+void WorldStreamer::evict(Chunk &chunk)
+{
+    chunk.mesh.ClearMesh();
+    chunk.state.store(CHUNK_UNLOADED, std::memory_order_relaxed);
+
+    residentBytes -= chunkBytes;
+    residentCount--;
+    evictionCount++;
+}
+
+void WorldStreamer::appendRenderObjects(std::vector<RenderObject> &objects)
+{
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        Chunk &chunk = chunks[candidates[i]];
+
+        if (chunk.state.load(std::memory_order_relaxed) != CHUNK_RESIDENT)
+            continue;
+
+        RenderObject object;
+        object.mesh = &chunk.mesh;
+        object.shader = NULL;
+        object.model = glm::translate(glm::mat4(1.0f), chunk.origin);
+        object.center = chunk.centre;
+        object.radius = chunk.radius;
+
+        objects.push_back(object);
+    }
+}
+
+double WorldStreamer::getLoadLatencyPercentile(double fraction)
+{
+    size_t target = (size_t)ceil(fraction * latencyCount), seen = 0;
+
+    for (size_t i = 0; i < LATENCY_HISTOGRAM_SIZE; i++)
+    {
+        seen += latencyHistogram[i];
+
+        // the upper edge of the bucket, the last one is open ended so the maximum stands in
+        if (seen >= target && seen > 0)
+            return i + 1 < LATENCY_HISTOGRAM_SIZE ? (i + 1) * LATENCY_BUCKET_MS / 1000.0 : latencyMax;
+    }
+
+    return 0.0;
+}
+
+void WorldStreamer::printStatistics()
+{
+    if (chunks == NULL)
+        return;
+
+    printf("world %dx%d chunks | resident %zu (%.1f / %.1f MB) | loads %zu, evictions %zu, discarded %zu | hit rate %.1f%% \n",
+        chunksAcross, chunksAcross, residentCount, residentBytes / 1048576.0, budget / 1048576.0, loadCount, evictionCount,
+        discardCount, 100.0 * getHitRate());
+
+    printf("chunk load latency mean %.2f ms | p95 %.0f ms | max %.2f ms \n", 1000.0 * getMeanLoadLatency(),
+        1000.0 * getLoadLatencyPercentile(0.95), 1000.0 * latencyMax);
+}
+
+void WorldStreamer::Shutdown()
+{
+    if (chunks == NULL)
+        return;
+
+    // load jobs write into the chunks, none may still be running
+    if (jobs != NULL)
+        jobs->wait(&pendingLoads);
+
+    delete[] chunks;
+    chunks = NULL;
+
+    residentBytes = 0;
+    residentCount = 0;
+}
+
+WorldStreamer::~WorldStreamer()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+#include "headers/Camera.h"
+
+// the quaternion orientation against the Euler formula it replaced: the same front, right & up
+// for every yaw & pitch, whether set directly or reached through mouse input, & pitch stays clamped
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const GLfloat epsilon = 1e-4f;
+
+struct EulerBasis
+{
+    glm::vec3 front, right, up;
+};
+
+// Camera::update before the quaternion change
+static EulerBasis eulerBasis(GLfloat yaw, GLfloat pitch)
+{
+    EulerBasis basis;
+
+    basis.front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    basis.front.y = sin(glm::radians(pitch));
+    basis.front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+    basis.front = glm::normalize(basis.front);
+
+    basis.right = glm::normalize(glm::cross(basis.front, glm::vec3(0.0f, 1.0f, 0.0f)));
+    basis.up = glm::normalize(glm::cross(basis.right, basis.front));
+
+    return basis;
+}
+
+static GLfloat difference(const glm::vec3 &a, const glm::vec3 &b)
+{
+    return glm::length(a - b);
+}
+
+static GLfloat worst = 0.0f;
+
+static bool matches(Camera &camera, GLfloat yaw, GLfloat pitch)
+{
+    EulerBasis expected = eulerBasis(yaw, pitch);
+
+    GLfloat error = std::max(difference(camera.getFront(), expected.front),
+        std::max(difference(camera.getRight(), expected.right), difference(camera.getUp(), expected.up)));
+
+    worst = std::max(worst, error);
+
+    if (error > epsilon)
+    {
+        printf("yaw %.2f pitch %.2f: off by %g \n", yaw, pitch, error);
+        return false;
+    }
+
+    return true;
+}
+
+static void testSweep()
+{
+    int cases = 0;
+
+    for (GLfloat yaw = -360.0f; yaw <= 360.0f; yaw += 7.5f)
+    {
+        for (GLfloat pitch = -89.0f; pitch <= 89.0f; pitch += 2.5f)
+        {
+            Camera camera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), yaw, pitch, 5.0f, 1.0f);
+            CHECK(matches(camera, yaw, pitch));
+            cases++;
+        }
+    }
+
+    printf("sweep: %d orientations | worst error %g \n", cases, worst);
+}
+
+static void testMouse()
+{
+    // uneven steps through the same code path the window's input takes
+    Camera camera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, 0.0f, 5.0f, 0.5f);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        camera.mouseControl((i % 13 - 6) * 1.75f, (i % 9 - 4) * 1.25f);
+        camera.calculateViewMatrix();
+
+        CHECK(matches(camera, camera.getYaw(), camera.getPitch()));
+    }
+}
+
+static void testPitchClamp()
+{
+    Camera camera;
+
+    camera.mouseControl(0.0f, 1000.0f);
+    camera.calculateViewMatrix();
+    CHECK(camera.getPitch() == 89.0f);
+    CHECK(camera.getFront().y <= sin(glm::radians(89.0f)) + epsilon);
+    CHECK(camera.getUp().y > 0.0f);
+    CHECK(matches(camera, camera.getYaw(), camera.getPitch()));
+
+    camera.mouseControl(0.0f, -5000.0f);
+    camera.calculateViewMatrix();
+    CHECK(camera.getPitch() == -89.0f);
+    CHECK(camera.getFront().y >= -sin(glm::radians(89.0f)) - epsilon);
+    CHECK(camera.getUp().y > 0.0f);
+    CHECK(matches(camera, camera.getYaw(), camera.getPitch()));
+
+    // smoothing only delays the orientation, the clamp still holds once it settles
+    camera.setSmoothing(20.0f);
+    camera.mouseControl(0.0f, 500.0f);
+
+    for (int frame = 0; frame < 240; frame++)
+        camera.keyControl(camera.getFrameKeys(), 1.0f / 60.0f);
+
+    CHECK(camera.getPitch() == 89.0f);
+    CHECK(matches(camera, camera.getYaw(), camera.getPitch()));
+}
+
+int main()
+{
+    testSweep();
+    testMouse();
+    testPitchClamp();
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "headers/FrameArena.h"
+
+// a request that does not fit must fall back to the heap without using up the region for the
+// requests that still fit, & without pushing the high water mark past the region
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const size_t arenaSize = 4 * FrameArena::BLOCK_SIZE;
+
+static bool inRegion(FrameArena &arena, void *pointer, char *start)
+{
+    return (char*)pointer >= start && (char*)pointer < start + arenaSize;
+}
+
+static void testFailedClaim()
+{
+    FrameArena arena;
+    CHECK(arena.Initialise(arenaSize, 1));
+
+    // a big request takes its bytes straight from the region, the first one marks where it starts
+    char *start = (char*)arena.allocate(FrameArena::BLOCK_SIZE, 64);
+    CHECK(arena.getBytesUsed() == FrameArena::BLOCK_SIZE + 64);
+
+    // far too big, goes to the heap
+    void *huge = arena.allocate(arenaSize * 2);
+    CHECK(huge != NULL);
+    CHECK(!inRegion(arena, huge, start));
+    CHECK(arena.getOverflowCount() == 1);
+    CHECK(arena.getBytesUsed() == FrameArena::BLOCK_SIZE + 64);
+
+    // the rest of the region is still there for requests that fit
+    void *fits = arena.allocate(FrameArena::BLOCK_SIZE, 64);
+    CHECK(inRegion(arena, fits, start));
+    CHECK(arena.getOverflowCount() == 1);
+
+    arena.beginFrame();
+    CHECK(arena.getHighWater() <= arenaSize);
+    CHECK(arena.getBytesUsed() == 0);
+}
+
+static void testThreads()
+{
+    FrameArena arena;
+    CHECK(arena.Initialise(arenaSize, 2));
+
+    // eight threads race for four blocks, every frame
+    for (int frame = 0; frame < 64; frame++)
+    {
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 8; t++)
+        {
+            threads.push_back(std::thread([&]() {
+                for (int i = 0; i < 64; i++)
+                {
+                    int *values = arena.allocateArray<int>(1024);
+                    values[0] = values[1023] = i;
+                }
+            }));
+        }
+
+        for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+
+        CHECK(arena.getBytesUsed() <= arenaSize);
+        arena.beginFrame();
+    }
+
+    CHECK(arena.getHighWater() <= arenaSize);
+    CHECK(arena.getOverflowCount() > 0);
+}
+
+int main()
+{
+    testFailedClaim();
+    testThreads();
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
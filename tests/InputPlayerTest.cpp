@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <vector>
+
+#include "headers/InputPlayer.h"
+#include "headers/InputRecorder.h"
+
+// recordings written by hand: a clean file loads, & a truncated one or one with a key code
+// out of range is refused rather than half-loaded
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const char *fileLocation = "InputPlayerTest.rec";
+
+// two frames, the first with no key events, then whatever extra bytes are given
+static void writeRecording(const std::vector<uint16_t> &secondFrameKeys, size_t truncateBy)
+{
+    std::vector<unsigned char> bytes;
+
+    auto append = [&](const void *data, size_t size) {
+        const unsigned char *first = (const unsigned char*)data;
+        bytes.insert(bytes.end(), first, first + size);
+    };
+
+    append(&RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    append(&RECORDING_VERSION, sizeof(RECORDING_VERSION));
+
+    for (int frame = 0; frame < 2; frame++)
+    {
+        GLfloat record[10] = { frame / 60.0f, 1.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        uint16_t eventCount = frame == 0 ? 0 : (uint16_t)secondFrameKeys.size();
+
+        append(record, sizeof(record));
+        append(&eventCount, sizeof(eventCount));
+
+        if (frame == 1 && eventCount > 0)
+            append(secondFrameKeys.data(), eventCount * sizeof(uint16_t));
+    }
+
+    bytes.resize(bytes.size() - truncateBy);
+
+    FILE *file = fopen(fileLocation, "wb");
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+int main()
+{
+    std::vector<uint16_t> keys = { (uint16_t)(GLFW_KEY_W | RECORDING_KEY_PRESSED), GLFW_KEY_W };
+
+    InputPlayer player;
+
+    writeRecording(keys, 0);
+    CHECK(player.load(fileLocation));
+    CHECK(player.getFrameCount() == 2);
+
+    // cut inside the key events, the event count & the frame record
+    for (size_t truncateBy : { (size_t)1, (size_t)4, (size_t)5, (size_t)6, (size_t)20 })
+    {
+        writeRecording(keys, truncateBy);
+        CHECK(!player.load(fileLocation));
+        CHECK(player.getFrameCount() == 0);
+        CHECK(!player.step(1.0f / 60.0f));
+    }
+
+    writeRecording({ (uint16_t)(1024 | RECORDING_KEY_PRESSED) }, 0);
+    CHECK(!player.load(fileLocation));
+
+    writeRecording({ 0x7FFF }, 0);
+    CHECK(!player.load(fileLocation));
+
+    // no key events at all
+    writeRecording({}, 0);
+    CHECK(player.load(fileLocation));
+    CHECK(player.getFrameCount() == 2);
+
+    remove(fileLocation);
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+
+#include "headers/Camera.h"
+#include "headers/InputQueue.h"
+
+// 1000 Hz of synthetic mouse & key events from a producer thread, consumed at 60 Hz by Camera:
+// every delta & every key change has to arrive, & draining a frame has to stay cheap
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const int eventRate = 1000; // per second
+static const int durationMs = 2000;
+static const int keyCount = 8; // GLFW_KEY_A onwards
+
+static InputEvent makeMotion(double time, GLfloat x, GLfloat y)
+{
+    InputEvent event = { time, x, y, 0, INPUT_MOTION, 0 };
+    return event;
+}
+
+static InputEvent makeKey(double time, int code, int action)
+{
+    InputEvent event = { time, 0.0f, 0.0f, (int16_t)code, INPUT_KEY, (uint8_t)action };
+    return event;
+}
+
+// the producer's delta for tick i, quarters so the sums are exact
+static GLfloat deltaX(int i) { return (i % 7 - 3) * 0.25f; }
+static GLfloat deltaY(int i) { return (i % 5 - 2) * 0.25f; }
+
+static void testRealTime()
+{
+    InputQueue queue;
+    Camera camera;
+
+    bool injectedKeys[keyCount] = {};
+    GLfloat injectedX = 0.0f, injectedY = 0.0f;
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < eventRate * durationMs / 1000; i++)
+        {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(i * 1000000 / eventRate));
+
+            double time = i / (double)eventRate;
+
+            queue.push(makeMotion(time, deltaX(i), deltaY(i)));
+            injectedX += deltaX(i);
+            injectedY += deltaY(i);
+
+            // taps of a few milliseconds, well under a frame
+            if (i % 37 == 0 || i % 37 == 3)
+            {
+                int key = i / 37 % keyCount;
+                bool down = i % 37 == 0;
+
+                if (queue.push(makeKey(time, GLFW_KEY_A + key, down ? GLFW_PRESS : GLFW_RELEASE)))
+                    injectedKeys[key] = down;
+            }
+
+            // a key left down for good every so often
+            if (i % 250 == 125)
+            {
+                int key = i / 250 % keyCount;
+
+                if (queue.push(makeKey(time, GLFW_KEY_A + key, injectedKeys[key] ? GLFW_RELEASE : GLFW_PRESS)))
+                    injectedKeys[key] = !injectedKeys[key];
+            }
+        }
+
+        while (!queue.flush())
+            std::this_thread::yield();
+
+        done.store(true, std::memory_order_release);
+    });
+
+    GLfloat consumedX = 0.0f, consumedY = 0.0f;
+    double slowestFrame = 0.0;
+    size_t frames = 0;
+
+    // one more frame after the producer finishes picks up whatever it pushed last
+    for (bool last = false; !last; frames++)
+    {
+        last = done.load(std::memory_order_acquire);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        camera.eventControl(queue, 1.0f / 60.0f);
+        slowestFrame = std::max(slowestFrame, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        consumedX += camera.getFrameXChange();
+        consumedY += camera.getFrameYChange();
+
+        if (!last)
+            std::this_thread::sleep_for(std::chrono::microseconds(16667));
+    }
+
+    producer.join();
+
+    // an empty frame, so taps from the last busy one are not counted as held
+    camera.eventControl(queue, 1.0f / 60.0f);
+
+    CHECK(queue.getDropped() == 0);
+    CHECK(consumedX == injectedX);
+    CHECK(consumedY == injectedY);
+
+    for (int key = 0; key < keyCount; key++)
+        CHECK(camera.getFrameKeys()[GLFW_KEY_A + key] == injectedKeys[key]);
+
+    // a frame drains about 17 events, a millisecond is a generous bound on any machine
+    CHECK(slowestFrame < 0.001);
+
+    printf("real time: %zu frames | slowest drain %.1f us | delta %.2f, %.2f \n", frames, slowestFrame * 1e6, consumedX, consumedY);
+}
+
+// a consumer that stalls for seconds: keys are dropped, motion is merged & none of it is lost
+static void testOverflow()
+{
+    InputQueue queue;
+    Camera camera;
+
+    const int events = (int)InputQueue::CAPACITY * 3;
+    GLfloat injectedX = 0.0f, injectedY = 0.0f;
+
+    for (int i = 0; i < events; i++)
+    {
+        CHECK(queue.push(makeMotion(i / (double)eventRate, deltaX(i), deltaY(i))));
+        injectedX += deltaX(i);
+        injectedY += deltaY(i);
+    }
+
+    CHECK(!queue.flush());
+    CHECK(!queue.push(makeKey(0.0, GLFW_KEY_W, GLFW_PRESS)));
+    CHECK(queue.getDropped() == 1);
+
+    GLfloat consumedX = 0.0f, consumedY = 0.0f;
+
+    for (int frame = 0; frame < 3; frame++)
+    {
+        camera.eventControl(queue, 1.0f / 60.0f);
+        consumedX += camera.getFrameXChange();
+        consumedY += camera.getFrameYChange();
+
+        queue.flush();
+    }
+
+    CHECK(queue.flush());
+    CHECK(consumedX == injectedX);
+    CHECK(consumedY == injectedY);
+    CHECK(!camera.getFrameKeys()[GLFW_KEY_W]);
+
+    printf("overflow: %d events | dropped %zu keys | delta %.2f, %.2f \n", events, queue.getDropped(), consumedX, consumedY);
+}
+
+int main()
+{
+    testRealTime();
+    testOverflow();
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
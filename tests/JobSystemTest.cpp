@@ -0,0 +1,183 @@
+#include <atomic>
+#include <stdio.h>
+#include <vector>
+
+#include "headers/JobSystem.h"
+
+// more jobs in flight than a pool holds, from outside the workers & from inside a job: every
+// job has to run exactly once, none may be overwritten by a later one reusing its slot
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const size_t jobCount = JobSystem::JOB_POOL_SIZE * 3;
+
+static std::atomic<int> runs[jobCount];
+static std::atomic<bool> release;
+
+static void countRun(void *data, size_t begin, size_t end)
+{
+    // hold every job until all of them are submitted, so the pools wrap while they are in flight
+    while (!release.load(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    runs[(size_t)data].fetch_add(1, std::memory_order_relaxed);
+}
+
+static void resetRuns()
+{
+    release.store(false);
+
+    for (size_t i = 0; i < jobCount; i++)
+        runs[i].store(0);
+}
+
+static size_t countExactlyOnce()
+{
+    size_t once = 0;
+
+    for (size_t i = 0; i < jobCount; i++)
+        once += runs[i].load() == 1;
+
+    return once;
+}
+
+static void testExternal(JobSystem &jobs)
+{
+    resetRuns();
+
+    JobCounter counter;
+
+    // submitted from a thread that is not a worker, so every job comes from the external pool
+    std::thread producer([&]() {
+        for (size_t i = 0; i < jobCount; i++)
+        {
+            if (i == JobSystem::JOB_POOL_SIZE)
+                release.store(true, std::memory_order_release);
+
+            jobs.run(countRun, (void*)i, &counter);
+        }
+    });
+
+    producer.join();
+    jobs.wait(&counter);
+
+    CHECK(countExactlyOnce() == jobCount);
+}
+
+struct SpawnData
+{
+    JobSystem *jobs;
+    JobCounter *counter;
+};
+
+static void spawnMany(void *data, size_t begin, size_t end)
+{
+    SpawnData *spawn = (SpawnData*)data;
+
+    for (size_t i = 0; i < jobCount; i++)
+    {
+        if (i == JobSystem::JOB_POOL_SIZE)
+            release.store(true, std::memory_order_release);
+
+        spawn->jobs->run(countRun, (void*)i, spawn->counter);
+    }
+}
+
+static void testWorker(JobSystem &jobs)
+{
+    resetRuns();
+
+    // a job spawning jobs allocates from its worker's pool
+    JobCounter counter;
+    SpawnData spawn = { &jobs, &counter };
+
+    jobs.run(spawnMany, &spawn, &counter);
+    jobs.wait(&counter);
+
+    CHECK(countExactlyOnce() == jobCount);
+}
+
+static void testParallelFor(JobSystem &jobs)
+{
+    std::vector<int> visits(1 << 20, 0);
+
+    for (int pass = 0; pass < 8; pass++)
+    {
+        jobs.parallelFor(visits.size(), 16, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++)
+                visits[v]++;
+        });
+    }
+
+    size_t correct = 0;
+
+    for (size_t v = 0; v < visits.size(); v++)
+        correct += visits[v] == 8;
+
+    CHECK(correct == visits.size());
+}
+
+static std::atomic<int> order;
+
+static void recordOrder(void *data, size_t begin, size_t end)
+{
+    ((std::atomic<int>*)data)->store(order.fetch_add(1) + 1);
+}
+
+// the dependent job sits above its dependency in the same deque: popping it first must not
+// keep the dependency from running, even on a single thread
+static void testDependency(JobSystem &jobs, bool external)
+{
+    std::atomic<int> first(0), second(0);
+    JobCounter firstCounter, secondCounter;
+
+    order.store(0);
+
+    auto submit = [&]() {
+        jobs.run(recordOrder, &first, &firstCounter);
+        jobs.run(recordOrder, &second, &secondCounter, &firstCounter);
+    };
+
+    if (external)
+    {
+        std::thread producer(submit);
+        producer.join();
+    }
+    else
+    {
+        submit();
+    }
+
+    jobs.wait(&secondCounter);
+
+    CHECK(first.load() == 1);
+    CHECK(second.load() == 2);
+    CHECK(firstCounter.value.load() == 0);
+}
+
+int main()
+{
+    for (unsigned int threads = 1; threads <= 4; threads *= 2)
+    {
+        JobSystem jobs;
+        jobs.Initialise(threads, false);
+
+        testExternal(jobs);
+        testWorker(jobs);
+        testParallelFor(jobs);
+        testDependency(jobs, false);
+        testDependency(jobs, true);
+
+        jobs.Shutdown();
+    }
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "headers/MultiViewRenderer.h"
+
+// the view table refuses a view past MAX_VIEWS instead of handing out an existing index,
+// & culling still sees every view that was added
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+int main()
+{
+    MultiViewRenderer renderer;
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+
+    for (size_t v = 0; v < MultiViewRenderer::MAX_VIEWS; v++)
+    {
+        int view = renderer.addView(0, 0, 64, 64);
+        CHECK(view == (int)v);
+
+        // even views look down -z, odd ones down +z
+        glm::vec3 forward(0.0f, 0.0f, v % 2 == 0 ? -1.0f : 1.0f);
+        renderer.setViewMatrices(view, glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0.0f, 1.0f, 0.0f)), projection);
+    }
+
+    CHECK(renderer.addView(0, 0, 64, 64) == -1);
+    CHECK(renderer.getViewCount() == MultiViewRenderer::MAX_VIEWS);
+
+    // one object in front of the even views
+    RenderObject object = { NULL, NULL, glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f), 1.0f };
+    std::vector<RenderObject> objects(1, object);
+
+    renderer.cull(objects);
+
+    for (size_t v = 0; v < MultiViewRenderer::MAX_VIEWS; v++)
+        CHECK(renderer.getVisibleCount(v) == (v % 2 == 0 ? 1u : 0u));
+
+    renderer.clearViews();
+    CHECK(renderer.addView(0, 0, 64, 64) == 0);
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
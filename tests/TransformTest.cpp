@@ -0,0 +1,199 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "headers/TransformHierarchy.h"
+#include "headers/TransformKernels.h"
+
+// every compose kernel the CPU runs against the scalar one, with & without a view projection,
+// a hierarchy refusing a node whose parent does not exist yet, & the level by level update on
+// the job system against the serial one
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: %s failed \n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static const size_t transformCount = 1037; // not a multiple of any vector width, so every tail runs
+
+static float randomFloat(float low, float high)
+{
+    return low + (high - low) * rand() / RAND_MAX;
+}
+
+static float largestDifference(const std::vector<float> &a, const std::vector<float> &b)
+{
+    float largest = 0.0f;
+
+    for (size_t i = 0; i < a.size(); i++)
+        largest = fmax(largest, fabs(a[i] - b[i]) / fmax(1.0f, fabs(b[i])));
+
+    return largest;
+}
+
+static void testKernels()
+{
+    srand(1);
+
+    std::vector<float> streams[10];
+
+    for (int s = 0; s < 10; s++)
+        streams[s].resize(transformCount);
+
+    for (size_t i = 0; i < transformCount; i++)
+    {
+        glm::quat rotation = glm::normalize(glm::quat(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f)));
+
+        streams[0][i] = randomFloat(-50.0f, 50.0f);
+        streams[1][i] = randomFloat(-50.0f, 50.0f);
+        streams[2][i] = randomFloat(-50.0f, 50.0f);
+        streams[3][i] = rotation.x;
+        streams[4][i] = rotation.y;
+        streams[5][i] = rotation.z;
+        streams[6][i] = rotation.w;
+        streams[7][i] = randomFloat(0.1f, 4.0f);
+        streams[8][i] = randomFloat(0.1f, 4.0f);
+        streams[9][i] = randomFloat(0.1f, 4.0f);
+    }
+
+    TransformStreams input = {
+        streams[0].data(), streams[1].data(), streams[2].data(),
+        streams[3].data(), streams[4].data(), streams[5].data(), streams[6].data(),
+        streams[7].data(), streams[8].data(), streams[9].data()
+    };
+
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+        glm::lookAt(glm::vec3(0.0f, 3.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    std::vector<float> expected(transformCount * 16), expectedMvp(transformCount * 16), result(transformCount * 16);
+
+    CHECK(SetTransformKernel("scalar"));
+    ComposeTransforms(input, transformCount, expected.data(), NULL);
+    ComposeTransforms(input, transformCount, expectedMvp.data(), &viewProjection);
+
+    CHECK(!SetTransformKernel("neon"));
+
+    const char *kernels[3] = { "sse", "avx2", "avx512" };
+
+    for (int k = 0; k < 3; k++)
+    {
+        if (!SetTransformKernel(kernels[k]))
+        {
+            printf("%s: not supported here \n", kernels[k]);
+            continue;
+        }
+
+        ComposeTransforms(input, transformCount, result.data(), NULL);
+        float model = largestDifference(result, expected);
+
+        ComposeTransforms(input, transformCount, result.data(), &viewProjection);
+        float mvp = largestDifference(result, expectedMvp);
+
+        // fused multiply-adds round once where the scalar kernel rounds twice
+        CHECK(model < 1e-5f);
+        CHECK(mvp < 1e-5f);
+
+        printf("%s: largest relative difference %g, %g with MVP \n", kernels[k], model, mvp);
+    }
+
+    CHECK(SetTransformKernel(NULL));
+}
+
+static void testParents()
+{
+    TransformHierarchy transforms;
+
+    uint32_t root = transforms.addNode(TransformHierarchy::NO_PARENT, glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+    uint32_t child = transforms.addNode(root, glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+
+    CHECK(root == 0 && child == 1);
+    CHECK(transforms.getParent(child) == root);
+
+    // a node cannot be its own parent, nor the child of one added later
+    CHECK(transforms.addNode(2, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f)) == TransformHierarchy::INVALID_NODE);
+    CHECK(transforms.addNode(7, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f)) == TransformHierarchy::INVALID_NODE);
+    CHECK(transforms.getNodeCount() == 2);
+
+    transforms.update();
+    CHECK(transforms.getWorldMatrix(child)[3][0] == 2.0f);
+}
+
+static void buildRandomHierarchy(TransformHierarchy &transforms, size_t nodeCount)
+{
+    srand(7);
+
+    // parents anywhere earlier in the array, so levels are wide & interleaved in memory
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        uint32_t parent = i < 8 ? TransformHierarchy::NO_PARENT : (uint32_t)(rand() % i);
+        glm::quat rotation = glm::angleAxis(randomFloat(-3.0f, 3.0f), glm::normalize(glm::vec3(randomFloat(-1.0f, 1.0f), 1.0f, randomFloat(-1.0f, 1.0f))));
+
+        transforms.addNode(parent, glm::vec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f)), rotation, glm::vec3(randomFloat(0.9f, 1.1f)));
+    }
+}
+
+static float largestWorldDifference(TransformHierarchy &a, TransformHierarchy &b)
+{
+    float largest = 0.0f;
+
+    for (size_t i = 0; i < a.getNodeCount(); i++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            for (int r = 0; r < 4; r++)
+            {
+                float x = a.getWorldMatrix(i)[c][r], y = b.getWorldMatrix(i)[c][r];
+                largest = fmax(largest, fabs(x - y) / fmax(1.0f, fabs(y)));
+            }
+        }
+    }
+
+    return largest;
+}
+
+static void testParallelUpdate()
+{
+    const size_t nodeCount = 50000;
+
+    JobSystem jobs;
+    jobs.Initialise(4, false);
+
+    TransformHierarchy serial, parallel;
+    parallel.setJobSystem(&jobs);
+
+    buildRandomHierarchy(serial, nodeCount);
+    buildRandomHierarchy(parallel, nodeCount);
+
+    CHECK(serial.update() == nodeCount);
+    CHECK(parallel.update() == nodeCount);
+    CHECK(largestWorldDifference(parallel, serial) < 1e-4f);
+
+    // a few scattered nodes, below the batched compose ratio
+    for (size_t i = 0; i < nodeCount; i += 97)
+    {
+        serial.setTranslation(i, glm::vec3(0.5f, 0.0f, 0.0f));
+        parallel.setTranslation(i, glm::vec3(0.5f, 0.0f, 0.0f));
+    }
+
+    CHECK(parallel.update() == serial.update());
+    CHECK(largestWorldDifference(parallel, serial) < 1e-4f);
+
+    jobs.Shutdown();
+}
+
+int main()
+{
+    testKernels();
+    testParents();
+    testParallelUpdate();
+
+    if (failures > 0)
+    {
+        printf("%d checks failed \n", failures);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file